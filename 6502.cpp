@@ -12,6 +12,300 @@
 #include "6502.h"
 #include "cpu_6502.h"
 #include "mem_6502.h"
+#include "debug_6502.h"
+#include "gdb_6502.h"
+#include "diff_6502.h"
+#include "sched_6502.h"
+#include "via_6522.h"
+#include "acia_6551.h"
+#include "fb_6502.h"
+#include "pace_6502.h"
+#include "dis_6502.h"
+#include "aot_6502.h"
+#include "metrics_6502.h"
+#include "perf_6502.h"
+#include <csignal>
+#include <memory>
+
+// cycles the CPU runs between checks for a debugger interrupt
+static constexpr int32_t GDB_SLICE = 10000;
+
+// cycles both sides of a differential run execute between comparisons
+static constexpr int32_t DIFF_BLOCK = 100000;
+
+// cycles per execute() call of an unpaced run
+static constexpr int32_t RUN_SLICE = 100000;
+
+// set by SIGINT to end a run
+static volatile sig_atomic_t interrupted = 0;
+
+// cycles between captured frames, 60 Hz at 1 MHz
+static constexpr uint64_t FRAME_CYCLES = 1000000 / 60;
+
+/******************************************************************************
+ *  struct capture_6502
+ *
+ *  @desc:      Frame capture state: frames go to a raw RGBA stream, or to
+ *              one PPM file each when the path holds a printf style %d
+ *****************************************************************************/
+struct capture_6502 {
+    fb_6502* fb;
+    sched_6502* events;
+    const char* path;
+    FILE* raw;
+    uint32_t frame;
+};
+
+/******************************************************************************
+ *  framepattern()
+ *
+ *  @desc:      Checks that a frame path is safe to use as a printf format:
+ *              exactly one %d, with an optional width, and %% otherwise
+ *  @param:     path - --frames argument holding a %
+ *  @return:    true if the path numbers frames with a single %d
+ *****************************************************************************/
+static bool framepattern(const char* path){
+    uint32_t numbers = 0;
+    for(const char* c = path; *c != '\0'; c++){
+        if(*c != '%'){
+            continue;
+        }
+        if(*++c == '%'){
+            continue;
+        }
+        while(*c >= '0' && *c <= '9'){
+            c++;
+        }
+        if(*c != 'd'){
+            return false;
+        }
+        numbers++;
+    }
+    return numbers == 1;
+}
+
+/******************************************************************************
+ *  captureframe()
+ *
+ *  @desc:      Renders the framebuffer and writes the frame if it changed
+ *  @param:     ctx - capture_6502
+ *  @return:    None
+ *****************************************************************************/
+static void captureframe(void* ctx, uint64_t when, uint64_t now){
+    capture_6502* cap = static_cast<capture_6502*>(ctx);
+    (void)now;
+    if(cap->events != nullptr){
+        cap->events->schedule(when + FRAME_CYCLES, captureframe, cap);
+    }
+    if(!cap->fb->render() && cap->frame > 0){
+        return;     // nothing new to show
+    }
+    if(cap->raw != nullptr){
+        cap->fb->writeraw(cap->raw);
+    } else {
+        char name[4096];
+        snprintf(name, sizeof(name), cap->path, cap->frame);
+        cap->fb->writeppm(name);
+    }
+    cap->frame++;
+}
+
+/******************************************************************************
+ *  onsigint()
+ *
+ *  @desc:      Ends the current run at the next slice boundary
+ *****************************************************************************/
+static void onsigint(int sig){
+    (void)sig;
+    interrupted = 1;
+}
+
+/******************************************************************************
+ *  run()
+ *
+ *  @desc:      Runs the CPU in slices until cycles have passed or SIGINT,
+ *              holding each slice back to real time if paced
+ *  @param:     cpu, mem - Machine to run
+ *              cycles - Cycles to run, 0 to run until interrupted
+ *              slice - Cycles per execute() call
+ *              pace - Pacer, or nullptr to run as fast as possible
+ *              metrics - Counters to publish after each slice, or nullptr
+ *  @return:    None
+ *****************************************************************************/
+static void run(cpu_6502& cpu, mem_6502& mem, uint64_t cycles, int32_t slice, pace_6502* pace,
+                metrics_6502* metrics){
+    uint64_t end = cycles > 0 ? cpu.getclock() + cycles : UINT64_MAX;
+    signal(SIGINT, onsigint);
+    if(pace != nullptr){
+        pace->start(cpu.getclock());
+    }
+    while(!interrupted && cpu.getclock() < end){
+        uint64_t left = end - cpu.getclock();
+        cpu.execute(left < (uint64_t)slice ? (int32_t)left : slice, mem);
+        if(metrics != nullptr){
+            metrics->publish(cpu, mem);
+        }
+        if(cpu.getstop() == cpu_6502::STOP_JAM){
+            fprintf(stderr, "jam: CPU locked up at $%04X, cycle %llu\n",
+                    cpu.getregs().PC, (unsigned long long)cpu.getclock());
+            break;
+        }
+        if(pace != nullptr){
+            pace->wait(cpu.getclock());
+        }
+    }
+    signal(SIGINT, SIG_DFL);
+    if(cpu.getskipped() > 0){
+        fprintf(stderr, "turbo: %llu of %llu cycles fast-forwarded\n",
+                (unsigned long long)cpu.getskipped(), (unsigned long long)cpu.getclock());
+    }
+}
+
+/******************************************************************************
+ *  profile()
+ *
+ *  @desc:      Runs the CPU one instruction at a time until cycles have
+ *              passed or SIGINT, reading the host counters around each
+ *              instruction, and reports them per opcode group
+ *  @param:     cpu, mem - Machine to run
+ *              cycles - Cycles to run, 0 to run until interrupted
+ *  @return:    false if no counter can be opened
+ *****************************************************************************/
+static bool profile(cpu_6502& cpu, mem_6502& mem, uint64_t cycles){
+    perf_6502 perf;
+    if(!perf.open()){
+        return false;
+    }
+    uint64_t end = cycles > 0 ? cpu.getclock() + cycles : UINT64_MAX;
+    signal(SIGINT, onsigint);
+    while(!interrupted && cpu.getclock() < end){
+        perf.step(cpu, mem);
+        if(cpu.getstop() == cpu_6502::STOP_JAM){
+            break;
+        }
+    }
+    signal(SIGINT, SIG_DFL);
+    perf.report(stderr);
+    return true;
+}
+
+#ifdef SHADOW_STACK_6502
+// stack faults printed as they happen, the rest are only counted
+static constexpr uint32_t FAULTS_SHOWN = 10;
+
+/******************************************************************************
+ *  onstackfault()
+ *
+ *  @desc:      Prints the first stack faults of the run
+ *  @param:     ctx - Count of faults so far
+ *              kind - shadow_6502::FAULT_* kind
+ *              pc - Instruction that pushed or pulled
+ *              sp - SP before the access
+ *  @return:    None
+ *****************************************************************************/
+static void onstackfault(void* ctx, byte kind, word pc, byte sp){
+    uint32_t& faults = *(uint32_t*)ctx;
+    if(faults++ < FAULTS_SHOWN){
+        fprintf(stderr, "stack: %s at $%04X, SP $%02X\n",
+                kind == shadow_6502::FAULT_OVERFLOW ? "overflow" : "underflow", pc, sp);
+    }
+}
+#endif
+
+/******************************************************************************
+ *  writeanalysis()
+ *
+ *  @desc:      Writes one output of the disassembler to a file
+ *  @param:     path - Output path, - for stdout, nullptr to skip
+ *              dis - Explored disassembler
+ *              write - Output function
+ *  @return:    false if the file cannot be written
+ *****************************************************************************/
+static bool writeanalysis(const char* path, const dis_6502& dis,
+                          void (dis_6502::*write)(FILE*) const){
+    if(path == nullptr){
+        return true;
+    }
+    FILE* file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if(file == nullptr){
+        fprintf(stderr, "ERROR: Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    (dis.*write)(file);
+    if(file != stdout){
+        fclose(file);
+    }
+    return true;
+}
+
+/******************************************************************************
+ *  usage()
+ *
+ *  @desc:      Prints command line help
+ *  @param:     prog - Program name
+ *  @return:    None
+ *****************************************************************************/
+static void usage(const char* prog){
+    fprintf(stderr,
+            "usage: %s [options] [image [addr]]\n"
+            "  image            binary loaded at addr (hex, default 0000)\n"
+            "  --gdb SPEC       serve the GDB remote protocol on SPEC,\n"
+            "                   PORT, tcp:PORT or unix:PATH\n"
+            "  --gdb-wait       with --gdb, stay halted until a debugger\n"
+            "                   continues the CPU\n"
+            "  --start ADDR     start executing at ADDR (hex) instead of FFFC\n"
+            "  --diff CYCLES    run two CPUs in lockstep for CYCLES and report\n"
+            "                   the first instruction where they diverge\n"
+            "  --diff-block N   cycles between lockstep comparisons\n"
+            "  --diff-against CONFIG\n"
+            "                   how the second CPU differs from the first:\n"
+            "                   nofusion or fusion, by default the opposite\n"
+            "                   of --no-fusion\n"
+            "  --via ADDR       map a 6522 VIA at ADDR (hex) on the IRQ line\n"
+            "  --acia ADDR      map a 6551 ACIA at ADDR (hex) on the IRQ line\n"
+            "  --serial SPEC    connect the ACIA to SPEC: stdio (default),\n"
+            "                   fd:IN,OUT, PORT, tcp:PORT or unix:PATH\n"
+            "  --fb ADDR        display a framebuffer at ADDR (hex)\n"
+            "  --fb-mode MODE   1bpp (default), 4bpp or text\n"
+            "  --fb-size WxH    framebuffer size in pixels, default 320x200\n"
+            "  --fb-font ADDR   text mode font, 8 bytes per glyph (hex)\n"
+            "  --frames PATH    write changed frames to PATH, a raw RGBA\n"
+            "                   stream, or PPM files if PATH holds %%d\n"
+            "  --cycles N       run N cycles, 0 until interrupted\n"
+            "  --realtime MHZ   pace the CPU to MHZ of wall clock time (1,\n"
+            "                   1.79, 2, ...), until interrupted unless\n"
+            "                   --cycles is given, and report jitter\n"
+            "  --slice N        cycles run between real time checks,\n"
+            "                   default 1 ms worth\n"
+            "  --turbo          fast-forward idle loops to the next device\n"
+            "                   event\n"
+            "  --perf           step the run one instruction at a time and\n"
+            "                   report host cycles, instructions, branch and\n"
+            "                   L1i misses per opcode group\n"
+            "  --metrics SPEC   serve Prometheus metrics over HTTP on SPEC,\n"
+            "                   a port, tcp:PORT or unix:PATH\n"
+            "  --metrics-file PATH\n"
+            "                   rewrite PATH with the metrics every second\n"
+            "                   and once more on exit\n"
+            "  --no-fusion      dispatch every instruction on its own, for\n"
+            "                   comparing against superinstructions\n"
+            "  --jam POLICY     on a JAM opcode: emulate (default) locks the\n"
+            "                   CPU up like the chip, trap stops on the\n"
+            "                   opcode, halt stops after it\n"
+            "  --disasm PATH    write a listing of the code reachable from\n"
+            "                   the vectors and --start to PATH (- for\n"
+            "                   stdout) instead of running\n"
+            "  --cfg PATH       write its control flow graph as Graphviz DOT\n"
+            "  --calls          report subroutines by cycles and stack faults\n"
+            "                   at exit (SHADOW_STACK_6502 builds)\n"
+            "  --callgraph PATH write the call graph seen as Graphviz DOT\n"
+            "                   at exit (SHADOW_STACK_6502 builds)\n"
+            "  --aot PATH       write the same code translated to C++, to be\n"
+            "                   compiled in and run through aot_6502\n"
+            "  --aot-name NAME  name of the aotimage_6502 it defines\n"
+            "                   (default aot_image)\n",
+            prog);
+}
 
 /******************************************************************************
  *  main()
@@ -19,23 +313,323 @@
  *  @author:    Rian Borah
  *  @desc:      Main for 6502 project
  *  @date:      22 Aug, 2023
- *  @param:     None
+ *  @param:     argc, argv - Command line, see usage()
  *  @return:    EXIT_SUCCESS or EXIT_FAILURE, based on runtime
  *****************************************************************************/
-int main() {
+int main(int argc, char** argv) {
+    const char* image = nullptr;
+    word loadaddr = 0x0000;
+    const char* gdbspec = nullptr;
+    bool gdbwait = false;
+    int32_t start = -1;
+    uint64_t diffcycles = 0;
+    int32_t diffblock = DIFF_BLOCK;
+    int32_t difffusion = -1;
+    int32_t viaaddr = -1;
+    int32_t aciaaddr = -1;
+    const char* serial = "stdio";
+    int32_t fbaddr = -1;
+    byte fbmode = fb_6502::MODE_1BPP;
+    uint32_t fbwidth = 320, fbheight = 200;
+    word fbfont = 0;
+    const char* frames = nullptr;
+    uint64_t runcycles = 0;
+    bool runset = false;
+    double realtime = 0.0;
+    int32_t slice = 0;
+    bool turbo = false;
+    bool perf = false;
+    const char* metricsspec = nullptr;
+    const char* metricsfile = nullptr;
+    bool fusion = true;
+    byte jam = cpu_6502::JAM_EMULATE;
+    const char* disasm = nullptr;
+    const char* cfg = nullptr;
+    bool calls = false;
+    const char* callgraph = nullptr;
+    const char* aot = nullptr;
+    const char* aotname = "aot_image";
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--gdb") == 0 && i + 1 < argc){
+            gdbspec = argv[++i];
+        } else if(strcmp(argv[i], "--gdb-wait") == 0){
+            gdbwait = true;
+        } else if(strcmp(argv[i], "--start") == 0 && i + 1 < argc){
+            start = (int32_t)(strtoul(argv[++i], nullptr, 16) & 0xFFFF);
+        } else if(strcmp(argv[i], "--diff") == 0 && i + 1 < argc){
+            diffcycles = strtoull(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--diff-block") == 0 && i + 1 < argc){
+            diffblock = atoi(argv[++i]);
+            if(diffblock < 1){
+                diffblock = 1;
+            }
+        } else if(strcmp(argv[i], "--diff-against") == 0 && i + 1 < argc){
+            i++;
+            if(strcmp(argv[i], "fusion") == 0){
+                difffusion = 1;
+            } else if(strcmp(argv[i], "nofusion") == 0){
+                difffusion = 0;
+            } else {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if(strcmp(argv[i], "--via") == 0 && i + 1 < argc){
+            viaaddr = (int32_t)(strtoul(argv[++i], nullptr, 16) & 0xFFFF);
+        } else if(strcmp(argv[i], "--acia") == 0 && i + 1 < argc){
+            aciaaddr = (int32_t)(strtoul(argv[++i], nullptr, 16) & 0xFFFF);
+        } else if(strcmp(argv[i], "--serial") == 0 && i + 1 < argc){
+            serial = argv[++i];
+        } else if(strcmp(argv[i], "--fb") == 0 && i + 1 < argc){
+            fbaddr = (int32_t)(strtoul(argv[++i], nullptr, 16) & 0xFFFF);
+        } else if(strcmp(argv[i], "--fb-mode") == 0 && i + 1 < argc){
+            i++;
+            fbmode = strcmp(argv[i], "4bpp") == 0 ? fb_6502::MODE_4BPP
+                   : strcmp(argv[i], "text") == 0 ? fb_6502::MODE_TEXT : fb_6502::MODE_1BPP;
+        } else if(strcmp(argv[i], "--fb-size") == 0 && i + 1 < argc){
+            if(sscanf(argv[++i], "%ux%u", &fbwidth, &fbheight) != 2){
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if(strcmp(argv[i], "--fb-font") == 0 && i + 1 < argc){
+            fbfont = (word)strtoul(argv[++i], nullptr, 16);
+        } else if(strcmp(argv[i], "--frames") == 0 && i + 1 < argc){
+            frames = argv[++i];
+        } else if(strcmp(argv[i], "--cycles") == 0 && i + 1 < argc){
+            runcycles = strtoull(argv[++i], nullptr, 10);
+            runset = true;
+        } else if(strcmp(argv[i], "--realtime") == 0 && i + 1 < argc){
+            realtime = atof(argv[++i]);
+            if(realtime <= 0.0){
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if(strcmp(argv[i], "--slice") == 0 && i + 1 < argc){
+            slice = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--turbo") == 0){
+            turbo = true;
+        } else if(strcmp(argv[i], "--perf") == 0){
+            perf = true;
+        } else if(strcmp(argv[i], "--metrics") == 0 && i + 1 < argc){
+            metricsspec = argv[++i];
+        } else if(strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc){
+            metricsfile = argv[++i];
+        } else if(strcmp(argv[i], "--no-fusion") == 0){
+            fusion = false;
+        } else if(strcmp(argv[i], "--jam") == 0 && i + 1 < argc){
+            i++;
+            if(strcmp(argv[i], "emulate") == 0){
+                jam = cpu_6502::JAM_EMULATE;
+            } else if(strcmp(argv[i], "trap") == 0){
+                jam = cpu_6502::JAM_TRAP;
+            } else if(strcmp(argv[i], "halt") == 0){
+                jam = cpu_6502::JAM_HALT;
+            } else {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if(strcmp(argv[i], "--disasm") == 0 && i + 1 < argc){
+            disasm = argv[++i];
+        } else if(strcmp(argv[i], "--cfg") == 0 && i + 1 < argc){
+            cfg = argv[++i];
+        } else if(strcmp(argv[i], "--calls") == 0){
+            calls = true;
+        } else if(strcmp(argv[i], "--callgraph") == 0 && i + 1 < argc){
+            callgraph = argv[++i];
+        } else if(strcmp(argv[i], "--aot") == 0 && i + 1 < argc){
+            aot = argv[++i];
+        } else if(strcmp(argv[i], "--aot-name") == 0 && i + 1 < argc){
+            aotname = argv[++i];
+        } else if(argv[i][0] == '-'){
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        } else if(image == nullptr){
+            image = argv[i];
+        } else {
+            loadaddr = (word)strtoul(argv[i], nullptr, 16);
+        }
+    }
+
+    if((viaaddr >= 0 || aciaaddr >= 0 || fbaddr >= 0) && diffcycles > 0){
+        // devices live on the first side only and would break the lockstep
+        fprintf(stderr, "--via, --acia and --fb cannot be combined with --diff\n");
+        exit(EXIT_FAILURE);
+    }
+    if(diffcycles > 0 && difffusion == (int32_t)fusion){
+        fprintf(stderr, "--diff needs a second CPU configured differently, see --diff-against\n");
+        exit(EXIT_FAILURE);
+    }
+
+#ifndef SHADOW_STACK_6502
+    if(calls || callgraph != nullptr){
+        fprintf(stderr, "--calls and --callgraph need a SHADOW_STACK_6502 build\n");
+        exit(EXIT_FAILURE);
+    }
+#endif
+
     mem_6502 mem{};
     cpu_6502 cpu{};
+    sched_6502 events;
 
     cpu.reset(mem);
+    cpu.attach(&events);
+    cpu.setidleskip(turbo);
+    cpu.setfusion(fusion);
+    cpu.setjam(jam);
+#ifdef SHADOW_STACK_6502
+    uint32_t faults = 0;
+    cpu.getshadow().setfault(onstackfault, &faults);
+#endif
+    std::unique_ptr<via_6522> via;
+    if(viaaddr >= 0){
+        via.reset(new via_6522(cpu, events, mem, (word)viaaddr, 1));
+    }
+    std::unique_ptr<acia_6551> acia;
+    if(aciaaddr >= 0){
+        acia.reset(new acia_6551(cpu, events, mem, (word)aciaaddr, 2));
+        if(!acia->open(serial)){
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    std::unique_ptr<fb_6502> fb;
+    capture_6502 capture{nullptr, &events, frames, nullptr, 0};
+    if(fbaddr >= 0){
+        fb.reset(new fb_6502(mem, (word)fbaddr, fbwidth, fbheight, fbmode, fbfont));
+        capture.fb = fb.get();
+        if(frames == nullptr){
+            capture.path = "frame%04d.ppm";
+        } else if(strchr(frames, '%') == nullptr){
+            capture.raw = fopen(frames, "wb");
+            if(capture.raw == nullptr){
+                fprintf(stderr, "ERROR: Cannot open %s: %s\n", frames, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+        } else if(!framepattern(frames)){
+            fprintf(stderr, "--frames needs exactly one %%d, with an optional width, or none\n");
+            exit(EXIT_FAILURE);
+        }
+        events.schedule(cpu.getclock() + FRAME_CYCLES, captureframe, &capture);
+    }
+
+    if(image != nullptr){
+        if(!mem.loadfile(image, loadaddr)){
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        // hardcoded inline program to test
+        // start
+        mem[0xFFFC] = LDA_ZP;
+        mem[0xFFFD] = 0x42;
+        mem[0x42] = 0x84;
+        // end
+    }
+
+    if(start >= 0){
+        regs_6502 regs = cpu.getregs();
+        regs.PC = (word)start;
+        cpu.setregs(regs);
+    }
+
+    if(disasm != nullptr || cfg != nullptr || aot != nullptr){
+        static dis_6502 dis(mem);
+        dis.addvectors();
+        if(start >= 0){
+            dis.addentry((word)start);
+        }
+        dis.explore();
+        if(!writeanalysis(disasm, dis, &dis_6502::listing)
+           || !writeanalysis(cfg, dis, &dis_6502::writedot)){
+            exit(EXIT_FAILURE);
+        }
+        if(aot != nullptr){
+            FILE* file = strcmp(aot, "-") == 0 ? stdout : fopen(aot, "w");
+            if(file == nullptr){
+                fprintf(stderr, "ERROR: Cannot open %s: %s\n", aot, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            aot_6502::generate(dis, file, aotname);
+            if(file != stdout){
+                fclose(file);
+            }
+        }
+        exit(EXIT_SUCCESS);
+    }
+
+    std::unique_ptr<metrics_6502> metrics;
+    if(metricsspec != nullptr || metricsfile != nullptr){
+        metrics.reset(new metrics_6502());
+        if(!metrics->open(metricsspec, metricsfile)){
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if(diffcycles > 0){
+        // the second side starts from a copy of the machine with its own,
+        // empty, scheduler and the configuration under test
+        static mem_6502 memb;
+        memb = mem;
+        sched_6502 eventsb;
+        cpu_6502 cpub = cpu;
+        cpub.attach(&eventsb);
+        cpub.setfusion(difffusion >= 0 ? difffusion != 0 : !cpu.getfusion());
+        diff_6502 diff(cpu, mem, cpub, memb);
+        bool same = diff.run(diffcycles, diffblock);
+        printf("%llu instructions agree\n", (unsigned long long)diff.getchecked());
+        if(!same){
+            printf("DIVERGED %s\n", diff.report().c_str());
+            exit(EXIT_FAILURE);
+        }
+    } else if(gdbspec != nullptr){
+        debug_6502 dbg(cpu, mem);
+        gdb_6502 gdb(cpu, mem, dbg);
+        if(!gdb.listen(gdbspec)){
+            exit(EXIT_FAILURE);
+        }
+        gdb.run(GDB_SLICE, gdbwait);
+    } else if(perf){
+        if(!profile(cpu, mem, runcycles)){
+            fprintf(stderr, "ERROR: No performance counter available\n");
+            exit(EXIT_FAILURE);
+        }
+    } else if(realtime > 0.0){
+        uint64_t hz = (uint64_t)(realtime * 1000000.0 + 0.5);
+        pace_6502 pace(hz);
+        run(cpu, mem, runcycles, slice > 0 ? slice : (int32_t)(hz / 1000 + 1), &pace, metrics.get());
+        pace.report(stderr);
+    } else if(runset){
+        run(cpu, mem, runcycles, slice > 0 ? slice : RUN_SLICE, nullptr, metrics.get());
+    } else {
+        cpu.execute(3, mem);
+    }
 
-    // hardcoded inline program to test
-    // start
-    mem[0xFFFC] = LDA_ZP;
-    mem[0xFFFD] = 0x42;
-    mem[0x42] = 0x84;
-    // end
+    if(fb){
+        // the screen as the program left it
+        capture.events = nullptr;
+        captureframe(&capture, cpu.getclock(), cpu.getclock());
+        if(capture.raw != nullptr){
+            fclose(capture.raw);
+        }
+    }
 
-    cpu.execute(3, mem);
+#ifdef SHADOW_STACK_6502
+    if(calls){
+        cpu.getshadow().report(stderr);
+    }
+    if(callgraph != nullptr){
+        FILE* file = strcmp(callgraph, "-") == 0 ? stdout : fopen(callgraph, "w");
+        if(file == nullptr){
+            fprintf(stderr, "ERROR: Cannot open %s: %s\n", callgraph, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        cpu.getshadow().writedot(file);
+        if(file != stdout){
+            fclose(file);
+        }
+    }
+#endif
 
+    // exit() skips the destructors, and with them the last dump
+    metrics.reset();
     exit(EXIT_SUCCESS);
 }
@@ -22,11 +22,299 @@
 typedef uint8_t byte;
 typedef uint16_t word;
 
-// opcodes for LDA
+// opcodes, grouped by instruction as in the obelisk reference
 static constexpr byte
-        LDA_IM  = 0xA9,
-        LDA_ZP  = 0xA5,
-        LDA_ZPX = 0xB5,
-        JSR     = 0x20;
+        // Load/Store Operations
+        LDA_IM   = 0xA9,
+        LDA_ZP   = 0xA5,
+        LDA_ZPX  = 0xB5,
+        LDA_ABS  = 0xAD,
+        LDA_ABSX = 0xBD,
+        LDA_ABSY = 0xB9,
+        LDA_INDX = 0xA1,
+        LDA_INDY = 0xB1,
+        LDX_IM   = 0xA2,
+        LDX_ZP   = 0xA6,
+        LDX_ZPY  = 0xB6,
+        LDX_ABS  = 0xAE,
+        LDX_ABSY = 0xBE,
+        LDY_IM   = 0xA0,
+        LDY_ZP   = 0xA4,
+        LDY_ZPX  = 0xB4,
+        LDY_ABS  = 0xAC,
+        LDY_ABSX = 0xBC,
+        STA_ZP   = 0x85,
+        STA_ZPX  = 0x95,
+        STA_ABS  = 0x8D,
+        STA_ABSX = 0x9D,
+        STA_ABSY = 0x99,
+        STA_INDX = 0x81,
+        STA_INDY = 0x91,
+        STX_ZP   = 0x86,
+        STX_ZPY  = 0x96,
+        STX_ABS  = 0x8E,
+        STY_ZP   = 0x84,
+        STY_ZPX  = 0x94,
+        STY_ABS  = 0x8C,
+
+        // Register Transfers
+        TAX      = 0xAA,
+        TAY      = 0xA8,
+        TXA      = 0x8A,
+        TYA      = 0x98,
+
+        // Stack Operations
+        TSX      = 0xBA,
+        TXS      = 0x9A,
+        PHA      = 0x48,
+        PHP      = 0x08,
+        PLA      = 0x68,
+        PLP      = 0x28,
+
+        // Logical
+        AND_IM   = 0x29,
+        AND_ZP   = 0x25,
+        AND_ZPX  = 0x35,
+        AND_ABS  = 0x2D,
+        AND_ABSX = 0x3D,
+        AND_ABSY = 0x39,
+        AND_INDX = 0x21,
+        AND_INDY = 0x31,
+        EOR_IM   = 0x49,
+        EOR_ZP   = 0x45,
+        EOR_ZPX  = 0x55,
+        EOR_ABS  = 0x4D,
+        EOR_ABSX = 0x5D,
+        EOR_ABSY = 0x59,
+        EOR_INDX = 0x41,
+        EOR_INDY = 0x51,
+        ORA_IM   = 0x09,
+        ORA_ZP   = 0x05,
+        ORA_ZPX  = 0x15,
+        ORA_ABS  = 0x0D,
+        ORA_ABSX = 0x1D,
+        ORA_ABSY = 0x19,
+        ORA_INDX = 0x01,
+        ORA_INDY = 0x11,
+        BIT_ZP   = 0x24,
+        BIT_ABS  = 0x2C,
+
+        // Arithmetic
+        ADC_IM   = 0x69,
+        ADC_ZP   = 0x65,
+        ADC_ZPX  = 0x75,
+        ADC_ABS  = 0x6D,
+        ADC_ABSX = 0x7D,
+        ADC_ABSY = 0x79,
+        ADC_INDX = 0x61,
+        ADC_INDY = 0x71,
+        SBC_IM   = 0xE9,
+        SBC_ZP   = 0xE5,
+        SBC_ZPX  = 0xF5,
+        SBC_ABS  = 0xED,
+        SBC_ABSX = 0xFD,
+        SBC_ABSY = 0xF9,
+        SBC_INDX = 0xE1,
+        SBC_INDY = 0xF1,
+        CMP_IM   = 0xC9,
+        CMP_ZP   = 0xC5,
+        CMP_ZPX  = 0xD5,
+        CMP_ABS  = 0xCD,
+        CMP_ABSX = 0xDD,
+        CMP_ABSY = 0xD9,
+        CMP_INDX = 0xC1,
+        CMP_INDY = 0xD1,
+        CPX_IM   = 0xE0,
+        CPX_ZP   = 0xE4,
+        CPX_ABS  = 0xEC,
+        CPY_IM   = 0xC0,
+        CPY_ZP   = 0xC4,
+        CPY_ABS  = 0xCC,
+
+        // Increments & Decrements
+        INC_ZP   = 0xE6,
+        INC_ZPX  = 0xF6,
+        INC_ABS  = 0xEE,
+        INC_ABSX = 0xFE,
+        INX      = 0xE8,
+        INY      = 0xC8,
+        DEC_ZP   = 0xC6,
+        DEC_ZPX  = 0xD6,
+        DEC_ABS  = 0xCE,
+        DEC_ABSX = 0xDE,
+        DEX      = 0xCA,
+        DEY      = 0x88,
+
+        // Shifts
+        ASL_ACC  = 0x0A,
+        ASL_ZP   = 0x06,
+        ASL_ZPX  = 0x16,
+        ASL_ABS  = 0x0E,
+        ASL_ABSX = 0x1E,
+        LSR_ACC  = 0x4A,
+        LSR_ZP   = 0x46,
+        LSR_ZPX  = 0x56,
+        LSR_ABS  = 0x4E,
+        LSR_ABSX = 0x5E,
+        ROL_ACC  = 0x2A,
+        ROL_ZP   = 0x26,
+        ROL_ZPX  = 0x36,
+        ROL_ABS  = 0x2E,
+        ROL_ABSX = 0x3E,
+        ROR_ACC  = 0x6A,
+        ROR_ZP   = 0x66,
+        ROR_ZPX  = 0x76,
+        ROR_ABS  = 0x6E,
+        ROR_ABSX = 0x7E,
+
+        // Jumps & Calls
+        JMP_ABS  = 0x4C,
+        JMP_IND  = 0x6C,
+        JSR      = 0x20,
+        RTS      = 0x60,
+
+        // Branches
+        BCC      = 0x90,
+        BCS      = 0xB0,
+        BEQ      = 0xF0,
+        BMI      = 0x30,
+        BNE      = 0xD0,
+        BPL      = 0x10,
+        BVC      = 0x50,
+        BVS      = 0x70,
+
+        // Status Flag Changes
+        CLC      = 0x18,
+        CLD      = 0xD8,
+        CLI      = 0x58,
+        CLV      = 0xB8,
+        SEC      = 0x38,
+        SED      = 0xF8,
+        SEI      = 0x78,
+
+        // System Functions
+        BRK      = 0x00,
+        NOP      = 0xEA,
+        RTI      = 0x40,
+
+        // Undocumented NMOS Operations, names as in the 6502.org and
+        // VICE references; duplicates of one operation and addressing mode
+        // carry their opcode
+        SLO_ZP   = 0x07,    // ASL then ORA
+        SLO_ZPX  = 0x17,
+        SLO_ABS  = 0x0F,
+        SLO_ABSX = 0x1F,
+        SLO_ABSY = 0x1B,
+        SLO_INDX = 0x03,
+        SLO_INDY = 0x13,
+
+        RLA_ZP   = 0x27,    // ROL then AND
+        RLA_ZPX  = 0x37,
+        RLA_ABS  = 0x2F,
+        RLA_ABSX = 0x3F,
+        RLA_ABSY = 0x3B,
+        RLA_INDX = 0x23,
+        RLA_INDY = 0x33,
+
+        SRE_ZP   = 0x47,    // LSR then EOR
+        SRE_ZPX  = 0x57,
+        SRE_ABS  = 0x4F,
+        SRE_ABSX = 0x5F,
+        SRE_ABSY = 0x5B,
+        SRE_INDX = 0x43,
+        SRE_INDY = 0x53,
+
+        RRA_ZP   = 0x67,    // ROR then ADC
+        RRA_ZPX  = 0x77,
+        RRA_ABS  = 0x6F,
+        RRA_ABSX = 0x7F,
+        RRA_ABSY = 0x7B,
+        RRA_INDX = 0x63,
+        RRA_INDY = 0x73,
+
+        SAX_ZP   = 0x87,    // store A & X
+        SAX_ZPY  = 0x97,
+        SAX_ABS  = 0x8F,
+        SAX_INDX = 0x83,
+
+        LAX_ZP   = 0xA7,    // LDA and LDX at once
+        LAX_ZPY  = 0xB7,
+        LAX_ABS  = 0xAF,
+        LAX_ABSY = 0xBF,
+        LAX_INDX = 0xA3,
+        LAX_INDY = 0xB3,
+
+        DCP_ZP   = 0xC7,    // DEC then CMP
+        DCP_ZPX  = 0xD7,
+        DCP_ABS  = 0xCF,
+        DCP_ABSX = 0xDF,
+        DCP_ABSY = 0xDB,
+        DCP_INDX = 0xC3,
+        DCP_INDY = 0xD3,
+
+        ISC_ZP   = 0xE7,    // INC then SBC
+        ISC_ZPX  = 0xF7,
+        ISC_ABS  = 0xEF,
+        ISC_ABSX = 0xFF,
+        ISC_ABSY = 0xFB,
+        ISC_INDX = 0xE3,
+        ISC_INDY = 0xF3,
+
+        ANC_IM   = 0x0B,    // AND, C = N
+        ANC_2B   = 0x2B,
+        ALR_IM   = 0x4B,    // AND then LSR A
+        ARR_IM   = 0x6B,    // AND then ROR A, odd flags
+        SBX_IM   = 0xCB,    // X = (A & X) - operand
+        SBC_EB   = 0xEB,
+        ANE_IM   = 0x8B,    // unstable, A = (A | magic) & X & operand
+        LXA_IM   = 0xAB,    // unstable, A = X = (A | magic) & operand
+        LAS_ABSY = 0xBB,    // A = X = SP = operand & SP
+
+        SHA_ABSY = 0x9F,    // unstable stores of a register & (high + 1)
+        SHA_INDY = 0x93,
+        SHX_ABSY = 0x9E,
+        SHY_ABSX = 0x9C,
+        TAS_ABSY = 0x9B,    // SP = A & X, then stored like SHA
+
+        NOP_1A   = 0x1A,    // implied
+        NOP_3A   = 0x3A,
+        NOP_5A   = 0x5A,
+        NOP_7A   = 0x7A,
+        NOP_DA   = 0xDA,
+        NOP_FA   = 0xFA,
+        NOP_80   = 0x80,    // immediate
+        NOP_82   = 0x82,
+        NOP_89   = 0x89,
+        NOP_C2   = 0xC2,
+        NOP_E2   = 0xE2,
+        NOP_04   = 0x04,    // zero page
+        NOP_44   = 0x44,
+        NOP_64   = 0x64,
+        NOP_14   = 0x14,    // zero page,X
+        NOP_34   = 0x34,
+        NOP_54   = 0x54,
+        NOP_74   = 0x74,
+        NOP_D4   = 0xD4,
+        NOP_F4   = 0xF4,
+        NOP_0C   = 0x0C,    // absolute
+        NOP_1C   = 0x1C,    // absolute,X
+        NOP_3C   = 0x3C,
+        NOP_5C   = 0x5C,
+        NOP_7C   = 0x7C,
+        NOP_DC   = 0xDC,
+        NOP_FC   = 0xFC,
+
+        JAM_02   = 0x02,    // lock the CPU up, see cpu_6502::setjam()
+        JAM_12   = 0x12,
+        JAM_22   = 0x22,
+        JAM_32   = 0x32,
+        JAM_42   = 0x42,
+        JAM_52   = 0x52,
+        JAM_62   = 0x62,
+        JAM_72   = 0x72,
+        JAM_92   = 0x92,
+        JAM_B2   = 0xB2,
+        JAM_D2   = 0xD2,
+        JAM_F2   = 0xF2;
 
 #endif //INC_6502_H
\ No newline at end of file
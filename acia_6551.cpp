@@ -0,0 +1,380 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       acia_6551.cpp
+ * @desc:       Source file for the 6551 Asynchronous Communications Interface
+ *              Adapter
+ *****************************************************************************/
+
+#include "acia_6551.h"
+#include "sock_6502.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// baud rates of the control register rate field, times 100; the external
+// 16x clock (0) is taken as the fastest common rate
+static const uint64_t BAUD100[16] = {
+    11520000, 5000, 7500, 10992, 13458, 15000, 30000, 60000,
+    120000, 180000, 240000, 360000, 480000, 720000, 960000, 1920000
+};
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates an ACIA mapped at base..base+3 of memory, timed by events for a
+// CPU running at clockhz and driving the lines bits of the cpu IRQ line.
+acia_6551::acia_6551(cpu_6502& cpu, sched_6502& events, mem_6502& memory, word base, uint32_t lines,
+                     uint64_t clockhz) : cpu(cpu), events(events), mem(memory){
+    irqline = lines;
+    this->clockhz = clockhz;
+    txevent = rxevent = 0;
+    infd = outfd = -1;
+    server = -1;
+    wake[0] = wake[1] = -1;
+    quit = false;
+    reset();
+    mapping = mem.mapio(base, base + 0x03, ioread, iowrite, this);
+}
+
+// Stops the I/O thread, unmaps the ACIA and releases its IRQ line.
+acia_6551::~acia_6551(){
+    quit = true;
+    if(wake[1] >= 0 && write(wake[1], "q", 1) < 0){
+        perror("ERROR: write");
+    }
+    if(io.joinable()){
+        io.join();
+    }
+    for(int fd : {wake[0], wake[1], server}){
+        if(fd >= 0){
+            close(fd);
+        }
+    }
+    if(!unixpath.empty()){
+        unlink(unixpath.c_str());
+    }
+    mem.unmapio(mapping);
+    for(uint32_t id : {txevent, rxevent}){
+        if(id != 0){
+            events.cancel(id);
+        }
+    }
+    cpu.setirq(irqline, false);
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  open()
+ *
+ *  @desc:      Connects the serial line to a host stream and starts the
+ *              I/O thread
+ *  @param:     spec - "stdio", "fd:IN,OUT", "PORT", "tcp:PORT" or
+ *                     "unix:PATH"
+ *  @return:    true on success
+ * */
+bool acia_6551::open(const char* spec){
+    if(io.joinable()){
+        fprintf(stderr, "ERROR: ACIA already open\n");
+        return false;
+    }
+    if(strcmp(spec, "stdio") == 0){
+        infd = STDIN_FILENO;
+        outfd = STDOUT_FILENO;
+    } else if(strncmp(spec, "fd:", 3) == 0){
+        if(sscanf(spec + 3, "%d,%d", &infd, &outfd) != 2){
+            fprintf(stderr, "ERROR: Expected fd:IN,OUT, got %s\n", spec);
+            infd = outfd = -1;
+            return false;
+        }
+    } else {
+        server = openserver(spec, unixpath);
+        if(server < 0){
+            return false;
+        }
+    }
+    if(pipe(wake) < 0){
+        perror("ERROR: pipe");
+        return false;
+    }
+    // the CPU thread must never block on a wakeup
+    fcntl(wake[1], F_SETFL, fcntl(wake[1], F_GETFL) | O_NONBLOCK);
+    io = std::thread(&acia_6551::serve, this);
+    return true;
+}
+
+/*
+ *  reset()
+ *
+ *  @desc:      Hardware reset: clears the command and control registers
+ *  @param:     None
+ *  @return:    None
+ * */
+void acia_6551::reset(){
+    command = control = 0;
+    status = STATUS_TDRE;
+    irq = false;
+    rxdata = txdata = txshift = 0;
+    txbusy = false;
+    if(txevent != 0){
+        events.cancel(txevent);
+        txevent = 0;
+    }
+    reformat();
+    updateirq();
+}
+
+/*
+ *  writereg()
+ *
+ *  @desc:      Writes a register as the CPU does
+ *  @param:     reg - REG_* register number
+ *              val - Value written
+ *  @return:    None
+ * */
+void acia_6551::writereg(byte reg, byte val){
+    switch(reg & 0x03){
+        case REG_DATA:
+            if(!txbusy){
+                // goes straight to the shift register
+                txshift = val;
+                txbusy = true;
+                txevent = events.schedule(cpu.getclock() + chartime, txdone, this);
+            } else {
+                txdata = val;
+                status &= ~STATUS_TDRE;
+            }
+            break;
+        case REG_STATUS:
+            // programmed reset keeps the parity mode and the control register
+            command &= 0xE0;
+            status &= ~STATUS_OVERRUN;
+            irq = false;
+            reformat();
+            updateirq();
+            break;
+        case REG_COMMAND:
+            // DTR gates the IRQ line, so a pending interrupt follows it
+            command = val;
+            reformat();
+            updateirq();
+            break;
+        default:    // REG_CONTROL
+            control = val;
+            reformat();
+            break;
+    }
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  readreg()
+ *
+ *  @desc:      Reads a register as the CPU does, with its side effects
+ *  @param:     reg - REG_* register number
+ *  @return:    Register value
+ * */
+byte acia_6551::readreg(byte reg){
+    switch(reg & 0x03){
+        case REG_DATA:
+            status &= ~(STATUS_RDRF | STATUS_OVERRUN);
+            return rxdata;
+        case REG_STATUS:{
+            byte val = status | (irq ? STATUS_IRQ : 0);
+            irq = false;
+            updateirq();
+            return val;
+        }
+        case REG_COMMAND:
+            return command;
+        default:    // REG_CONTROL
+            return control;
+    }
+}
+
+
+// Private helpers ---------------------------------------------------------
+byte acia_6551::ioread(void* ctx, word addr){
+    return static_cast<acia_6551*>(ctx)->readreg(addr & 0x03);
+}
+
+void acia_6551::iowrite(void* ctx, word addr, byte val){
+    static_cast<acia_6551*>(ctx)->writereg(addr & 0x03, val);
+}
+
+void acia_6551::txdone(void* ctx, uint64_t when, uint64_t now){
+    acia_6551* acia = static_cast<acia_6551*>(ctx);
+    (void)now;
+    if(!acia->send(acia->txshift)){
+        // host is behind: hold the line until there is room
+        acia->txevent = acia->events.schedule(when + acia->chartime, txdone, acia);
+        return;
+    }
+    if(!(acia->status & STATUS_TDRE)){
+        acia->txshift = acia->txdata;
+        acia->status |= STATUS_TDRE;
+        if((acia->command & CMD_TIC) == CMD_TIC_IRQ && (acia->command & CMD_DTR)){
+            acia->irq = true;
+            acia->updateirq();
+        }
+        acia->txevent = acia->events.schedule(when + acia->chartime, txdone, acia);
+    } else {
+        acia->txbusy = false;
+        acia->txevent = 0;
+    }
+}
+
+void acia_6551::rxpoll(void* ctx, uint64_t when, uint64_t now){
+    acia_6551* acia = static_cast<acia_6551*>(ctx);
+    (void)now;
+    acia->rxevent = acia->events.schedule(when + acia->chartime, rxpoll, acia);
+    // a full receive register holds the host back instead of overrunning,
+    // which would only lose data the host already buffered
+    byte val;
+    if((acia->status & STATUS_RDRF) || !acia->rx.pop(val)){
+        return;
+    }
+    acia->rxdata = val;
+    acia->status |= STATUS_RDRF;
+    if(acia->command & CMD_ECHO){
+        acia->send(val);
+    }
+    if(!(acia->command & CMD_IRD)){
+        acia->irq = true;
+        acia->updateirq();
+    }
+}
+
+void acia_6551::reformat(){
+    // start bit, 8 to 5 data bits, parity, 1 or 2 stop bits
+    uint64_t bits = 1 + (8 - ((control >> 5) & 0x03)) + ((command & CMD_PARITY) ? 1 : 0)
+                  + ((control & 0x80) ? 2 : 1);
+    chartime = clockhz * bits * 100 / BAUD100[control & 0x0F];
+    if(chartime == 0){
+        chartime = 1;
+    }
+
+    bool enabled = (command & CMD_DTR) != 0;
+    if(enabled && rxevent == 0){
+        rxevent = events.schedule(cpu.getclock() + chartime, rxpoll, this);
+    } else if(!enabled && rxevent != 0){
+        events.cancel(rxevent);
+        rxevent = 0;
+    }
+}
+
+bool acia_6551::send(byte val){
+    if(outfd < 0 && server < 0){
+        return true;    // nothing attached, the line goes nowhere
+    }
+    bool wasempty = tx.empty();
+    if(!tx.push(val)){
+        return false;
+    }
+    // the I/O thread drains the ring completely before it sleeps, so it
+    // only needs waking when this byte made the ring non-empty
+    if(wasempty && write(wake[1], "w", 1) < 0 && errno != EAGAIN){
+        perror("ERROR: write");
+    }
+    return true;
+}
+
+void acia_6551::updateirq(){
+    cpu.setirq(irqline, irq && (command & CMD_DTR));
+}
+
+
+// I/O thread --------------------------------------------------------------
+/*
+ *  serve()
+ *
+ *  @desc:      I/O thread body: accepts a client when listening, moves host
+ *              input into rx and tx into host output
+ * */
+void acia_6551::serve(){
+    byte inbuf[4096], outbuf[4096];
+    size_t inlen = 0, inpos = 0;        // input read but not yet in rx
+    size_t outlen = 0, outpos = 0;      // output taken from tx, not written
+    int client = -1;
+    int in = infd, out = outfd;
+
+    while(!quit){
+        pollfd fds[3];
+        nfds_t n = 0;
+        fds[n++] = {wake[0], POLLIN, 0};
+        int inslot = -1, outslot = -1, acceptslot = -1;
+        if(in < 0 && server >= 0){
+            acceptslot = (int)n;
+            fds[n++] = {server, POLLIN, 0};
+        }
+        if(in >= 0 && inpos == inlen){
+            inslot = (int)n;
+            fds[n++] = {in, POLLIN, 0};
+        }
+        if(outpos == outlen){
+            outpos = outlen = 0;
+            byte val;
+            while(outlen < sizeof(outbuf) && tx.pop(val)){
+                outbuf[outlen++] = val;
+            }
+        }
+        if(out >= 0 && outpos < outlen){
+            outslot = (int)n;
+            fds[n++] = {out, POLLOUT, 0};
+        } else if(out < 0){
+            outpos = outlen = 0;    // nobody to deliver to
+        }
+        // input waiting on a full rx ring is retried after a short sleep,
+        // the CPU thread never signals that it drained rx
+        if(poll(fds, n, inpos < inlen ? 1 : -1) < 0 && errno != EINTR){
+            perror("ERROR: poll");
+            break;
+        }
+
+        if(fds[0].revents & POLLIN){
+            char drain[64];
+            if(read(wake[0], drain, sizeof(drain)) < 0){
+                perror("ERROR: read");
+            }
+        }
+        if(acceptslot >= 0 && (fds[acceptslot].revents & POLLIN)){
+            client = accept(server, nullptr, nullptr);
+            in = out = client;
+        }
+        if(inslot >= 0 && (fds[inslot].revents & (POLLIN | POLLHUP | POLLERR))){
+            ssize_t len = read(in, inbuf, sizeof(inbuf));
+            if(len > 0){
+                inlen = (size_t)len;
+                inpos = 0;
+            } else if(client >= 0){
+                // client went away, wait for the next one
+                close(client);
+                client = in = out = -1;
+            } else {
+                in = -1;    // end of input, keep writing output
+            }
+        }
+        while(inpos < inlen && rx.push(inbuf[inpos])){
+            inpos++;
+        }
+        if(outslot >= 0 && (fds[outslot].revents & (POLLOUT | POLLHUP | POLLERR))){
+            ssize_t len = write(out, outbuf + outpos, outlen - outpos);
+            if(len > 0){
+                outpos += (size_t)len;
+            } else if(client >= 0){
+                close(client);
+                client = in = out = -1;
+            } else {
+                out = -1;
+            }
+        }
+    }
+    if(client >= 0){
+        close(client);
+    }
+}
@@ -0,0 +1,188 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       acia_6551.h
+ * @desc:       Header file for the 6551 Asynchronous Communications Interface
+ *              Adapter
+ * @ref:        http://archive.6502.org/datasheets/rockwell_r6551_acia.pdf
+ * @note:       The serial line is bridged to a host stream. The CPU thread
+ *              only touches two lock-free rings; an I/O thread moves bytes
+ *              between them and the stream, so host I/O never stalls
+ *              emulation. Characters move at the programmed baud rate,
+ *              timed by scheduler events. Parity and framing errors cannot
+ *              happen on a host stream and the modem lines always read as
+ *              connected.
+ *****************************************************************************/
+
+#ifndef INC_6502_ACIA_6551_H
+#define INC_6502_ACIA_6551_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "ring_6502.h"
+#include "sched_6502.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+class acia_6551 {
+public:
+    // registers, offsets from the base address
+    static constexpr byte
+            REG_DATA    = 0x0,
+            REG_STATUS  = 0x1,  // writing it is a programmed reset
+            REG_COMMAND = 0x2,
+            REG_CONTROL = 0x3;
+
+    // status register bits
+    static constexpr byte
+            STATUS_PARITY  = 0x01,
+            STATUS_FRAMING = 0x02,
+            STATUS_OVERRUN = 0x04,
+            STATUS_RDRF    = 0x08,  // receive data register full
+            STATUS_TDRE    = 0x10,  // transmit data register empty
+            STATUS_DCD     = 0x20,
+            STATUS_DSR     = 0x40,
+            STATUS_IRQ     = 0x80;
+
+    // host side buffering in each direction
+    static constexpr uint32_t RING_SIZE = 1 << 16;
+
+private:
+    // command register fields
+    static constexpr byte
+            CMD_DTR      = 0x01,    // receiver and interrupts enabled
+            CMD_IRD      = 0x02,    // receive interrupts disabled
+            CMD_TIC      = 0x0C,    // transmitter control
+            CMD_TIC_IRQ  = 0x04,    // ... with transmit interrupts
+            CMD_ECHO     = 0x10,
+            CMD_PARITY   = 0x20;    // parity enabled
+
+    // Device Fields
+    cpu_6502& cpu;
+    sched_6502& events;
+    mem_6502& mem;
+    int mapping;            // mapio() id
+    uint32_t irqline;       // bit of the cpu IRQ line this ACIA drives
+    uint64_t clockhz;       // CPU clock, to convert baud rates to cycles
+
+    byte command, control;
+    byte status;            // all bits but STATUS_IRQ
+    bool irq;               // interrupt latched until status is read
+    byte rxdata;
+    byte txdata;            // transmit data register
+    byte txshift;           // character being shifted out
+    bool txbusy;            // txshift holds a character
+    uint64_t chartime;      // cycles per character at the current format
+    uint32_t txevent, rxevent;  // scheduler ids, 0 if none
+
+    // Host Fields
+    ring_6502<RING_SIZE> rx;    // host -> CPU, filled by the I/O thread
+    ring_6502<RING_SIZE> tx;    // CPU -> host, drained by the I/O thread
+    int infd, outfd;        // host stream, -1 if none
+    int server;             // listening socket, -1 if none
+    std::string unixpath;   // socket file to remove, if any
+    int wake[2];            // pipe waking the I/O thread
+    std::atomic<bool> quit;
+    std::thread io;
+
+    // mem_6502 and sched_6502 callbacks
+    static byte ioread(void* ctx, word addr);
+    static void iowrite(void* ctx, word addr, byte val);
+    static void txdone(void* ctx, uint64_t when, uint64_t now);
+    static void rxpoll(void* ctx, uint64_t when, uint64_t now);
+
+    /*
+     *  reformat()
+     *
+     *  @desc:      Recomputes the character time from the control register
+     *              and starts or stops the receiver from the command register
+     * */
+    void reformat();
+
+    /*
+     *  send()
+     *
+     *  @desc:      Hands a character to the host, waking the I/O thread if
+     *              it may be idle
+     *  @return:    false if the host ring is full
+     * */
+    bool send(byte val);
+
+    /*
+     *  updateirq()
+     *
+     *  @desc:      Drives the IRQ output from the latched interrupt
+     * */
+    void updateirq();
+
+    /*
+     *  serve()
+     *
+     *  @desc:      I/O thread body
+     * */
+    void serve();
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates an ACIA mapped at base..base+3 of memory, timed by events for a
+    // CPU running at clockhz and driving the lines bits of the cpu IRQ line.
+    acia_6551(cpu_6502& cpu, sched_6502& events, mem_6502& memory, word base, uint32_t lines,
+              uint64_t clockhz = 1000000);
+
+    // Stops the I/O thread, unmaps the ACIA and releases its IRQ line.
+    ~acia_6551();
+
+    acia_6551(const acia_6551&) = delete;
+    acia_6551& operator=(const acia_6551&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  open()
+     *
+     *  @desc:      Connects the serial line to a host stream and starts the
+     *              I/O thread
+     *  @param:     spec - "stdio", "fd:IN,OUT" for inherited descriptors
+     *                     such as pipes, "PORT" or "tcp:PORT" to accept a
+     *                     connection on 127.0.0.1, "unix:PATH" to accept
+     *                     one on a Unix domain socket
+     *  @return:    true on success
+     * */
+    bool open(const char* spec);
+
+    /*
+     *  reset()
+     *
+     *  @desc:      Hardware reset: clears the command and control registers
+     *  @param:     None
+     *  @return:    None
+     * */
+    void reset();
+
+    /*
+     *  writereg()
+     *
+     *  @desc:      Writes a register as the CPU does
+     *  @param:     reg - REG_* register number
+     *              val - Value written
+     *  @return:    None
+     * */
+    void writereg(byte reg, byte val);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  readreg()
+     *
+     *  @desc:      Reads a register as the CPU does, with its side effects
+     *  @param:     reg - REG_* register number
+     *  @return:    Register value
+     * */
+    byte readreg(byte reg);
+};
+
+#endif //INC_6502_ACIA_6551_H
@@ -0,0 +1,437 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       aot_6502.cpp
+ * @desc:       Source file for ahead of time translation of 6502 code to C++
+ *****************************************************************************/
+
+#include "aot_6502.h"
+#include "dis_6502.h"
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <string>
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a runtime for the translations in code, which must have been
+// generated from the code now in memory.
+aot_6502::aot_6502(cpu_6502& processor, mem_6502& mem, const aotimage_6502& code)
+        : cpu(processor), memory(mem), image(code), index(0x10000, 0), pageblocks(0x100),
+          changed(code.count, 0){
+    for(uint32_t i = 0; i < image.count; i++){
+        const aotblock_6502& b = image.blocks[i];
+        if(index[b.start] == 0){
+            index[b.start] = i + 1;
+        }
+        for(uint32_t page = b.start >> 8; page <= (b.end - 1) >> 8; page++){
+            memory.markcode((word)(page << 8), true);
+            pageblocks[page].push_back(i);
+        }
+    }
+    translated = interpreted = stale = 0;
+    cycles = 0;
+}
+
+// Releases the code pages flagged in memory.
+aot_6502::~aot_6502(){
+    for(uint32_t i = 0; i < image.count; i++){
+        const aotblock_6502& b = image.blocks[i];
+        for(uint32_t page = b.start >> 8; page <= (b.end - 1) >> 8; page++){
+            memory.markcode((word)(page << 8), false);
+        }
+    }
+}
+
+
+// Other Functions ---------------------------------------------------------
+/*
+ *  execute()
+ *
+ *  @desc:      Runs the CPU as cpu_6502::execute() does, through the
+ *              translated blocks where it can. Cycle exact and shadow
+ *              stack builds only interpret, translated code reports no
+ *              bus cycles and no calls.
+ *  @param:     budget - Number of cycles to run
+ *  @return:    None
+ * */
+void aot_6502::execute(int32_t budget){
+#if defined(CYCLE_EXACT_6502) || defined(SHADOW_STACK_6502)
+    uint64_t before = cpu.getretired();
+    cpu.execute(budget, memory);
+    interpreted += cpu.getretired() - before;
+#else
+    cpu.stopped = cpu_6502::STOP_NONE;
+    memory.clearhit();
+    while(budget > 0){
+        uint32_t at = index[cpu.PC];
+        if(at == 0 || !runnable(image.blocks[at - 1], budget, cpu.clock)){
+            // one instruction at a time, so the next block boundary is
+            // seen; a jammed CPU only passes time
+            uint64_t now = cpu.clock;
+            uint64_t before = cpu.retired;
+            cpu.execute(cpu.jammed ? budget : 1, memory);
+            budget -= (int32_t)(cpu.clock - now);
+            interpreted += cpu.retired - before;
+            if(cpu.stopped != cpu_6502::STOP_NONE){
+                break;
+            }
+            continue;
+        }
+
+        // translated blocks back to back until one cannot run, with the
+        // same clock bookkeeping as the interpreter
+        cycles = budget;
+        cpu.endclock = cpu.clock + budget;
+        cpu.left = &cycles;
+        uint64_t before = translated;
+        do {
+            image.blocks[at - 1].run(*this, cpu.PC);
+            at = index[cpu.PC];
+        } while(at != 0 && enter(at - 1));
+        cpu.clock = cpu.endclock - cycles;
+        cpu.left = nullptr;
+        cpu.retired += translated - before;
+        budget = cycles;
+
+        if(memory.watchhit()){
+            cpu.stopped = cpu_6502::STOP_WATCH;
+            break;
+        }
+    }
+#endif
+}
+
+
+// Private helpers ---------------------------------------------------------
+bool aot_6502::unchanged(const aotblock_6502& b){
+    for(uint32_t i = 0; i < b.end - b.start; i++){
+        if(memory.fetch((word)(b.start + i)) != image.original[b.original + i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+void aot_6502::recheck(word addr){
+    // a block spanning two pages is compared whole whenever either of them
+    // was written, so its result stays valid while both are clean
+    for(uint32_t i : pageblocks[addr >> 8]){
+        changed[i] = !unchanged(image.blocks[i]);
+    }
+    memory.cleardirty(addr);
+}
+
+
+// Translation ---------------------------------------------------------------
+
+// instructions generate() leaves to the interpreter: interrupt entry and
+// exit, the I flag changes with their delayed IRQ poll and undocumented
+// operations other than the NOPs
+static bool interpretonly(const dis_6502::opinfo_6502& op){
+    return op.opcode == BRK || op.opcode == RTI || op.opcode == CLI || op.opcode == SEI
+        || op.opcode == PLP || (op.undocumented && strcmp(op.name, "NOP") != 0);
+}
+
+/*
+ *  operand()
+ *
+ *  @desc:      Builds the C++ statements computing the effective address
+ *              ea of an instruction and charging its cycles
+ *  @param:     op - Opcode information
+ *              lo, abs - Operand byte and word
+ *  @return:    Statements
+ * */
+static std::string operand(const dis_6502::opinfo_6502& op, byte lo, word abs){
+    char buf[160];
+    switch(op.mode){
+        case dis_6502::MODE_ZP:
+            snprintf(buf, sizeof(buf), "word ea = 0x%02X; rt.cycles -= %u;", lo, op.cycles);
+            break;
+        case dis_6502::MODE_ZPX:
+            snprintf(buf, sizeof(buf), "word ea = (byte)(0x%02X + rt.x()); rt.cycles -= %u;", lo, op.cycles);
+            break;
+        case dis_6502::MODE_ZPY:
+            snprintf(buf, sizeof(buf), "word ea = (byte)(0x%02X + rt.y()); rt.cycles -= %u;", lo, op.cycles);
+            break;
+        case dis_6502::MODE_ABS:
+            snprintf(buf, sizeof(buf), "word ea = 0x%04X; rt.cycles -= %u;", abs, op.cycles);
+            break;
+        case dis_6502::MODE_ABSX:
+        case dis_6502::MODE_ABSY:{
+            char reg = op.mode == dis_6502::MODE_ABSX ? 'x' : 'y';
+            if(op.cross && (abs & 0xFF)){
+                snprintf(buf, sizeof(buf), "word ea = (word)(0x%04X + rt.%c()); rt.cycles -= %u + (ea >> 8 != 0x%02X);",
+                         abs, reg, op.cycles, abs >> 8);
+            } else {
+                // an index into a page aligned base never crosses
+                snprintf(buf, sizeof(buf), "word ea = (word)(0x%04X + rt.%c()); rt.cycles -= %u;",
+                         abs, reg, op.cycles);
+            }
+        } break;
+        case dis_6502::MODE_INDX:
+            snprintf(buf, sizeof(buf), "word ea = rt.zpword((byte)(0x%02X + rt.x())); rt.cycles -= %u;",
+                     lo, op.cycles);
+            break;
+        case dis_6502::MODE_INDY:
+            if(op.cross){
+                snprintf(buf, sizeof(buf), "word base = rt.zpword(0x%02X); word ea = (word)(base + rt.y()); "
+                         "rt.cycles -= %u + ((ea ^ base) > 0xFF);", lo, op.cycles);
+            } else {
+                snprintf(buf, sizeof(buf), "word ea = (word)(rt.zpword(0x%02X) + rt.y()); rt.cycles -= %u;",
+                         lo, op.cycles);
+            }
+            break;
+        default:
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u;", op.cycles);
+            break;
+    }
+    return buf;
+}
+
+/*
+ *  translate()
+ *
+ *  @desc:      Builds the C++ statements of one instruction that does not
+ *              end its block
+ *  @param:     op - Opcode information
+ *              lo, abs - Operand byte and word
+ *  @return:    Statements
+ * */
+static std::string translate(const dis_6502::opinfo_6502& op, byte lo, word abs){
+    std::string ea = operand(op, lo, abs);
+    char imm[8];
+    snprintf(imm, sizeof(imm), "0x%02X", lo);
+    // the value operated on: immediate or read from ea
+    std::string val = op.mode == dis_6502::MODE_IMM ? imm : "rt.read(ea)";
+    std::string name = op.name;
+
+    std::string body;
+    if(name == "LDA" || name == "LDX" || name == "LDY"){
+        std::string reg = std::string("rt.") + (char)tolower(name[2]) + "()";
+        body = reg + " = " + val + "; rt.zn(" + reg + ");";
+    } else if(name == "STA" || name == "STX" || name == "STY"){
+        body = std::string("rt.write(ea, rt.") + (char)tolower(name[2]) + "());";
+    } else if(name == "AND" || name == "ORA" || name == "EOR"){
+        const char* sym = name == "AND" ? "&" : name == "ORA" ? "|" : "^";
+        body = std::string("rt.a() ") + sym + "= " + val + "; rt.zn(rt.a());";
+    } else if(name == "ADC" || name == "SBC"){
+        body = std::string(name == "ADC" ? "rt.adc(" : "rt.sbc(") + val + ");";
+    } else if(name == "CMP" || name == "CPX" || name == "CPY"){
+        const char* reg = name == "CMP" ? "a" : name == "CPX" ? "x" : "y";
+        body = std::string("rt.compare(rt.") + reg + "(), " + val + ");";
+    } else if(name == "BIT"){
+        body = "rt.bit(" + val + ");";
+    } else if(name == "INC" || name == "DEC"){
+        body = std::string("byte v = (byte)(rt.read(ea) ") + (name == "INC" ? "+" : "-")
+               + " 1); rt.write(ea, v); rt.zn(v);";
+    } else if(name == "ASL" || name == "LSR" || name == "ROL" || name == "ROR"){
+        std::string fn = "rt." + std::string(1, (char)tolower(name[0])) + (char)tolower(name[1])
+                         + (char)tolower(name[2]);
+        body = op.mode == dis_6502::MODE_ACC ? "rt.a() = " + fn + "(rt.a());"
+                                             : "rt.write(ea, " + fn + "(rt.read(ea)));";
+    } else if(name == "INX" || name == "INY" || name == "DEX" || name == "DEY"){
+        std::string reg = std::string("rt.") + (char)tolower(name[2]) + "()";
+        body = reg + (name[0] == 'I' ? "++" : "--") + "; rt.zn(" + reg + ");";
+    } else if(name[0] == 'T'){
+        // TAX TAY TXA TYA TSX TXS
+        auto reg = [](char r){ return std::string("rt.") + (r == 'S' ? "sp" : std::string(1, (char)tolower(r))) + "()"; };
+        body = reg(name[2]) + " = " + reg(name[1]) + ";";
+        if(name != "TXS"){
+            body += " rt.zn(" + reg(name[2]) + ");";
+        }
+    } else if(name == "PHA"){
+        body = "rt.push(rt.a());";
+    } else if(name == "PHP"){
+        body = "rt.push(rt.status() | cpu_6502::FLAG_B);";
+    } else if(name == "PLA"){
+        body = "rt.a() = rt.pull(); rt.zn(rt.a());";
+    } else if(name == "CLC" || name == "SEC"){
+        body = std::string("rt.setc(") + (name[0] == 'S' ? "true" : "false") + ");";
+    } else if(name == "CLD" || name == "SED"){
+        body = std::string("rt.setd(") + (name[0] == 'S' ? "true" : "false") + ");";
+    } else if(name == "CLV"){
+        body = "rt.setv(false);";
+    } else if(name == "NOP" && op.mode != dis_6502::MODE_IMP && op.mode != dis_6502::MODE_IMM){
+        // the undocumented NOPs still read their operand
+        body = "(void)rt.read(ea);";
+    }
+    return "{ " + ea + (body.empty() ? "" : " ") + body + " }";
+}
+
+/*
+ *  leave()
+ *
+ *  @desc:      Builds the C++ statements of the instruction that ends a
+ *              block, leaving PC at the next one to run
+ *  @param:     op - Opcode information
+ *              addr - Address of the instruction
+ *              lo, abs - Operand byte and word
+ *              exit - Builds the statements passing control to a static
+ *                     address
+ *  @return:    Statements
+ * */
+static std::string leave(const dis_6502::opinfo_6502& op, word addr, byte lo, word abs,
+                         const std::function<std::string(word)>& exit){
+    char buf[200];
+    word next = (word)(addr + dis_6502::length(op.opcode));
+    switch(op.flow){
+        case dis_6502::FLOW_BRANCH:{
+            static const char* const conds[] = {
+                "!rt.n()", "rt.n()", "!rt.v()", "rt.v()", "!rt.c()", "rt.c()", "!rt.z()", "rt.z()"
+            };
+            word target = (word)(next + (int8_t)lo);
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u;\n    if(%s){\n        rt.cycles -= %u;\n        ",
+                     op.cycles, conds[op.opcode >> 5], (target ^ next) & 0xFF00 ? 2 : 1);
+            std::string taken = exit(target);
+            for(size_t at = taken.find('\n'); at != std::string::npos; at = taken.find('\n', at + 1)){
+                taken.insert(at + 1, "    ");
+            }
+            return buf + taken + "\n    }\n    " + exit(next);
+        }
+        case dis_6502::FLOW_JUMP:
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u;\n    ", op.cycles);
+            return buf + exit(abs);
+        case dis_6502::FLOW_INDIRECT:
+            // NMOS bug: the pointer high byte does not carry into the next page
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u; rt.setpc(rt.read(0x%04X) | rt.read(0x%04X) << 8);\n    return;",
+                     op.cycles, abs, (abs & 0xFF00) | ((abs + 1) & 0xFF));
+            return buf;
+        case dis_6502::FLOW_CALL:
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u; rt.push(0x%02X); rt.push(0x%02X);\n    ",
+                     op.cycles, (word)(addr + 2) >> 8, (addr + 2) & 0xFF);
+            return buf + exit(abs);
+        case dis_6502::FLOW_RETURN:
+            // RTS, RTI is interpreted
+            snprintf(buf, sizeof(buf), "rt.cycles -= %u; { word pc = rt.pull(); pc |= rt.pull() << 8; "
+                     "rt.setpc((word)(pc + 1)); }\n    return;", op.cycles);
+            return buf;
+        default:
+            return translate(op, lo, abs) + "\n    " + exit(next);
+    }
+}
+
+/*
+ *  generate()
+ *
+ *  @desc:      Writes the C++ translation of an explored image. Blocks
+ *              stop before instructions left to the interpreter: BRK,
+ *              RTI, CLI, SEI, PLP and the undocumented opcodes other
+ *              than the NOPs.
+ *  @param:     dis - Disassembler after explore()
+ *              file - Output stream
+ *              name - Name of the aotimage_6502 to define
+ *  @return:    Number of blocks written
+ * */
+uint32_t aot_6502::generate(const dis_6502& dis, FILE* file, const char* name){
+    // cut the explored blocks into runs of instructions between the
+    // interpreted ones
+    std::vector<aotblock_6502> blocks;
+    std::vector<byte> original;
+    std::vector<int32_t> at(0x10000, -1);
+    // an instruction wrapping past $FFFF is interpreted too, so that blocks
+    // end by $FFFF and their pages stay within memory
+    auto interpreted = [&](uint32_t addr){
+        byte opcode = dis.getbyte((word)addr);
+        return interpretonly(dis_6502::info(opcode)) || addr + dis_6502::length(opcode) > 0x10000;
+    };
+    for(const dis_6502::block_6502& db : dis.getblocks()){
+        uint32_t addr = db.start;
+        while(addr < db.end){
+            while(addr < db.end && interpreted(addr)){
+                addr += dis_6502::length(dis.getbyte((word)addr));
+            }
+            if(addr >= db.end){
+                break;
+            }
+            aotblock_6502 b = {(word)addr, addr, 0, (uint32_t)original.size(), nullptr};
+            while(addr < db.end && !interpreted(addr)){
+                const dis_6502::opinfo_6502& op = dis_6502::info(dis.getbyte((word)addr));
+                for(byte i = 0; i < dis_6502::length(op.opcode); i++){
+                    original.push_back(dis.getbyte((word)(addr + i)));
+                }
+                addr += dis_6502::length(op.opcode);
+                b.cycles += op.cycles + (op.cross ? 1 : 0) + (op.flow == dis_6502::FLOW_BRANCH ? 2 : 0);
+            }
+            b.end = addr;
+            if(at[b.start] < 0){
+                at[b.start] = (int32_t)blocks.size();
+            }
+            blocks.push_back(b);
+        }
+    }
+
+    fprintf(file, "// Translated by 6502 --aot; regenerate rather than edit.\n\n");
+    fprintf(file, "#include \"aot_6502.h\"\n");
+
+    // one function per page holding the blocks starting in it, so loops
+    // within the page run as gotos without going back to execute()
+    for(size_t first = 0; first < blocks.size();){
+        size_t last = first;
+        while(last < blocks.size() && blocks[last].start >> 8 == blocks[first].start >> 8){
+            last++;
+        }
+        word page = blocks[first].start >> 8;
+        fprintf(file, "\nstatic void aot_%02X(aot_6502& rt, word pc){\n    switch(pc){\n", page);
+        for(size_t i = first; i < last; i++){
+            fprintf(file, "        case 0x%04X: goto L%04X;\n", blocks[i].start, blocks[i].start);
+        }
+        fprintf(file, "        default: return;\n    }\n");
+
+        auto exit = [&](word target){
+            char buf[96];
+            if(target >> 8 == page && at[target] >= 0){
+                snprintf(buf, sizeof(buf), "if(rt.enter(%d)) goto L%04X;\n    rt.setpc(0x%04X);\n    return;",
+                         at[target], target, target);
+            } else {
+                snprintf(buf, sizeof(buf), "rt.setpc(0x%04X);\n    return;", target);
+            }
+            return std::string(buf);
+        };
+        for(size_t i = first; i < last; i++){
+            aotblock_6502& b = blocks[i];
+            std::string body;
+            uint32_t insts = 0;
+            for(uint32_t addr = b.start; addr < b.end; insts++){
+                word pc = (word)addr;
+                const dis_6502::opinfo_6502& op = dis_6502::info(dis.getbyte(pc));
+                byte lo = dis.getbyte((word)(pc + 1));
+                word abs = lo | dis.getbyte((word)(pc + 2)) << 8;
+                char text[32];
+                addr += dis.format(pc, text, sizeof(text));
+                char comment[64];
+                snprintf(comment, sizeof(comment), "    // %04X  %s\n    ", pc, text);
+                body += comment + (addr < b.end ? translate(op, lo, abs) : leave(op, pc, lo, abs, exit)) + "\n";
+            }
+            fprintf(file, "L%04X:\n    rt.retire(%u);\n%s", b.start, insts, body.c_str());
+        }
+        fprintf(file, "}\n");
+        first = last;
+    }
+
+    fprintf(file, "\n");
+    if(blocks.empty()){
+        fprintf(file, "extern const aotimage_6502 %s;\n", name);
+        fprintf(file, "const aotimage_6502 %s = {nullptr, 0, nullptr};\n", name);
+        return 0;
+    }
+
+    fprintf(file, "static const aotblock_6502 BLOCKS[] = {\n");
+    for(const aotblock_6502& b : blocks){
+        fprintf(file, "    {0x%04X, 0x%04X, %u, %u, aot_%02X},\n", b.start, b.end, b.cycles, b.original, b.start >> 8);
+    }
+    fprintf(file, "};\n\n");
+
+    fprintf(file, "static const byte ORIGINAL[] = {");
+    for(size_t i = 0; i < original.size(); i++){
+        fprintf(file, "%s0x%02X,", i % 12 ? " " : "\n    ", original[i]);
+    }
+    fprintf(file, "\n};\n\n");
+
+    fprintf(file, "extern const aotimage_6502 %s;\n", name);
+    fprintf(file, "const aotimage_6502 %s = {BLOCKS, %zu, ORIGINAL};\n", name, blocks.size());
+    return (uint32_t)blocks.size();
+}
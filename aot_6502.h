@@ -0,0 +1,241 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       aot_6502.h
+ * @desc:       Header file for ahead of time translation of 6502 code to C++
+ * @note:       generate() translates the basic blocks found by dis_6502
+ *              into C++, one function per page, compiled into the host
+ *              program with the rest of its sources. Jumps between blocks
+ *              of a page become gotos. At run time aot_6502 dispatches by PC
+ *              and hands everything they cannot do exactly to the
+ *              interpreter: code it did not translate or that has been
+ *              overwritten since, computed jumps to such code, interrupts,
+ *              events due within a block, breakpoints, host calls, all
+ *              code while a read or write watchpoint is set and the
+ *              instructions that change I. Translated blocks run on the CPU's own
+ *              registers, so the two mix freely. A block that overwrites
+ *              its own later instructions still runs them as translated.
+ *****************************************************************************/
+
+#ifndef INC_6502_AOT_6502_H
+#define INC_6502_AOT_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include <vector>
+
+class aot_6502;
+class dis_6502;
+
+/*
+ *  aotfunc_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      The translated blocks of a page; runs from the block at pc
+ *              for as long as enter() allows and sets PC
+ *  @param:     rt - Runtime the blocks run on
+ *              pc - Start of the first block
+ */
+typedef void (*aotfunc_6502)(aot_6502& rt, word pc);
+
+/*
+ *  struct aotblock_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Table entry of a translated block
+ */
+struct aotblock_6502 {
+    word start;
+    uint32_t end;       // one past the last byte
+    uint32_t cycles;    // most cycles the block can take
+    uint32_t original;  // offset of the bytes it was translated from
+    aotfunc_6502 run;
+};
+
+/*
+ *  struct aotimage_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Everything generate() writes for one image
+ */
+struct aotimage_6502 {
+    const aotblock_6502* blocks;
+    uint32_t count;
+    const byte* original;
+};
+
+class aot_6502 {
+private:
+    // Machine Fields
+    cpu_6502& cpu;
+    mem_6502& memory;
+    const aotimage_6502& image;
+
+    // Dispatch Fields
+    std::vector<uint32_t> index;    // block + 1 starting at each address, 0 if none
+    std::vector<std::vector<uint32_t>> pageblocks;  // blocks overlapping each page
+    std::vector<byte> changed;      // per block, differs from its original
+
+    // Statistics Fields
+    uint64_t translated;    // instructions run by translated blocks
+    uint64_t interpreted;   // instructions run by the interpreter
+    uint64_t stale;         // block entries refused as overwritten
+
+    /*
+     *  unchanged()
+     *
+     *  @desc:      Compares a block on a written page with the bytes it was
+     *              translated from
+     * */
+    bool unchanged(const aotblock_6502& b);
+
+    /*
+     *  recheck()
+     *
+     *  @desc:      Compares every block overlapping a written page with its
+     *              original and marks the page clean, so later entries only
+     *              look up the result until the page is written again
+     *  @param:     addr - Address in the page
+     *  @return:    None
+     * */
+    void recheck(word addr);
+
+    /*
+     *  runnable()
+     *
+     *  @desc:      Checks that a block can run without the interpreter
+     *              noticing: nothing pending, no event or end of budget
+     *              within it, no read or write watchpoint anywhere, no
+     *              breakpoint or host call on its pages and its code
+     *              unchanged
+     *  @param:     b - Block at PC
+     *              budget - Cycles left
+     *              now - Current clock
+     *  @return:    true to run the translation
+     * */
+    bool runnable(const aotblock_6502& b, int32_t budget, uint64_t now);
+
+public:
+    // budget of the running block, counted down as it runs; getclock()
+    // follows it for devices called from the block
+    int32_t cycles;
+
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a runtime for the translations in code, which must have been
+    // generated from the code now in memory.
+    aot_6502(cpu_6502& processor, mem_6502& mem, const aotimage_6502& code);
+
+    // Releases the code pages flagged in memory.
+    ~aot_6502();
+
+    aot_6502(const aot_6502&) = delete;
+    aot_6502& operator=(const aot_6502&) = delete;
+
+    // Other Functions ---------------------------------------------------------
+    /*
+     *  execute()
+     *
+     *  @desc:      Runs the CPU as cpu_6502::execute() does, through the
+     *              translated blocks where it can. Cycle exact and shadow
+     *              stack builds only interpret, translated code reports no
+     *              bus cycles and no calls.
+     *  @param:     budget - Number of cycles to run
+     *  @return:    None
+     * */
+    void execute(int32_t budget);
+
+    /*
+     *  generate()
+     *
+     *  @desc:      Writes the C++ translation of an explored image. Blocks
+     *              stop before instructions left to the interpreter: BRK,
+     *              RTI, CLI, SEI, PLP and the undocumented opcodes other
+     *              than the NOPs.
+     *  @param:     dis - Disassembler after explore()
+     *              file - Output stream
+     *              name - Name of the aotimage_6502 to define
+     *  @return:    Number of blocks written
+     * */
+    static uint32_t generate(const dis_6502& dis, FILE* file, const char* name);
+
+    // Access functions --------------------------------------------------------
+    uint64_t gettranslated() const{ return translated; }
+    uint64_t getinterpreted() const{ return interpreted; }
+    uint64_t getstale() const{ return stale; }
+
+    // Translated code interface -----------------------------------------------
+    // Used by generated code only.
+    byte& a(){ return cpu.A; }
+    byte& x(){ return cpu.X; }
+    byte& y(){ return cpu.Y; }
+    byte& sp(){ return cpu.SP; }
+    void setpc(word pc){ cpu.PC = pc; }
+    byte status() const{ return cpu.getstatus(); }
+
+    bool c() const{ return cpu.C; }
+    bool z() const{ return cpu.Z; }
+    bool v() const{ return cpu.V; }
+    bool n() const{ return cpu.N; }
+    void setc(bool on){ cpu.C = on; }
+    void setd(bool on){ cpu.D = on; }
+    void setv(bool on){ cpu.V = on; }
+
+    bool enter(uint32_t block){
+        return !memory.watchhit() && runnable(image.blocks[block], cycles, cpu.endclock - cycles);
+    }
+    void retire(uint32_t insts){ translated += insts; }
+
+    void zn(byte val){ cpu.ZNSetStatus(val); }
+    void adc(byte val){ cpu.adc(val); }
+    void sbc(byte val){ cpu.sbc(val); }
+    void compare(byte reg, byte val){ cpu.compare(reg, val); }
+    void bit(byte val){ cpu.bit(val); }
+    byte asl(byte val){ return cpu.asl(val); }
+    byte lsr(byte val){ return cpu.lsr(val); }
+    byte rol(byte val){ return cpu.rol(val); }
+    byte ror(byte val){ return cpu.ror(val); }
+
+    byte read(word addr){ return memory.read(addr); }
+    void write(word addr, byte val){ memory.write(addr, val); }
+    word zpword(byte zp){ return memory.read(zp) | memory.read((byte)(zp + 1)) << 8; }
+    void push(byte val){ memory.write(0x0100 | cpu.SP--, val); }
+    byte pull(){ return memory.read(0x0100 | ++cpu.SP); }
+};
+
+
+// Inline Operations -------------------------------------------------------
+inline bool aot_6502::runnable(const aotblock_6502& b, int32_t budget, uint64_t now){
+    // the interpreter checks for interrupts, events and the end of the
+    // budget between any two instructions; a block only runs when none of
+    // them can happen inside it
+    if(cpu.pending || budget < (int32_t)b.cycles || now + b.cycles > *cpu.deadline){
+        return false;
+    }
+    // a read or write watchpoint stops the interpreter right after the
+    // instruction that hit it, which a block cannot do
+    if(memory.getwatchkinds() & (mem_6502::WATCH_READ | mem_6502::WATCH_WRITE)){
+        return false;
+    }
+    for(uint32_t page = b.start >> 8; page <= (b.end - 1) >> 8; page++){
+        word addr = (word)(page << 8);
+        if(memory.pageflag(addr) & (mem_6502::WATCH_EXEC | mem_6502::WATCH_BREAK
+                                    | mem_6502::WATCH_TRAP)){
+            return false;
+        }
+        if(memory.getdirty(addr)){
+            recheck(addr);
+        }
+    }
+    if(changed[&b - image.blocks]){
+        stale++;
+        return false;
+    }
+    return true;
+}
+
+#endif //INC_6502_AOT_6502_H
@@ -0,0 +1,599 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       bench_6502.cpp
+ * @desc:       Microbenchmarks and program benchmarks for the 6502 emulator
+ * @note:       Self contained, the output mimics Google Benchmark. Each
+ *              benchmark is run for a growing number of iterations until it
+ *              takes at least --min-time seconds.
+ *****************************************************************************/
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "sched_6502.h"
+#include "dis_6502.h"
+#include "perf_6502.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Keeps the compiler from discarding a value computed by a benchmark.
+template<typename T>
+static inline void donotoptimize(const T& val){
+    asm volatile("" : : "r,m"(val) : "memory");
+}
+
+/*
+ *  struct benchstate
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Passed to a benchmark body, which runs iters iterations and
+ *              reports the emulated cycles and instructions it executed
+ */
+struct benchstate {
+    uint64_t iters;
+    uint64_t cycles;        // emulated cycles executed, 0 if not applicable
+    uint64_t insts;         // emulated instructions executed
+};
+
+/*
+ *  struct benchmark
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      A named benchmark body
+ */
+struct benchmark {
+    std::string name;
+    std::function<void(benchstate&)> body;
+};
+
+// cycles executed per execute() call in the instruction benchmarks
+static constexpr int32_t SLICE = 100000;
+
+// code for the instruction benchmarks is placed here
+static constexpr word CODE = 0x0400;
+
+/******************************************************************************
+ *  load()
+ *
+ *  @desc:      Resets the machine, copies a program to addr and points PC
+ *              at it
+ *  @param:     cpu, mem - Machine
+ *              prog - Program bytes
+ *              addr - Load and start address
+ *  @return:    None
+ *****************************************************************************/
+static void load(cpu_6502& cpu, mem_6502& mem, const std::vector<byte>& prog, word addr){
+    cpu.reset(mem);
+    for(size_t i = 0; i < prog.size(); i++){
+        mem[addr + i] = prog[i];
+    }
+    regs_6502 regs = cpu.getregs();
+    regs.PC = addr;
+    cpu.setregs(regs);
+}
+
+/******************************************************************************
+ *  repeated()
+ *
+ *  @desc:      Builds a program repeating one instruction, followed by a
+ *              jump back to the start, so dispatch is dominated by it
+ *  @param:     inst - Encoded instruction
+ *  @return:    Program bytes for CODE
+ *****************************************************************************/
+static std::vector<byte> repeated(const std::vector<byte>& inst){
+    std::vector<byte> prog;
+    while(prog.size() + inst.size() + 3 < 0x400){
+        prog.insert(prog.end(), inst.begin(), inst.end());
+    }
+    prog.push_back(JMP_ABS);
+    prog.push_back(CODE & 0xFF);
+    prog.push_back(CODE >> 8);
+    return prog;
+}
+
+/******************************************************************************
+ *  runprogram()
+ *
+ *  @desc:      Benchmark body running a program in SLICE cycle steps
+ *  @param:     prog - Program bytes
+ *              addr - Load and start address
+ *              setup - Extra memory setup after loading, may be empty
+ *              fusion - Superinstructions on, see cpu_6502::setfusion()
+ *  @return:    Benchmark body
+ *****************************************************************************/
+static std::function<void(benchstate&)> runprogram(std::vector<byte> prog, word addr,
+        std::function<void(mem_6502&)> setup = nullptr, bool fusion = true){
+    return [prog, addr, setup, fusion](benchstate& st){
+        static mem_6502 mem;
+        cpu_6502 cpu;
+        load(cpu, mem, prog, addr);
+        cpu.setfusion(fusion);
+        if(setup){
+            setup(mem);
+        }
+        for(uint64_t i = 0; i < st.iters; i++){
+            cpu.execute(SLICE, mem);
+        }
+        st.cycles = cpu.getclock();
+        st.insts = cpu.getretired();
+    };
+}
+
+// cycles between events of each timer in program/sieve_timers
+static constexpr uint64_t TIMER_PERIOD = 1000;
+
+/*
+ *  struct benchtimer
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      A free running device timer driven by the event scheduler
+ */
+struct benchtimer {
+    sched_6502* events;
+    uint64_t fired;
+};
+
+// Timer event: counts and schedules the next expiry relative to this one.
+static void benchtick(void* ctx, uint64_t when, uint64_t now){
+    benchtimer* t = static_cast<benchtimer*>(ctx);
+    t->fired++;
+    t->events->schedule(when + TIMER_PERIOD, benchtick, t);
+    (void)now;
+}
+
+// Prime sieve over 0..255: flags at $0200, count of primes stored to $11,
+// then starts over.
+static const std::vector<byte> SIEVE = {
+    0xA2, 0x00,             // 0400  LDX #0
+    0xA9, 0x00,             // 0402  LDA #0
+    0x9D, 0x00, 0x02,       // 0404  STA $0200,X    clear flags
+    0xE8,                   // 0407  INX
+    0xD0, 0xFA,             // 0408  BNE $0404
+    0xA2, 0x02,             // 040A  LDX #2
+    0xBD, 0x00, 0x02,       // 040C  LDA $0200,X    outer loop
+    0xD0, 0x12,             // 040F  BNE $0423      composite
+    0x86, 0x10,             // 0411  STX $10
+    0x8A,                   // 0413  TXA
+    0x18,                   // 0414  CLC
+    0x65, 0x10,             // 0415  ADC $10        inner loop: j += i
+    0xB0, 0x0A,             // 0417  BCS $0423
+    0xA8,                   // 0419  TAY
+    0xA9, 0x01,             // 041A  LDA #1
+    0x99, 0x00, 0x02,       // 041C  STA $0200,Y    mark composite
+    0x98,                   // 041F  TYA
+    0x18,                   // 0420  CLC
+    0x90, 0xF2,             // 0421  BCC $0415
+    0xE8,                   // 0423  INX
+    0xE0, 0x10,             // 0424  CPX #16
+    0xD0, 0xE4,             // 0426  BNE $040C
+    0xA0, 0x00,             // 0428  LDY #0
+    0xA2, 0x02,             // 042A  LDX #2
+    0xBD, 0x00, 0x02,       // 042C  LDA $0200,X    count primes
+    0xD0, 0x01,             // 042F  BNE $0432
+    0xC8,                   // 0431  INY
+    0xE8,                   // 0432  INX
+    0xD0, 0xF7,             // 0433  BNE $042C
+    0x84, 0x11,             // 0435  STY $11
+    0x4C, 0x00, 0x04,       // 0437  JMP $0400
+};
+
+// Copies 4 KiB from $1000 to $2000 through (zp),Y pointers, then starts over.
+static const std::vector<byte> MEMCPY = {
+    0xA9, 0x00,             // 0400  LDA #$00
+    0x85, 0x00,             // 0402  STA $00
+    0x85, 0x02,             // 0404  STA $02
+    0xA9, 0x10,             // 0406  LDA #$10
+    0x85, 0x01,             // 0408  STA $01        src = $1000
+    0xA9, 0x20,             // 040A  LDA #$20
+    0x85, 0x03,             // 040C  STA $03        dst = $2000
+    0xA2, 0x10,             // 040E  LDX #16        pages
+    0xA0, 0x00,             // 0410  LDY #0
+    0xB1, 0x00,             // 0412  LDA ($00),Y
+    0x91, 0x02,             // 0414  STA ($02),Y
+    0xC8,                   // 0416  INY
+    0xD0, 0xF9,             // 0417  BNE $0412
+    0xE6, 0x01,             // 0419  INC $01
+    0xE6, 0x03,             // 041B  INC $03
+    0xCA,                   // 041D  DEX
+    0xD0, 0xF2,             // 041E  BNE $0412
+    0x4C, 0x00, 0x04,       // 0420  JMP $0400
+};
+
+// Adds and subtracts tables of BCD operands into running BCD totals, then
+// starts over. The first byte is patched to SED or CLD.
+static const std::vector<byte> BCD = {
+    CLD,                    // 0400  SED or CLD
+    0xA2, 0x00,             // 0401  LDX #0
+    0x18,                   // 0403  CLC
+    0xA5, 0x10,             // 0404  LDA $10
+    0x7D, 0x00, 0x30,       // 0406  ADC $3000,X
+    0x85, 0x10,             // 0409  STA $10
+    0xA5, 0x11,             // 040B  LDA $11
+    0x69, 0x00,             // 040D  ADC #0
+    0x85, 0x11,             // 040F  STA $11
+    0x38,                   // 0411  SEC
+    0xA5, 0x12,             // 0412  LDA $12
+    0xFD, 0x00, 0x31,       // 0414  SBC $3100,X
+    0x85, 0x12,             // 0417  STA $12
+    0xE8,                   // 0419  INX
+    0xD0, 0xE7,             // 041A  BNE $0403
+    0x4C, 0x01, 0x04,       // 041C  JMP $0401
+};
+
+// Multiplies every Y by Y ^ $5A through the subroutine at $0500, then
+// ends on a jump to itself.
+static const std::vector<byte> MULDRIVER = {
+    0xA0, 0x00,             // 0400  LDY #0
+    0x84, 0xF1,             // 0402  STY $F1
+    0x98,                   // 0404  TYA
+    0x49, 0x5A,             // 0405  EOR #$5A
+    0x85, 0xF2,             // 0407  STA $F2
+    0x20, 0x00, 0x05,       // 0409  JSR $0500
+    0xC8,                   // 040C  INY
+    0xD0, 0xF3,             // 040D  BNE $0402
+    0x4C, 0x0F, 0x04,       // 040F  JMP $040F
+};
+
+// Shift and add multiply of $F1 by $F2: low byte to $F1, high byte to $F3
+// and A.
+static const std::vector<byte> MULTIPLY = {
+    0xA9, 0x00,             // 0500  LDA #0
+    0xA2, 0x08,             // 0502  LDX #8
+    0x46, 0xF1,             // 0504  LSR $F1
+    0x90, 0x03,             // 0506  BCC $050B
+    0x18,                   // 0508  CLC
+    0x65, 0xF2,             // 0509  ADC $F2
+    0x6A,                   // 050B  ROR A
+    0x66, 0xF1,             // 050C  ROR $F1
+    0xCA,                   // 050E  DEX
+    0xD0, 0xF5,             // 050F  BNE $0506
+    0x85, 0xF3,             // 0511  STA $F3
+    0x60,                   // 0513  RTS
+};
+
+// Cycles charged for the native multiply, as a hardware multiplier might
+static constexpr uint32_t MULTIPLY_CYCLES = 12;
+
+// Host call standing in for MULTIPLY, leaving A, X, C, Z and N as it does.
+static bool hostmultiply(void* ctx, regs_6502& regs, mem_6502& mem){
+    byte m = mem[0xF1];
+    word product = (word)(m * mem[0xF2]);
+    mem[0xF1] = (byte)product;
+    mem[0xF3] = (byte)(product >> 8);
+    regs.A = (byte)(product >> 8);
+    regs.X = 0;
+    regs.P = (byte)((regs.P & ~0x83) | 0x02 | (m >> 7));
+    (void)ctx;
+    return true;
+}
+
+/******************************************************************************
+ *  runmultiply()
+ *
+ *  @desc:      Benchmark body running MULDRIVER once per iteration, 256
+ *              multiplies, stopped by an execute watchpoint on its end
+ *  @param:     native - Trap the subroutine with hostmultiply()
+ *  @return:    Benchmark body
+ *****************************************************************************/
+static std::function<void(benchstate&)> runmultiply(bool native){
+    return [native](benchstate& st){
+        static mem_6502 mem;
+        cpu_6502 cpu;
+        load(cpu, mem, MULDRIVER, 0x0400);
+        for(size_t i = 0; i < MULTIPLY.size(); i++){
+            mem[0x0500 + i] = MULTIPLY[i];
+        }
+        if(native){
+            cpu.addtrap(0x0500, hostmultiply, nullptr, MULTIPLY_CYCLES, mem);
+        }
+        int end = mem.addwatch(0x040F, 0x040F, mem_6502::WATCH_EXEC);
+        for(uint64_t i = 0; i < st.iters; i++){
+            regs_6502 regs = cpu.getregs();
+            regs.PC = 0x0400;
+            cpu.setregs(regs);
+            while(cpu.getregs().PC != 0x040F){
+                cpu.execute(SLICE, mem);
+            }
+        }
+        mem.delwatch(end);
+        if(native){
+            cpu.deltrap(0x0500, mem);
+        }
+        st.cycles = cpu.getclock();
+        st.insts = cpu.getretired();
+    };
+}
+
+/******************************************************************************
+ *  registerall()
+ *
+ *  @desc:      Builds the list of benchmarks
+ *  @param:     klaus - Path of the functional test image, or nullptr
+ *  @return:    Benchmarks in run order
+ *****************************************************************************/
+static std::vector<benchmark> registerall(const char* klaus){
+    std::vector<benchmark> list;
+
+    // instruction dispatch and addressing modes, one instruction repeated
+    static const struct { const char* name; std::vector<byte> inst; } insts[] = {
+        {"dispatch/NOP",        {NOP}},
+        {"dispatch/INX",        {INX}},
+        {"dispatch/CLC",        {CLC}},
+        {"mode/immediate",      {LDA_IM, 0x42}},
+        {"mode/zeropage",       {LDA_ZP, 0x42}},
+        {"mode/zeropage_x",     {LDA_ZPX, 0x42}},
+        {"mode/absolute",       {LDA_ABS, 0x00, 0x30}},
+        {"mode/absolute_x",     {LDA_ABSX, 0x00, 0x30}},
+        {"mode/absolute_y",     {LDA_ABSY, 0x00, 0x30}},
+        {"mode/indirect_x",     {LDA_INDX, 0x80}},
+        {"mode/indirect_y",     {LDA_INDY, 0x80}},
+        {"mode/store_abs",      {STA_ABS, 0x00, 0x30}},
+        {"mode/rmw_zeropage",   {INC_ZP, 0x42}},
+        {"mode/rmw_absolute_x", {ASL_ABSX, 0x00, 0x30}},
+        {"mode/adc_binary",     {ADC_IM, 0x01}},
+        {"mode/branch_taken",   {BCC, 0x00}},
+        {"mode/stack_pha_pla",  {PHA, PLA}},
+        {"mode/jsr_rts",        {JSR, 0x00, 0x3F}},
+    };
+    for(const auto& in : insts){
+        std::function<void(mem_6502&)> setup = [](mem_6502& mem){
+            mem[0x80] = 0x00;       // pointer for the indirect modes
+            mem[0x81] = 0x30;
+            mem[0x3F00] = RTS;      // subroutine for jsr_rts
+        };
+        list.push_back({in.name, runprogram(repeated(in.inst), CODE, setup)});
+    }
+
+    // memory access
+    list.push_back({"mem/read", [](benchstate& st){
+        static mem_6502 mem;
+        byte sum = 0;
+        for(uint64_t i = 0; i < st.iters; i++){
+            sum += mem.read((word)(i * 97));
+        }
+        donotoptimize(sum);
+    }});
+    list.push_back({"mem/write", [](benchstate& st){
+        static mem_6502 mem;
+        for(uint64_t i = 0; i < st.iters; i++){
+            mem.write((word)(i * 97), (byte)i);
+        }
+        donotoptimize(mem[0]);
+    }});
+    list.push_back({"mem/read_watched_page", [](benchstate& st){
+        // a watchpoint elsewhere on the page forces the slow path
+        static mem_6502 mem;
+        mem.clearwatches();
+        mem.addwatch(0x12FF, 0x12FF, mem_6502::WATCH_READ);
+        byte sum = 0;
+        for(uint64_t i = 0; i < st.iters; i++){
+            sum += mem.read(0x1200 | (i & 0x7F));
+        }
+        donotoptimize(sum);
+    }});
+    list.push_back({"cpu/fetchword", [](benchstate& st){
+        static mem_6502 mem;
+        cpu_6502 cpu;
+        int32_t cycles = 0;
+        word sum = 0;
+        for(uint64_t i = 0; i < st.iters; i++){
+            sum += cpu.fetchword(cycles, mem);
+        }
+        donotoptimize(sum);
+    }});
+    list.push_back({"cpu/reset", [](benchstate& st){
+        static mem_6502 mem;
+        cpu_6502 cpu;
+        for(uint64_t i = 0; i < st.iters; i++){
+            cpu.reset(mem);
+            donotoptimize(mem);
+        }
+    }});
+    list.push_back({"machine/snapshot_restore", [](benchstate& st){
+        static mem_6502 mem;
+        static mem_6502 saved;
+        cpu_6502 cpu;
+        cpu_6502 savedcpu;
+        for(uint64_t i = 0; i < st.iters; i++){
+            savedcpu = cpu;
+            saved = mem;
+            cpu = savedcpu;
+            mem = saved;
+            donotoptimize(mem);
+        }
+    }});
+
+    // static analysis of a full image; random bytes decode to dense,
+    // heavily overlapping code, the worst case for explore()
+    list.push_back({"dis/explore_64k", [](benchstate& st){
+        static mem_6502 mem;
+        uint32_t seed = 1;
+        for(uint32_t addr = 0; addr < 0x10000; addr++){
+            seed = seed * 1103515245 + 12345;
+            mem[addr] = (byte)(seed >> 16);
+        }
+        for(uint64_t i = 0; i < st.iters; i++){
+            std::unique_ptr<dis_6502> dis(new dis_6502(mem));
+            dis->addvectors();
+            for(uint32_t addr = 0; addr < 0x10000; addr += 0x100){
+                dis->addentry((word)addr);
+            }
+            donotoptimize(dis->explore());
+        }
+    }});
+
+    // programs
+    list.push_back({"program/sieve", runprogram(SIEVE, 0x0400)});
+    list.push_back({"program/memcpy", runprogram(MEMCPY, 0x0400)});
+    list.push_back({"program/sieve_unfused", runprogram(SIEVE, 0x0400, nullptr, false)});
+    list.push_back({"program/memcpy_unfused", runprogram(MEMCPY, 0x0400, nullptr, false)});
+    for(bool decimal : {false, true}){
+        std::vector<byte> prog = BCD;
+        prog[0] = decimal ? SED : CLD;
+        list.push_back({decimal ? "program/bcd_decimal" : "program/bcd_binary",
+                        runprogram(prog, 0x0400, [](mem_6502& mem){
+            // varied operands keep the adjust branches unpredictable
+            uint32_t seed = 12345;
+            for(word i = 0; i < 0x200; i++){
+                seed = seed * 1103515245 + 12345;
+                mem[0x3000 + i] = (byte)((((seed >> 16) % 10) << 4) | ((seed >> 24) % 10));
+            }
+        })});
+    }
+    list.push_back({"program/multiply", runmultiply(false)});
+    list.push_back({"program/multiply_native", runmultiply(true)});
+    list.push_back({"program/sieve_timers", [](benchstate& st){
+        // the sieve with four devices each firing every TIMER_PERIOD
+        // cycles, rescheduling themselves like a free running timer
+        static mem_6502 mem;
+        cpu_6502 cpu;
+        sched_6502 events;
+        benchtimer timers[4];
+        load(cpu, mem, SIEVE, 0x0400);
+        cpu.attach(&events);
+        for(uint64_t i = 0; i < 4; i++){
+            timers[i] = {&events, 0};
+            events.schedule(TIMER_PERIOD + i, benchtick, &timers[i]);
+        }
+        for(uint64_t i = 0; i < st.iters; i++){
+            cpu.execute(SLICE, mem);
+        }
+        donotoptimize(timers);
+        st.cycles = cpu.getclock();
+        st.insts = cpu.getretired();
+    }});
+
+    if(klaus != nullptr){
+        // Klaus Dormann's functional test, assembled for load at $0000 and
+        // start at $0400; runs until it traps on a JMP * or branch to self
+        std::string path = klaus;
+        list.push_back({"program/klaus_functional", [path](benchstate& st){
+            static mem_6502 mem;
+            cpu_6502 cpu;
+            for(uint64_t i = 0; i < st.iters; i++){
+                cpu.reset(mem);
+                if(!mem.loadfile(path.c_str(), 0x0000)){
+                    exit(EXIT_FAILURE);
+                }
+                regs_6502 regs = cpu.getregs();
+                regs.PC = 0x0400;
+                cpu.setregs(regs);
+                word last;
+                do {
+                    last = cpu.getregs().PC;
+                    cpu.execute(1, mem);
+                } while(cpu.getregs().PC != last);
+            }
+            st.cycles = cpu.getclock();
+            st.insts = cpu.getretired();
+        }});
+    }
+    return list;
+}
+
+/******************************************************************************
+ *  main()
+ *
+ *  @desc:      Runs the benchmarks whose name contains the filter
+ *  @param:     argc, argv - [--filter SUBSTR] [--min-time SEC]
+ *                           [--klaus IMAGE] [--perf]
+ *  @return:    EXIT_SUCCESS or EXIT_FAILURE
+ *****************************************************************************/
+int main(int argc, char** argv){
+    const char* filter = "";
+    const char* klaus = nullptr;
+    double mintime = 0.5;
+    bool perf = false;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc){
+            filter = argv[++i];
+        } else if(strcmp(argv[i], "--min-time") == 0 && i + 1 < argc){
+            mintime = atof(argv[++i]);
+        } else if(strcmp(argv[i], "--klaus") == 0 && i + 1 < argc){
+            klaus = argv[++i];
+        } else if(strcmp(argv[i], "--perf") == 0){
+            perf = true;
+        } else {
+            fprintf(stderr, "usage: %s [--filter SUBSTR] [--min-time SEC] [--klaus IMAGE] "
+                            "[--perf]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // host counters read around each timed run with --perf
+    perf_6502 counters;
+    if(perf && !counters.open()){
+        fprintf(stderr, "ERROR: No performance counter available\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-28s %14s %12s %10s %12s\n", "Benchmark", "Time", "Iterations", "MHz", "ns/inst");
+    printf("%s\n", std::string(80, '-').c_str());
+
+    for(const benchmark& b : registerall(klaus)){
+        if(b.name.find(filter) == std::string::npos){
+            continue;
+        }
+
+        // grow the iteration count until the run is long enough to time
+        benchstate st{1, 0, 0};
+        double secs;
+        uint64_t before[perf_6502::EVENTS], after[perf_6502::EVENTS];
+        for(;;){
+            st.cycles = st.insts = 0;
+            if(perf){
+                counters.sample(before);
+            }
+            auto start = std::chrono::steady_clock::now();
+            b.body(st);
+            secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if(perf){
+                counters.sample(after);
+            }
+            if(secs >= mintime || st.iters >= (1ULL << 40)){
+                break;
+            }
+            double scale = secs > 0 ? 1.4 * mintime / secs : 10.0;
+            uint64_t next = (uint64_t)(st.iters * (scale < 10.0 ? scale : 10.0));
+            st.iters = next > st.iters ? next : st.iters + 1;
+        }
+
+        double periter = secs * 1e9 / st.iters;
+        const char* unit = "ns";
+        double shown = periter;
+        if(shown >= 1e6){
+            shown /= 1e6;
+            unit = "ms";
+        } else if(shown >= 1e3){
+            shown /= 1e3;
+            unit = "us";
+        }
+        printf("%-28s %11.2f %-2s %12llu", b.name.c_str(), shown, unit,
+               (unsigned long long)st.iters);
+        if(st.cycles > 0){
+            printf(" %10.2f %12.3f", st.cycles / secs / 1e6, secs * 1e9 / st.insts);
+        }
+        printf("\n");
+        if(perf){
+            // per emulated instruction where there are any, else per iteration
+            double per = (double)(st.insts > 0 ? st.insts : st.iters);
+            printf("    %s:", st.insts > 0 ? "per inst" : "per iter");
+            for(uint32_t e = 0; e < perf_6502::EVENTS; e++){
+                if(counters.available(e)){
+                    printf(" %.3f %s", (double)(after[e] - before[e]) / per,
+                           perf_6502::eventname(e));
+                }
+            }
+            printf("\n");
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -9,6 +9,17 @@
  *****************************************************************************/
 
 #include "cpu_6502.h"
+#include "debug_6502.h"
+
+// deadline of a cpu without a scheduler
+static const uint64_t NO_DEADLINE = sched_6502::NEVER;
+
+// constant ORed into A by the unstable ANE and LXA, as most NMOS parts and
+// the single step vectors do
+static constexpr byte UNSTABLE_MAGIC = 0xEE;
+
+// longest idle loop fastforward() looks at, in bytes and in instructions
+static constexpr int IDLE_LOOP = 16;
 
 // Class Constructors & Destructors ----------------------------------------
 
@@ -18,6 +29,34 @@ cpu_6502::cpu_6502(){
     SP = 0xFF;
     C = Z = I = D = B = V = N = 0;
     A = X = Y = 0x00;
+    clock = 0;
+    retired = 0;
+    left = nullptr;
+    endclock = 0;
+    watchpc = NO_PC;
+    stopped = STOP_NONE;
+    irqlines = 0;
+    nmiline = nmiedge = false;
+    polldelay = false;
+    ipoll = 0;
+    pending = false;
+    debugger = nullptr;
+    sched = nullptr;
+    deadline = &NO_DEADLINE;
+    fusion = true;
+    idleskip = false;
+    skipped = 0;
+    jammed = false;
+    jampolicy = JAM_EMULATE;
+    trapcalls = 0;
+#ifdef CYCLE_EXACT_6502
+    bushook = nullptr;
+    busctx = nullptr;
+    buscycle = 0;
+#endif
+#ifdef SHADOW_STACK_6502
+    instpc = 0;
+#endif
 }
 
 // Manipulation procedures -------------------------------------------------
@@ -34,6 +73,15 @@ void cpu_6502::reset(mem_6502& memory){
     SP = 0xFF;  // decremented 3 times from 0xFF for three fake push operations
     C = Z = I = D = B = V = N = 0;
     A = X = Y = 0x00;
+    watchpc = NO_PC;
+    stopped = STOP_NONE;
+    nmiedge = false;
+    polldelay = false;
+    jammed = false;
+    updatepending();
+#ifdef SHADOW_STACK_6502
+    shadow.clear();
+#endif
     memory.init();
 }
 
@@ -46,8 +94,264 @@ void cpu_6502::LDASetStatus(){
     Z = (A == 0);               // set if A = 0
     N = ((A >> 7) & 0b1) == 1;     }
 
+/*
+ *  setregs()
+ *
+ *  @desc:      Loads all programmer visible registers
+ *  @param:     regs - New register values
+ *  @return:    None
+ * */
+void cpu_6502::setregs(const regs_6502& regs){
+    PC = regs.PC;
+    SP = regs.SP;
+    A = regs.A;
+    X = regs.X;
+    Y = regs.Y;
+    setstatus(regs.P);
+}
+
+/*
+ *  setstatus()
+ *
+ *  @desc:      Unpacks the status register into the flag bits
+ *  @param:     status - Packed NV1BDIZC status byte
+ *  @return:    None
+ * */
+void cpu_6502::setstatus(byte status){
+    C = (status & FLAG_C) != 0;
+    Z = (status & FLAG_Z) != 0;
+    I = (status & FLAG_I) != 0;
+    D = (status & FLAG_D) != 0;
+    B = (status & FLAG_B) != 0;
+    V = (status & FLAG_V) != 0;
+    N = (status & FLAG_N) != 0;
+    updatepending();
+}
+
+/*
+ *  setirq()
+ *
+ *  @desc:      Drives the level sensitive IRQ line
+ *  @param:     lines - Bits of the devices changing their output
+ *              on - true to assert
+ *  @return:    None
+ * */
+void cpu_6502::setirq(uint32_t lines, bool on){
+    irqlines = on ? irqlines | lines : irqlines & ~lines;
+    updatepending();
+}
+
+/*
+ *  setnmi()
+ *
+ *  @desc:      Drives the edge sensitive NMI line
+ *  @param:     on - true to assert
+ *  @return:    None
+ * */
+void cpu_6502::setnmi(bool on){
+    if(on && !nmiline){
+        nmiedge = true;
+    }
+    nmiline = on;
+    updatepending();
+}
+
+/*
+ *  attach()
+ *
+ *  @desc:      Attaches a debugger consulted at breakpoint addresses
+ *  @param:     dbg - Debugger, or nullptr to detach
+ *  @return:    None
+ * */
+void cpu_6502::attach(debug_6502* dbg){
+    debugger = dbg;
+}
+
+/*
+ *  attach()
+ *
+ *  @desc:      Attaches an event scheduler
+ *  @param:     events - Scheduler, or nullptr to detach
+ *  @return:    None
+ * */
+void cpu_6502::attach(sched_6502* events){
+    sched = events;
+    deadline = events != nullptr ? &events->deadline() : &NO_DEADLINE;
+}
+
+/*
+ *  setidleskip()
+ *
+ *  @desc:      Turns idle loop fast-forwarding on or off
+ *  @param:     on - true to fast-forward
+ *  @return:    None
+ * */
+void cpu_6502::setidleskip(bool on){
+#ifdef CYCLE_EXACT_6502
+    (void)on;
+#else
+    idleskip = on;
+#endif
+}
+
+/*
+ *  setfusion()
+ *
+ *  @desc:      Turns superinstructions on or off
+ *  @param:     on - true to fuse
+ *  @return:    None
+ * */
+void cpu_6502::setfusion(bool on){
+    fusion = on;
+}
+
 
 // Access functions --------------------------------------------------------
+/*
+ *  getregs()
+ *
+ *  @desc:      Returns a copy of all programmer visible registers
+ * */
+regs_6502 cpu_6502::getregs() const{
+    return {PC, SP, A, X, Y, getstatus()};
+}
+
+/*
+ *  getstatus()
+ *
+ *  @desc:      Returns the flag bits packed as NV1BDIZC
+ * */
+byte cpu_6502::getstatus() const{
+    return (N ? FLAG_N : 0) | (V ? FLAG_V : 0) | FLAG_U | (B ? FLAG_B : 0)
+         | (D ? FLAG_D : 0) | (I ? FLAG_I : 0) | (Z ? FLAG_Z : 0)
+         | (C ? FLAG_C : 0);
+}
+
+/*
+ *  getstop()
+ *
+ *  @desc:      Returns why the last execute() returned early, STOP_NONE
+ *              if it ran out of cycles
+ * */
+byte cpu_6502::getstop() const{
+    return stopped;
+}
+
+/*
+ *  setjam()
+ *
+ *  @desc:      Chooses what a JAM opcode does
+ *  @param:     policy - JAM_EMULATE, JAM_TRAP or JAM_HALT
+ *  @return:    None
+ * */
+void cpu_6502::setjam(byte policy){
+    jampolicy = policy;
+}
+
+/*
+ *  unjam()
+ *
+ *  @desc:      Releases a CPU held by a JAM opcode
+ *  @return:    None
+ * */
+void cpu_6502::unjam(){
+    jammed = false;
+    updatepending();
+}
+
+/*
+ *  addtrap()
+ *
+ *  @desc:      Runs call instead of the subroutine at addr
+ *  @param:     addr - Entry point of the subroutine
+ *              call - Native implementation
+ *              ctx - Passed through to call
+ *              cycles - Cycles to charge per call, RTS included
+ *              memory - 6502 memory, whose page at addr is flagged
+ *  @return:    None
+ * */
+void cpu_6502::addtrap(word addr, hostcall_6502 call, void* ctx, uint32_t cycles,
+                       mem_6502& memory){
+    if(traps.find(addr) == traps.end()){
+        memory.marktrap(addr, true);
+    }
+    traps[addr] = {call, ctx, cycles};
+}
+
+/*
+ *  deltrap()
+ *
+ *  @desc:      Removes the trap at addr
+ *  @param:     addr - Entry point given to addtrap()
+ *              memory - 6502 memory
+ *  @return:    false if there was none
+ * */
+bool cpu_6502::deltrap(word addr, mem_6502& memory){
+    if(traps.erase(addr) == 0){
+        return false;
+    }
+    memory.marktrap(addr, false);
+    return true;
+}
+
+/*
+ *  gettrapcalls()
+ *
+ *  @desc:      Returns the number of host calls run in place of 6502 code
+ * */
+uint64_t cpu_6502::gettrapcalls() const{
+    return trapcalls;
+}
+
+/*
+ *  getjammed()
+ *
+ *  @desc:      Returns true while a JAM opcode holds the CPU
+ * */
+bool cpu_6502::getjammed() const{
+    return jammed;
+}
+
+/*
+ *  getfusion()
+ *
+ *  @desc:      Returns true while superinstructions are on
+ * */
+bool cpu_6502::getfusion() const{
+    return fusion;
+}
+
+/*
+ *  getskipped()
+ *
+ *  @desc:      Returns the number of cycles fast-forwarded over idle loops
+ * */
+uint64_t cpu_6502::getskipped() const{
+    return skipped;
+}
+
+#ifdef SHADOW_STACK_6502
+/*
+ *  getshadow()
+ *
+ *  @desc:      Returns the shadow call stack
+ * */
+shadow_6502& cpu_6502::getshadow(){
+    return shadow;
+}
+
+const shadow_6502& cpu_6502::getshadow() const{
+    return shadow;
+}
+#endif
+
+#ifdef CYCLE_EXACT_6502
+void cpu_6502::setbushook(bushook_6502 hook, void* ctx){
+    bushook = hook;
+    busctx = ctx;
+}
+#endif
+
 /*
  *  fetchbyte()
  *
@@ -56,8 +360,9 @@ void cpu_6502::LDASetStatus(){
  *              memory - 6502 memory
  *  @return:    Fetched byte
  * */
-byte cpu_6502::fetchbyte(uint32_t& cycles, mem_6502& memory){
-    byte data = memory[PC];
+byte cpu_6502::fetchbyte(int32_t& cycles, mem_6502& memory){
+    byte data = memory.fetch(PC);
+    bus(PC, data, BUS_FETCH);
     PC++;
     cycles--;
     return data;
@@ -71,13 +376,10 @@ byte cpu_6502::fetchbyte(uint32_t& cycles, mem_6502& memory){
  *              memory - 6502 memory
  *  @return:    Fetched byte
  * */
-word cpu_6502::fetchword(uint32_t& cycles, mem_6502& memory){
+word cpu_6502::fetchword(int32_t& cycles, mem_6502& memory){
     // 6502 is little endian
-    word data = memory[PC];
-    PC++;
-    data |= (memory[PC] << 8);
-    PC++;
-    cycles -= 2;
+    word data = fetchbyte(cycles, memory);
+    data |= (fetchbyte(cycles, memory) << 8);
     return data;
 }
 
@@ -89,12 +391,484 @@ word cpu_6502::fetchword(uint32_t& cycles, mem_6502& memory){
  *              memory - 6502 memory
  *  @return:    Read byte
  * */
-byte cpu_6502::readbyte(uint32_t& cycles, uint32_t addr, mem_6502& memory){
-    byte data = memory[addr];
+byte cpu_6502::readbyte(int32_t& cycles, uint32_t addr, mem_6502& memory){
+    byte data = memory.read(addr);
+    bus(addr, data, BUS_READ);
     cycles--;
     return data;
 }
 
+/*
+ *  readword()
+ *
+ *  @desc:      Reads a little endian word from memory
+ *  @param:     cycles - Number of cycles to read based on instruction
+ *              addr - Address of the low byte
+ *              memory - 6502 memory
+ *  @return:    Read word
+ * */
+word cpu_6502::readword(int32_t& cycles, uint32_t addr, mem_6502& memory){
+    word data = readbyte(cycles, addr, memory);
+    data |= readbyte(cycles, (addr + 1) & 0xFFFF, memory) << 8;
+    return data;
+}
+
+/*
+ *  writebyte()
+ *
+ *  @desc:      Writes a single byte to memory
+ *  @param:     cycles - Number of cycles to write based on instruction
+ *              addr - Address to write to
+ *              val - Value to write
+ *              memory - 6502 memory
+ *  @return:    None
+ * */
+void cpu_6502::writebyte(int32_t& cycles, uint32_t addr, byte val, mem_6502& memory){
+    memory.write(addr, val);
+    bus(addr, val, BUS_WRITE);
+    cycles--;
+}
+
+/*
+ *  dummyread()
+ *
+ *  @desc:      Spends a cycle on a read whose value the CPU discards. The
+ *              read only reaches memory in cycle exact builds, where it can
+ *              have side effects on devices.
+ *  @param:     cycles - Number of cycles left
+ *              addr - Address the CPU puts on the bus
+ *              memory - 6502 memory
+ *  @return:    None
+ * */
+void cpu_6502::dummyread(int32_t& cycles, uint32_t addr, mem_6502& memory){
+#ifdef CYCLE_EXACT_6502
+    bus(addr, memory.read(addr), BUS_DUMMY_READ);
+#else
+    (void)addr;
+    (void)memory;
+#endif
+    cycles--;
+}
+
+/*
+ *  dummywrite()
+ *
+ *  @desc:      Spends a cycle on the write of an unmodified value that
+ *              read-modify-write instructions do before the real write.
+ *              Only reaches memory in cycle exact builds.
+ *  @param:     cycles - Number of cycles left
+ *              addr - Address written
+ *              val - Unmodified value
+ *              memory - 6502 memory
+ *  @return:    None
+ * */
+void cpu_6502::dummywrite(int32_t& cycles, uint32_t addr, byte val, mem_6502& memory){
+#ifdef CYCLE_EXACT_6502
+    memory.write(addr, val);
+    bus(addr, val, BUS_DUMMY_WRITE);
+#else
+    (void)addr;
+    (void)val;
+    (void)memory;
+#endif
+    cycles--;
+}
+
+/*
+ *  pushbyte() / pushword()
+ *
+ *  @desc:      Pushes onto the stack in page 1, high byte first for
+ *              words, decrementing SP
+ *  @param:     cycles - Number of cycles to push based on instruction
+ *              val - Value to push
+ *              memory - 6502 memory
+ *  @return:    None
+ * */
+void cpu_6502::pushbyte(int32_t& cycles, byte val, mem_6502& memory){
+#ifdef SHADOW_STACK_6502
+    if(SP == 0x00){
+        shadow.fault(shadow_6502::FAULT_OVERFLOW, instpc, SP);
+    }
+#endif
+    writebyte(cycles, 0x0100 | SP, val, memory);
+    SP--;
+}
+
+void cpu_6502::pushword(int32_t& cycles, word val, mem_6502& memory){
+    pushbyte(cycles, val >> 8, memory);
+    pushbyte(cycles, val & 0xFF, memory);
+}
+
+/*
+ *  popbyte() / popword()
+ *
+ *  @desc:      Pulls from the stack in page 1, incrementing SP
+ *  @param:     cycles - Number of cycles to pull based on instruction
+ *              memory - 6502 memory
+ *  @return:    Pulled value
+ * */
+byte cpu_6502::popbyte(int32_t& cycles, mem_6502& memory){
+#ifdef SHADOW_STACK_6502
+    if(SP == 0xFF){
+        shadow.fault(shadow_6502::FAULT_UNDERFLOW, instpc, SP);
+    }
+#endif
+    SP++;
+    return readbyte(cycles, 0x0100 | SP, memory);
+}
+
+word cpu_6502::popword(int32_t& cycles, mem_6502& memory){
+    word data = popbyte(cycles, memory);
+    data |= popbyte(cycles, memory) << 8;
+    return data;
+}
+
+/*
+ *  getclock()
+ *
+ *  @desc:      Returns the number of cycles executed since construction
+ * */
+uint64_t cpu_6502::getclock() const{
+    return left != nullptr ? endclock - *left : clock;
+}
+
+/*
+ *  getretired()
+ *
+ *  @desc:      Returns the number of instructions executed since
+ *              construction
+ * */
+uint64_t cpu_6502::getretired() const{
+    return retired;
+}
+
+// Addressing modes --------------------------------------------------------
+word cpu_6502::addrzp(int32_t& cycles, mem_6502& memory){
+    return fetchbyte(cycles, memory);
+}
+
+word cpu_6502::addrzpx(int32_t& cycles, mem_6502& memory){
+    byte zpaddr = fetchbyte(cycles, memory);
+    dummyread(cycles, zpaddr, memory);
+    zpaddr += X;    // wraps within the zero page
+    return zpaddr;
+}
+
+word cpu_6502::addrzpy(int32_t& cycles, mem_6502& memory){
+    byte zpaddr = fetchbyte(cycles, memory);
+    dummyread(cycles, zpaddr, memory);
+    zpaddr += Y;
+    return zpaddr;
+}
+
+word cpu_6502::addrabs(int32_t& cycles, mem_6502& memory){
+    return fetchword(cycles, memory);
+}
+
+word cpu_6502::addrabsx(int32_t& cycles, mem_6502& memory, bool write){
+    word base = fetchword(cycles, memory);
+    word addr = base + X;
+    if(write || (base ^ addr) & 0xFF00){
+        // the low byte is added first, so the CPU reads the address before
+        // the carry into the high byte is fixed up
+        dummyread(cycles, (base & 0xFF00) | (addr & 0xFF), memory);
+    }
+    return addr;
+}
+
+word cpu_6502::addrabsy(int32_t& cycles, mem_6502& memory, bool write){
+    word base = fetchword(cycles, memory);
+    word addr = base + Y;
+    if(write || (base ^ addr) & 0xFF00){
+        dummyread(cycles, (base & 0xFF00) | (addr & 0xFF), memory);
+    }
+    return addr;
+}
+
+word cpu_6502::addrindx(int32_t& cycles, mem_6502& memory){
+    byte zpaddr = fetchbyte(cycles, memory);
+    dummyread(cycles, zpaddr, memory);
+    zpaddr += X;
+    word addr = readbyte(cycles, zpaddr, memory);
+    addr |= readbyte(cycles, (byte)(zpaddr + 1), memory) << 8;
+    return addr;
+}
+
+word cpu_6502::addrindy(int32_t& cycles, mem_6502& memory, bool write){
+    byte zpaddr = fetchbyte(cycles, memory);
+    word base = readbyte(cycles, zpaddr, memory);
+    base |= readbyte(cycles, (byte)(zpaddr + 1), memory) << 8;
+    word addr = base + Y;
+    if(write || (base ^ addr) & 0xFF00){
+        dummyread(cycles, (base & 0xFF00) | (addr & 0xFF), memory);
+    }
+    return addr;
+}
+
+// Operations --------------------------------------------------------------
+void cpu_6502::adc(byte val){
+    uint32_t sum = A + val + C;
+    if(!D){
+        V = ((~(A ^ val) & (A ^ sum)) >> 7) & 0b1;
+        C = sum > 0xFF;
+        A = sum & 0xFF;
+        ZNSetStatus(A);
+        return;
+    }
+
+    // NMOS decimal mode: Z comes from the binary sum, N and V from the
+    // intermediate result after the low nibble adjust. The adjusts are
+    // multiplied in rather than branched on; BCD operands are too random
+    // for a branch predictor.
+    uint32_t lo = (A & 0x0F) + (val & 0x0F) + C;
+    lo += (lo > 0x09) * 0x06;
+    uint32_t hi = (A >> 4) + (val >> 4) + (lo > 0x0F);
+    Z = (sum & 0xFF) == 0;
+    N = (hi >> 3) & 0b1;
+    V = ((~(A ^ val) & (A ^ (hi << 4))) >> 7) & 0b1;
+    hi += (hi > 0x09) * 0x06;
+    C = hi > 0x0F;
+    A = ((hi << 4) | (lo & 0x0F)) & 0xFF;
+}
+
+void cpu_6502::sbc(byte val){
+    uint32_t diff = A - val - !C;
+    byte result = diff & 0xFF;
+
+    // flags always follow the binary subtraction on the NMOS 6502; the
+    // decimal result is always computed and selected without a branch
+    uint32_t lo = (A & 0x0F) - (val & 0x0F) - !C;
+    uint32_t borrow = (lo >> 4) & 0b1;
+    uint32_t hi = (A >> 4) - (val >> 4) - borrow;
+    lo -= borrow * 0x06;
+    hi -= ((hi >> 4) & 0b1) * 0x06;
+    byte decimal = ((hi << 4) | (lo & 0x0F)) & 0xFF;
+
+    V = (((A ^ val) & (A ^ result)) >> 7) & 0b1;
+    ZNSetStatus(result);
+    C = diff < 0x100;
+    A = D ? decimal : result;
+}
+
+void cpu_6502::implied(int32_t& cycles, mem_6502& memory){
+    // one byte instructions read the next byte and ignore it
+    dummyread(cycles, PC, memory);
+}
+
+void cpu_6502::branch(int32_t& cycles, mem_6502& memory, bool cond){
+    int8_t offset = (int8_t)fetchbyte(cycles, memory);
+    if(cond){
+        word target = PC + offset;
+        dummyread(cycles, PC, memory);
+        if((target ^ PC) & 0xFF00){
+            dummyread(cycles, (PC & 0xFF00) | (target & 0xFF), memory);
+        }
+        word next = PC;
+        PC = target;
+        if(idleskip && offset < 0 && offset >= -IDLE_LOOP){
+            fastforward(cycles, memory, target, next);
+        }
+    }
+}
+
+bool cpu_6502::fusable(int32_t cycles, const mem_6502& memory) const{
+    // the fetch of a watched or I/O page has side effects of its own
+    return fusion && cycles > 0 && !pending && endclock - cycles < *deadline
+        && !(memory.pageflag(PC) & (mem_6502::WATCH_EXEC | mem_6502::WATCH_BREAK
+                                    | mem_6502::WATCH_READ | mem_6502::WATCH_IO
+                                    | mem_6502::WATCH_TRAP))
+        && !memory.watchhit();
+}
+
+bool cpu_6502::fusebranch(int32_t& cycles, mem_6502& memory){
+    byte next = memory.fetch(PC);
+    if((next != BNE && next != BEQ) || !fusable(cycles, memory)){
+        return false;
+    }
+    bool taken = (next == BNE) != Z;
+#ifdef FUSION_FAULT_6502
+    // test builds get the fused branch at this address wrong, for --diff
+    // to find
+    taken ^= PC == FUSION_FAULT_6502;
+#endif
+    fetchbyte(cycles, memory);
+    branch(cycles, memory, taken);
+    return true;
+}
+
+bool cpu_6502::fusearith(int32_t& cycles, mem_6502& memory){
+    byte next = memory.fetch(PC);
+    if((next != ADC_IM && next != ADC_ZP && next != ADC_ABS
+        && next != SBC_IM && next != SBC_ZP && next != SBC_ABS) || !fusable(cycles, memory)){
+        return false;
+    }
+    fetchbyte(cycles, memory);
+    byte val;
+    switch(next){
+        case ADC_IM: case SBC_IM:   val = fetchbyte(cycles, memory); break;
+        case ADC_ZP: case SBC_ZP:   val = readbyte(cycles, addrzp(cycles, memory), memory); break;
+        default:                    val = readbyte(cycles, addrabs(cycles, memory), memory); break;
+    }
+    if(next == ADC_IM || next == ADC_ZP || next == ADC_ABS){
+        adc(val);
+    } else {
+        sbc(val);
+    }
+    return true;
+}
+
+bool cpu_6502::fusestore(int32_t& cycles, mem_6502& memory){
+    byte next = memory.fetch(PC);
+    if((next != STA_ZP && next != STA_ABS) || !fusable(cycles, memory)){
+        return false;
+    }
+    fetchbyte(cycles, memory);
+    word addr = next == STA_ZP ? addrzp(cycles, memory) : addrabs(cycles, memory);
+    writebyte(cycles, addr, A, memory);
+    return true;
+}
+
+void cpu_6502::fastforward(int32_t& cycles, mem_6502& memory, word loop, word next){
+    uint64_t now = endclock - cycles;
+    uint64_t limit = *deadline < endclock ? *deadline : endclock;
+    if(pending || limit <= now){
+        return;     // something is about to happen anyway
+    }
+
+    // run one iteration on the registers; if it takes the jump back again,
+    // every later iteration finds the same registers and memory and so does
+    // exactly the same
+    byte a = A, x = X, y = Y;
+    byte c = C, z = Z, v = V, n = N;
+    uint32_t period = 0, count = 0;
+    bool idle = false;
+    for(word pc = loop; pc != next && count < IDLE_LOOP; count++){
+        // watched code must run for real
+        if((memory.pageflag(pc) | memory.pageflag(pc + 2))
+                & (mem_6502::WATCH_EXEC | mem_6502::WATCH_BREAK | mem_6502::WATCH_IO
+                   | mem_6502::WATCH_TRAP)){
+            break;
+        }
+        byte op = memory.fetch(pc);
+        byte val;
+        switch(op){
+            case LDA_IM: case LDX_IM: case LDY_IM: case AND_IM:
+            case ORA_IM: case CMP_IM: case CPX_IM: case CPY_IM:
+                val = memory.fetch(pc + 1);
+                pc += 2;
+                period += 2;
+                break;
+            case LDA_ZP: case LDX_ZP: case LDY_ZP: case AND_ZP: case ORA_ZP:
+            case CMP_ZP: case CPX_ZP: case CPY_ZP: case BIT_ZP:
+            case LDA_ABS: case LDX_ABS: case LDY_ABS: case AND_ABS: case ORA_ABS:
+            case CMP_ABS: case CPX_ABS: case CPY_ABS: case BIT_ABS:{
+                bool zp = (op & 0x0C) == 0x04;
+                word addr = zp ? memory.fetch(pc + 1)
+                               : (word)(memory.fetch(pc + 1) | (memory.fetch(pc + 2) << 8));
+                // device registers and read watchpoints have side effects
+                if(memory.pageflag(addr) & (mem_6502::WATCH_READ | mem_6502::WATCH_IO)){
+                    pc = next;
+                    count = IDLE_LOOP;
+                    continue;
+                }
+                val = memory.fetch(addr);
+                pc += zp ? 2 : 3;
+                period += zp ? 3 : 4;
+            } break;
+            case JMP_ABS:
+                idle = pc + 3 == next
+                        && (memory.fetch(pc + 1) | (memory.fetch(pc + 2) << 8)) == loop;
+                period += 3;
+                pc = next;
+                continue;
+            case BCC: case BCS: case BEQ: case BMI:
+            case BNE: case BPL: case BVC: case BVS:{
+                // op >> 6 picks the flag, bit 5 the state that branches
+                bool flag = (op >> 6) == 0 ? N : (op >> 6) == 1 ? V : (op >> 6) == 2 ? C : Z;
+                bool taken = flag == ((op & 0x20) != 0);
+                pc += 2;
+                if(pc == next){
+                    idle = taken && (word)(next + (int8_t)memory.fetch(pc - 1)) == loop;
+                    period += 3 + (((loop ^ next) & 0xFF00) ? 1 : 0);
+                } else if(taken){
+                    pc = next;  // leaves the loop
+                    count = IDLE_LOOP;
+                } else {
+                    period += 2;
+                }
+                continue;
+            }
+            default:
+                pc = next;
+                count = IDLE_LOOP;
+                continue;
+        }
+        switch(op){
+            case LDA_IM: case LDA_ZP: case LDA_ABS: A = val; ZNSetStatus(A); break;
+            case LDX_IM: case LDX_ZP: case LDX_ABS: X = val; ZNSetStatus(X); break;
+            case LDY_IM: case LDY_ZP: case LDY_ABS: Y = val; ZNSetStatus(Y); break;
+            case AND_IM: case AND_ZP: case AND_ABS: A &= val; ZNSetStatus(A); break;
+            case ORA_IM: case ORA_ZP: case ORA_ABS: A |= val; ZNSetStatus(A); break;
+            case CMP_IM: case CMP_ZP: case CMP_ABS: compare(A, val); break;
+            case CPX_IM: case CPX_ZP: case CPX_ABS: compare(X, val); break;
+            case CPY_IM: case CPY_ZP: case CPY_ABS: compare(Y, val); break;
+            default:    bit(val); break;    // BIT
+        }
+    }
+
+    uint64_t iterations = idle ? (limit - now) / period : 0;
+    if(iterations == 0){
+        A = a; X = x; Y = y;
+        C = c; Z = z; V = v; N = n;
+        return;
+    }
+    // loads, AND and ORA with fixed operands and the flag setting compares
+    // all give the same result when repeated, so the registers are now what
+    // any number of iterations leaves
+    cycles -= (int32_t)(iterations * period);
+    retired += iterations * count;
+    skipped += iterations * period;
+}
+
+void cpu_6502::arr(byte val){
+    byte t = A & val;
+    A = (t >> 1) | (C << 7);
+    ZNSetStatus(A);
+    if(!D){
+        C = (A >> 6) & 0b1;
+        V = ((A >> 6) ^ (A >> 5)) & 0b1;
+        return;
+    }
+    // NMOS decimal mode: N, Z and V come from the rotate, then each
+    // nibble is adjusted as after a BCD addition
+    V = ((t ^ A) >> 6) & 0b1;
+    if((t & 0x0F) + (t & 0x01) > 0x05){
+        A = (A & 0xF0) | ((A + 0x06) & 0x0F);
+    }
+    C = (t >> 4) + ((t >> 4) & 0x01) > 0x05;
+    if(C){
+        A += 0x60;
+    }
+}
+
+void cpu_6502::storehigh(int32_t& cycles, mem_6502& memory, word base, byte index, byte val){
+    word addr = base + index;
+    dummyread(cycles, (base & 0xFF00) | (addr & 0xFF), memory);
+    val &= (base >> 8) + 1;
+    if((base ^ addr) & 0xFF00){
+        // the stored value also drives the high address byte
+        addr = (val << 8) | (addr & 0xFF);
+    }
+    writebyte(cycles, addr, val, memory);
+}
+
+template<typename Op>
+void cpu_6502::modify(int32_t& cycles, word addr, mem_6502& memory, Op op){
+    byte val = readbyte(cycles, addr, memory);
+    dummywrite(cycles, addr, val, memory);  // NMOS writes the unmodified value back first
+    writebyte(cycles, addr, op(val), memory);
+}
+
 // Other Functions ---------------------------------------------------------
 /*
  *  execute()
@@ -103,43 +877,607 @@ byte cpu_6502::readbyte(uint32_t& cycles, uint32_t addr, mem_6502& memory){
  *  @param:     cycles - Number of cycles to fetchbyte based on instruction
  *              memory - 6502 memory
  *  @return:    None
+ *  @note:      Stops early at the instruction boundary after a watchpoint
+ *              triggers, or before an opcode under an execute watchpoint
+ *              or breakpoint. Resuming skips the one it stopped on.
  * */
-void cpu_6502::execute(uint32_t cycles, mem_6502& memory){
+void cpu_6502::execute(int32_t cycles, mem_6502& memory){
+    if(jammed && jampolicy == JAM_HALT){
+        stopped = STOP_JAM;
+        return;
+    }
+    uint64_t end = clock + cycles;  // clock once the budget is spent
+    endclock = end;
+    left = &cycles;
+    const uint64_t* due = deadline;
+    uint64_t count = 0;
+    uint32_t skippc = watchpc;
+    watchpc = NO_PC;
+    stopped = STOP_NONE;
+    memory.clearhit();
+#ifdef CYCLE_EXACT_6502
+    buscycle = clock;
+#endif
     while(cycles > 0){
+        // end - cycles is the current clock; one branch covers both slow
+        // paths of the instruction boundary
+        if((end - cycles >= *due) | pending){
+            if(end - cycles >= *due){
+                clock = end - cycles;
+                sched->run(clock);
+            }
+            if(pending){
+                if(stopped == STOP_JAM){
+                    break;
+                }
+                if(pollinterrupt(cycles, memory)){
+                    continue;
+                }
+            }
+        }
+        if(memory.pageflag(PC) & (mem_6502::WATCH_EXEC | mem_6502::WATCH_BREAK
+                                  | mem_6502::WATCH_TRAP)){
+            if((memory.pageflag(PC) & (mem_6502::WATCH_EXEC | mem_6502::WATCH_BREAK))
+                    && PC != skippc && execcheck(memory)){
+                watchpc = PC;
+                break;
+            }
+            if((memory.pageflag(PC) & mem_6502::WATCH_TRAP) && hostcall(cycles, memory)){
+                skippc = NO_PC;
+                count++;
+                if(memory.watchhit()){
+                    stopped = STOP_WATCH;
+                    break;
+                }
+                continue;
+            }
+        }
+        skippc = NO_PC;
+        count++;
+#ifdef SHADOW_STACK_6502
+        instpc = PC;
+#endif
+
         byte inst = fetchbyte(cycles, memory);
         switch (inst) {
 
+            // Load/Store Operations ---------------------------------------
             case LDA_IM:{
                 byte val = fetchbyte(cycles, memory);
                 A = val;
                 LDASetStatus();
+                count += fusestore(cycles, memory);
             } break;
 
             case LDA_ZP:{
                 byte zpaddr = fetchbyte(cycles, memory);
                 A = readbyte(cycles, zpaddr, memory);
                 LDASetStatus();
+                count += fusestore(cycles, memory);
             } break;
 
             case LDA_ZPX:{
-                byte zpaddr = fetchbyte(cycles, memory);
-                // TODO: Add overflow handling logic
-                zpaddr += X;
-                cycles--;
-                A = readbyte(cycles, zpaddr, memory);
+                A = readbyte(cycles, addrzpx(cycles, memory), memory);
+                LDASetStatus();
+            } break;
+
+            case LDA_ABS:{
+                A = readbyte(cycles, addrabs(cycles, memory), memory);
                 LDASetStatus();
+                count += fusestore(cycles, memory);
+            } break;
+            case LDA_ABSX:  A = readbyte(cycles, addrabsx(cycles, memory, false), memory); LDASetStatus(); break;
+            case LDA_ABSY:  A = readbyte(cycles, addrabsy(cycles, memory, false), memory); LDASetStatus(); break;
+            case LDA_INDX:  A = readbyte(cycles, addrindx(cycles, memory), memory); LDASetStatus(); break;
+            case LDA_INDY:  A = readbyte(cycles, addrindy(cycles, memory, false), memory); LDASetStatus(); break;
+
+            case LDX_IM:    X = fetchbyte(cycles, memory); ZNSetStatus(X); break;
+            case LDX_ZP:    X = readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(X); break;
+            case LDX_ZPY:   X = readbyte(cycles, addrzpy(cycles, memory), memory); ZNSetStatus(X); break;
+            case LDX_ABS:   X = readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(X); break;
+            case LDX_ABSY:  X = readbyte(cycles, addrabsy(cycles, memory, false), memory); ZNSetStatus(X); break;
+
+            case LDY_IM:    Y = fetchbyte(cycles, memory); ZNSetStatus(Y); break;
+            case LDY_ZP:    Y = readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(Y); break;
+            case LDY_ZPX:   Y = readbyte(cycles, addrzpx(cycles, memory), memory); ZNSetStatus(Y); break;
+            case LDY_ABS:   Y = readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(Y); break;
+            case LDY_ABSX:  Y = readbyte(cycles, addrabsx(cycles, memory, false), memory); ZNSetStatus(Y); break;
+
+            case STA_ZP:    writebyte(cycles, addrzp(cycles, memory), A, memory); break;
+            case STA_ZPX:   writebyte(cycles, addrzpx(cycles, memory), A, memory); break;
+            case STA_ABS:   writebyte(cycles, addrabs(cycles, memory), A, memory); break;
+            case STA_ABSX:  writebyte(cycles, addrabsx(cycles, memory, true), A, memory); break;
+            case STA_ABSY:  writebyte(cycles, addrabsy(cycles, memory, true), A, memory); break;
+            case STA_INDX:  writebyte(cycles, addrindx(cycles, memory), A, memory); break;
+            case STA_INDY:  writebyte(cycles, addrindy(cycles, memory, true), A, memory); break;
+
+            case STX_ZP:    writebyte(cycles, addrzp(cycles, memory), X, memory); break;
+            case STX_ZPY:   writebyte(cycles, addrzpy(cycles, memory), X, memory); break;
+            case STX_ABS:   writebyte(cycles, addrabs(cycles, memory), X, memory); break;
+
+            case STY_ZP:    writebyte(cycles, addrzp(cycles, memory), Y, memory); break;
+            case STY_ZPX:   writebyte(cycles, addrzpx(cycles, memory), Y, memory); break;
+            case STY_ABS:   writebyte(cycles, addrabs(cycles, memory), Y, memory); break;
+
+            // Register Transfers ------------------------------------------
+            case TAX:   implied(cycles, memory); X = A; ZNSetStatus(X); break;
+            case TAY:   implied(cycles, memory); Y = A; ZNSetStatus(Y); break;
+            case TXA:   implied(cycles, memory); A = X; ZNSetStatus(A); break;
+            case TYA:   implied(cycles, memory); A = Y; ZNSetStatus(A); break;
+
+            // Stack Operations --------------------------------------------
+            case TSX:   implied(cycles, memory); X = SP; ZNSetStatus(X); break;
+            case TXS:   implied(cycles, memory); SP = X; break;
+
+            case PHA:{
+                dummyread(cycles, PC, memory);
+                pushbyte(cycles, A, memory);
+            } break;
+
+            case PHP:{
+                dummyread(cycles, PC, memory);
+                pushbyte(cycles, getstatus() | FLAG_B, memory);
+            } break;
+
+            case PLA:{
+                dummyread(cycles, PC, memory);
+                dummyread(cycles, 0x0100 | SP, memory);
+                A = popbyte(cycles, memory);
+                ZNSetStatus(A);
+            } break;
+
+            case PLP:{
+                // B only exists on the stack copy of the status register
+                dummyread(cycles, PC, memory);
+                dummyread(cycles, 0x0100 | SP, memory);
+                ipoll = I;
+                setstatus(popbyte(cycles, memory) & ~FLAG_B);
+                polldelay = pending = true;
+            } break;
+
+            // Logical -----------------------------------------------------
+            case AND_IM:    A &= fetchbyte(cycles, memory); ZNSetStatus(A); break;
+            case AND_ZP:    A &= readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(A); break;
+            case AND_ZPX:   A &= readbyte(cycles, addrzpx(cycles, memory), memory); ZNSetStatus(A); break;
+            case AND_ABS:   A &= readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(A); break;
+            case AND_ABSX:  A &= readbyte(cycles, addrabsx(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case AND_ABSY:  A &= readbyte(cycles, addrabsy(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case AND_INDX:  A &= readbyte(cycles, addrindx(cycles, memory), memory); ZNSetStatus(A); break;
+            case AND_INDY:  A &= readbyte(cycles, addrindy(cycles, memory, false), memory); ZNSetStatus(A); break;
+
+            case EOR_IM:    A ^= fetchbyte(cycles, memory); ZNSetStatus(A); break;
+            case EOR_ZP:    A ^= readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(A); break;
+            case EOR_ZPX:   A ^= readbyte(cycles, addrzpx(cycles, memory), memory); ZNSetStatus(A); break;
+            case EOR_ABS:   A ^= readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(A); break;
+            case EOR_ABSX:  A ^= readbyte(cycles, addrabsx(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case EOR_ABSY:  A ^= readbyte(cycles, addrabsy(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case EOR_INDX:  A ^= readbyte(cycles, addrindx(cycles, memory), memory); ZNSetStatus(A); break;
+            case EOR_INDY:  A ^= readbyte(cycles, addrindy(cycles, memory, false), memory); ZNSetStatus(A); break;
+
+            case ORA_IM:    A |= fetchbyte(cycles, memory); ZNSetStatus(A); break;
+            case ORA_ZP:    A |= readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(A); break;
+            case ORA_ZPX:   A |= readbyte(cycles, addrzpx(cycles, memory), memory); ZNSetStatus(A); break;
+            case ORA_ABS:   A |= readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(A); break;
+            case ORA_ABSX:  A |= readbyte(cycles, addrabsx(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case ORA_ABSY:  A |= readbyte(cycles, addrabsy(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case ORA_INDX:  A |= readbyte(cycles, addrindx(cycles, memory), memory); ZNSetStatus(A); break;
+            case ORA_INDY:  A |= readbyte(cycles, addrindy(cycles, memory, false), memory); ZNSetStatus(A); break;
+
+            case BIT_ZP:    bit(readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case BIT_ABS:   bit(readbyte(cycles, addrabs(cycles, memory), memory)); break;
+
+            // Arithmetic --------------------------------------------------
+            case ADC_IM:    adc(fetchbyte(cycles, memory)); break;
+            case ADC_ZP:    adc(readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case ADC_ZPX:   adc(readbyte(cycles, addrzpx(cycles, memory), memory)); break;
+            case ADC_ABS:   adc(readbyte(cycles, addrabs(cycles, memory), memory)); break;
+            case ADC_ABSX:  adc(readbyte(cycles, addrabsx(cycles, memory, false), memory)); break;
+            case ADC_ABSY:  adc(readbyte(cycles, addrabsy(cycles, memory, false), memory)); break;
+            case ADC_INDX:  adc(readbyte(cycles, addrindx(cycles, memory), memory)); break;
+            case ADC_INDY:  adc(readbyte(cycles, addrindy(cycles, memory, false), memory)); break;
+
+            case SBC_IM:    sbc(fetchbyte(cycles, memory)); break;
+            case SBC_ZP:    sbc(readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case SBC_ZPX:   sbc(readbyte(cycles, addrzpx(cycles, memory), memory)); break;
+            case SBC_ABS:   sbc(readbyte(cycles, addrabs(cycles, memory), memory)); break;
+            case SBC_ABSX:  sbc(readbyte(cycles, addrabsx(cycles, memory, false), memory)); break;
+            case SBC_ABSY:  sbc(readbyte(cycles, addrabsy(cycles, memory, false), memory)); break;
+            case SBC_INDX:  sbc(readbyte(cycles, addrindx(cycles, memory), memory)); break;
+            case SBC_INDY:  sbc(readbyte(cycles, addrindy(cycles, memory, false), memory)); break;
+
+            case CMP_IM:    compare(A, fetchbyte(cycles, memory)); count += fusebranch(cycles, memory); break;
+            case CMP_ZP:    compare(A, readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case CMP_ZPX:   compare(A, readbyte(cycles, addrzpx(cycles, memory), memory)); break;
+            case CMP_ABS:   compare(A, readbyte(cycles, addrabs(cycles, memory), memory)); break;
+            case CMP_ABSX:  compare(A, readbyte(cycles, addrabsx(cycles, memory, false), memory)); break;
+            case CMP_ABSY:  compare(A, readbyte(cycles, addrabsy(cycles, memory, false), memory)); break;
+            case CMP_INDX:  compare(A, readbyte(cycles, addrindx(cycles, memory), memory)); break;
+            case CMP_INDY:  compare(A, readbyte(cycles, addrindy(cycles, memory, false), memory)); break;
+
+            case CPX_IM:    compare(X, fetchbyte(cycles, memory)); count += fusebranch(cycles, memory); break;
+            case CPX_ZP:    compare(X, readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case CPX_ABS:   compare(X, readbyte(cycles, addrabs(cycles, memory), memory)); break;
+
+            case CPY_IM:    compare(Y, fetchbyte(cycles, memory)); count += fusebranch(cycles, memory); break;
+            case CPY_ZP:    compare(Y, readbyte(cycles, addrzp(cycles, memory), memory)); break;
+            case CPY_ABS:   compare(Y, readbyte(cycles, addrabs(cycles, memory), memory)); break;
+
+            // Increments & Decrements -------------------------------------
+            case INC_ZP:{
+                modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ ZNSetStatus(++v); return v; });
+                count += fusebranch(cycles, memory);
+            } break;
+            case INC_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ ZNSetStatus(++v); return v; }); break;
+            case INC_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ ZNSetStatus(++v); return v; }); break;
+            case INC_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ ZNSetStatus(++v); return v; }); break;
+            case INX:       implied(cycles, memory); X++; ZNSetStatus(X); count += fusebranch(cycles, memory); break;
+            case INY:       implied(cycles, memory); Y++; ZNSetStatus(Y); count += fusebranch(cycles, memory); break;
+
+            case DEC_ZP:{
+                modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ ZNSetStatus(--v); return v; });
+                count += fusebranch(cycles, memory);
+            } break;
+            case DEC_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ ZNSetStatus(--v); return v; }); break;
+            case DEC_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ ZNSetStatus(--v); return v; }); break;
+            case DEC_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ ZNSetStatus(--v); return v; }); break;
+            case DEX:       implied(cycles, memory); X--; ZNSetStatus(X); count += fusebranch(cycles, memory); break;
+            case DEY:       implied(cycles, memory); Y--; ZNSetStatus(Y); count += fusebranch(cycles, memory); break;
+
+            // Shifts ------------------------------------------------------
+            case ASL_ACC:   implied(cycles, memory); A = asl(A); break;
+            case ASL_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ return asl(v); }); break;
+            case ASL_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ return asl(v); }); break;
+            case ASL_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ return asl(v); }); break;
+            case ASL_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ return asl(v); }); break;
+
+            case LSR_ACC:   implied(cycles, memory); A = lsr(A); break;
+            case LSR_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ return lsr(v); }); break;
+            case LSR_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ return lsr(v); }); break;
+            case LSR_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ return lsr(v); }); break;
+            case LSR_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ return lsr(v); }); break;
+
+            case ROL_ACC:   implied(cycles, memory); A = rol(A); break;
+            case ROL_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ return rol(v); }); break;
+            case ROL_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ return rol(v); }); break;
+            case ROL_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ return rol(v); }); break;
+            case ROL_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ return rol(v); }); break;
+
+            case ROR_ACC:   implied(cycles, memory); A = ror(A); break;
+            case ROR_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ return ror(v); }); break;
+            case ROR_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ return ror(v); }); break;
+            case ROR_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ return ror(v); }); break;
+            case ROR_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ return ror(v); }); break;
+
+            // Jumps & Calls -----------------------------------------------
+            case JMP_ABS:{
+                word at = PC - 1;
+                PC = fetchword(cycles, memory);
+                if(idleskip && PC <= at && at - PC <= IDLE_LOOP){
+                    fastforward(cycles, memory, PC, at + 3);
+                }
+            } break;
+
+            case JMP_IND:{
+                // NMOS bug: the pointer high byte never carries into the
+                // next page, so JMP ($10FF) reads $10FF and $1000
+                word ptr = fetchword(cycles, memory);
+                word target = readbyte(cycles, ptr, memory);
+                target |= readbyte(cycles, (ptr & 0xFF00) | ((ptr + 1) & 0xFF), memory) << 8;
+                PC = target;
             } break;
 
             case JSR:{
-                word subaddr = fetchword(cycles, memory);
-                memory.writeword(cycles, PC - 1, SP);
+                // the high byte of the target is fetched after the return
+                // address, which points at it, has been pushed
+                word subaddr = fetchbyte(cycles, memory);
+                byte sp = SP;
+                dummyread(cycles, 0x0100 | SP, memory);
+                pushword(cycles, PC, memory);
+                subaddr |= fetchbyte(cycles, memory) << 8;
                 PC = subaddr;
-                cycles--;
+                shadowcall(sp, 0);
+            } break;
+
+            case RTS:{
+                dummyread(cycles, PC, memory);
+                dummyread(cycles, 0x0100 | SP, memory);
+                PC = popword(cycles, memory);
+                dummyread(cycles, PC, memory);
+                PC++;
+                shadowret();
+            } break;
+
+            // Branches ----------------------------------------------------
+            case BCC:   branch(cycles, memory, !C); break;
+            case BCS:   branch(cycles, memory, C); break;
+            case BEQ:   branch(cycles, memory, Z); break;
+            case BMI:   branch(cycles, memory, N); break;
+            case BNE:   branch(cycles, memory, !Z); break;
+            case BPL:   branch(cycles, memory, !N); break;
+            case BVC:   branch(cycles, memory, !V); break;
+            case BVS:   branch(cycles, memory, V); break;
+
+            // Status Flag Changes -----------------------------------------
+            case CLC:   implied(cycles, memory); C = 0; count += fusearith(cycles, memory); break;
+            case CLD:   implied(cycles, memory); D = 0; break;
+            case CLI:   implied(cycles, memory); ipoll = I; I = 0; polldelay = pending = true; break;
+            case CLV:   implied(cycles, memory); V = 0; break;
+            case SEC:   implied(cycles, memory); C = 1; count += fusearith(cycles, memory); break;
+            case SED:   implied(cycles, memory); D = 1; break;
+            case SEI:   implied(cycles, memory); ipoll = I; I = 1; polldelay = pending = true; break;
+
+            // System Functions --------------------------------------------
+            case BRK:{
+                fetchbyte(cycles, memory);  // BRK skips a padding byte
+                interrupt(cycles, memory, IRQ_VECTOR, true);
             } break;
 
-            default:{
-                printf("ERROR: Instruction not recognized: %d", inst);
+            case NOP:   implied(cycles, memory); break;
+
+            case RTI:{
+                dummyread(cycles, PC, memory);
+                dummyread(cycles, 0x0100 | SP, memory);
+                setstatus(popbyte(cycles, memory) & ~FLAG_B);
+                PC = popword(cycles, memory);
+                shadowret();
             } break;
+
+            // Undocumented Operations -------------------------------------
+            case SLO_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+            case SLO_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ v = asl(v); A |= v; ZNSetStatus(A); return v; }); break;
+
+            case RLA_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+            case RLA_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ v = rol(v); A &= v; ZNSetStatus(A); return v; }); break;
+
+            case SRE_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+            case SRE_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ v = lsr(v); A ^= v; ZNSetStatus(A); return v; }); break;
+
+            case RRA_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+            case RRA_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ v = ror(v); adc(v); return v; }); break;
+
+            case DCP_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ compare(A, --v); return v; }); break;
+            case DCP_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ compare(A, --v); return v; }); break;
+
+            case ISC_ZP:    modify(cycles, addrzp(cycles, memory), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_ZPX:   modify(cycles, addrzpx(cycles, memory), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_ABS:   modify(cycles, addrabs(cycles, memory), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_ABSX:  modify(cycles, addrabsx(cycles, memory, true), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_ABSY:  modify(cycles, addrabsy(cycles, memory, true), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_INDX:  modify(cycles, addrindx(cycles, memory), memory, [this](byte v){ sbc(++v); return v; }); break;
+            case ISC_INDY:  modify(cycles, addrindy(cycles, memory, true), memory, [this](byte v){ sbc(++v); return v; }); break;
+
+            case SAX_ZP:    writebyte(cycles, addrzp(cycles, memory), A & X, memory); break;
+            case SAX_ZPY:   writebyte(cycles, addrzpy(cycles, memory), A & X, memory); break;
+            case SAX_ABS:   writebyte(cycles, addrabs(cycles, memory), A & X, memory); break;
+            case SAX_INDX:  writebyte(cycles, addrindx(cycles, memory), A & X, memory); break;
+
+            case LAX_ZP:    A = X = readbyte(cycles, addrzp(cycles, memory), memory); ZNSetStatus(A); break;
+            case LAX_ZPY:   A = X = readbyte(cycles, addrzpy(cycles, memory), memory); ZNSetStatus(A); break;
+            case LAX_ABS:   A = X = readbyte(cycles, addrabs(cycles, memory), memory); ZNSetStatus(A); break;
+            case LAX_ABSY:  A = X = readbyte(cycles, addrabsy(cycles, memory, false), memory); ZNSetStatus(A); break;
+            case LAX_INDX:  A = X = readbyte(cycles, addrindx(cycles, memory), memory); ZNSetStatus(A); break;
+            case LAX_INDY:  A = X = readbyte(cycles, addrindy(cycles, memory, false), memory); ZNSetStatus(A); break;
+
+            case ANC_IM:
+            case ANC_2B:    A &= fetchbyte(cycles, memory); ZNSetStatus(A); C = N; break;
+            case ALR_IM:    A = lsr(A & fetchbyte(cycles, memory)); break;
+            case ARR_IM:    arr(fetchbyte(cycles, memory)); break;
+            case SBX_IM:{
+                byte val = fetchbyte(cycles, memory);
+                byte ax = A & X;
+                C = ax >= val;
+                X = ax - val;
+                ZNSetStatus(X);
+            } break;
+            case SBC_EB:    sbc(fetchbyte(cycles, memory)); break;
+            case ANE_IM:    A = (A | UNSTABLE_MAGIC) & X & fetchbyte(cycles, memory); ZNSetStatus(A); break;
+            case LXA_IM:    A = X = (A | UNSTABLE_MAGIC) & fetchbyte(cycles, memory); ZNSetStatus(A); break;
+            case LAS_ABSY:  A = X = SP = readbyte(cycles, addrabsy(cycles, memory, false), memory) & SP; ZNSetStatus(A); break;
+
+            case SHA_ABSY:  storehigh(cycles, memory, fetchword(cycles, memory), Y, A & X); break;
+            case SHX_ABSY:  storehigh(cycles, memory, fetchword(cycles, memory), Y, X); break;
+            case SHY_ABSX:  storehigh(cycles, memory, fetchword(cycles, memory), X, Y); break;
+            case TAS_ABSY:  SP = A & X; storehigh(cycles, memory, fetchword(cycles, memory), Y, SP); break;
+            case SHA_INDY:{
+                byte zpaddr = fetchbyte(cycles, memory);
+                word base = readbyte(cycles, zpaddr, memory);
+                base |= readbyte(cycles, (byte)(zpaddr + 1), memory) << 8;
+                storehigh(cycles, memory, base, Y, A & X);
+            } break;
+
+            case NOP_1A: case NOP_3A: case NOP_5A: case NOP_7A: case NOP_DA: case NOP_FA:
+                implied(cycles, memory);
+                break;
+            case NOP_80: case NOP_82: case NOP_89: case NOP_C2: case NOP_E2:
+                fetchbyte(cycles, memory);
+                break;
+            // the reads are real, a device register still sees them
+            case NOP_04: case NOP_44: case NOP_64:
+                readbyte(cycles, addrzp(cycles, memory), memory);
+                break;
+            case NOP_14: case NOP_34: case NOP_54: case NOP_74: case NOP_D4: case NOP_F4:
+                readbyte(cycles, addrzpx(cycles, memory), memory);
+                break;
+            case NOP_0C:
+                readbyte(cycles, addrabs(cycles, memory), memory);
+                break;
+            case NOP_1C: case NOP_3C: case NOP_5C: case NOP_7C: case NOP_DC: case NOP_FC:
+                readbyte(cycles, addrabsx(cycles, memory, false), memory);
+                break;
+
+            case JAM_02: case JAM_12: case JAM_22: case JAM_32: case JAM_42: case JAM_52:
+            case JAM_62: case JAM_72: case JAM_92: case JAM_B2: case JAM_D2: case JAM_F2:
+                // the instruction boundary slow path stops or idles
+                if(jampolicy == JAM_TRAP){
+                    // back on the opcode as if it was never fetched, so
+                    // resuming traps again without time passing
+                    PC--;
+                    cycles++;
+                    count--;
+#ifdef CYCLE_EXACT_6502
+                    buscycle--;
+#endif
+                } else {
+                    jammed = true;
+                }
+                if(jampolicy != JAM_EMULATE){
+                    stopped = STOP_JAM;
+                }
+                pending = true;
+                break;
+        }
+
+        if(memory.watchhit()){
+            stopped = STOP_WATCH;
+            break;
         }
     }
+    clock = end - cycles;
+    retired += count;
+    left = nullptr;
+}
+
+/*
+ *  pollinterrupt()
+ *
+ *  @desc:      Slow path taken before an opcode fetch while an interrupt
+ *              may be pending
+ *  @param:     memory - 6502 memory
+ *  @return:    true if an interrupt was taken
+ * */
+bool cpu_6502::pollinterrupt(int32_t& cycles, mem_6502& memory){
+    // CLI, SEI and PLP change I after the CPU polled for an IRQ, so the
+    // instruction following them still sees the old mask
+    if(jammed){
+        // nothing but reset() gets the CPU going again; time still passes
+        // for the devices
+        uint64_t now = endclock - cycles;
+        uint64_t limit = *deadline < endclock ? *deadline : endclock;
+        cycles -= (int32_t)(limit - now);
+#ifdef CYCLE_EXACT_6502
+        buscycle += limit - now;
+#endif
+        return true;
+    }
+    bool masked = polldelay ? ipoll : I;
+    polldelay = false;
+    if(nmiedge || (irqlines != 0 && !masked)){
+        // the opcode and operand fetches are issued and discarded
+        dummyread(cycles, PC, memory);
+        dummyread(cycles, PC, memory);
+        interrupt(cycles, memory, IRQ_VECTOR, false);
+        return true;
+    }
+    updatepending();
+    return false;
+}
+
+/*
+ *  interrupt()
+ *
+ *  @desc:      Interrupt entry shared by BRK, IRQ and NMI
+ *  @param:     vector - IRQ_VECTOR or NMI_VECTOR
+ *              brk - true for BRK
+ *  @return:    None
+ * */
+void cpu_6502::interrupt(int32_t& cycles, mem_6502& memory, word vector, bool brk){
+#ifdef SHADOW_STACK_6502
+    if(!brk){
+        instpc = PC;    // the instruction it came before
+    }
+#endif
+    byte sp = SP;
+    pushword(cycles, PC, memory);
+    pushbyte(cycles, brk ? getstatus() | FLAG_B : getstatus() & ~FLAG_B, memory);
+    I = 1;
+    if(nmiedge){
+        nmiedge = false;
+        vector = NMI_VECTOR;
+    }
+    PC = readword(cycles, vector, memory);
+    shadowcall(sp, vector);
+    updatepending();
+}
+
+/*
+ *  hostcall()
+ *
+ *  @desc:      Slow path taken before an opcode fetch on a page holding
+ *              a host call: runs the one at PC, if any, and returns
+ *  @param:     cycles - Budget, charged the call's cycles
+ *              memory - 6502 memory
+ *  @return:    true if a host call ran in place of the opcode
+ * */
+bool cpu_6502::hostcall(int32_t& cycles, mem_6502& memory){
+    auto it = traps.find(PC);
+    if(it == traps.end()){
+        return false;
+    }
+    regs_6502 regs = getregs();
+    if(!it->second.call(it->second.ctx, regs, memory)){
+        return false;
+    }
+    A = regs.A;
+    X = regs.X;
+    Y = regs.Y;
+    SP = regs.SP;
+    setstatus(regs.P);
+
+    // return as RTS does, without its bus cycles; they are in the cost
+    word ret = memory.read(0x0100 | (byte)(SP + 1));
+    ret |= memory.read(0x0100 | (byte)(SP + 2)) << 8;
+    SP += 2;
+    PC = ret + 1;
+    cycles -= (int32_t)it->second.cycles;
+#ifdef CYCLE_EXACT_6502
+    buscycle += it->second.cycles;
+#endif
+    shadowret();
+    trapcalls++;
+    return true;
+}
+
+/*
+ *  execcheck()
+ *
+ *  @desc:      Slow path taken before an opcode fetch on a page holding
+ *              an execute watchpoint or a breakpoint
+ *  @param:     memory - 6502 memory
+ *  @return:    true if execution should stop
+ * */
+bool cpu_6502::execcheck(mem_6502& memory){
+    if(memory.execwatch(PC)){
+        stopped = STOP_WATCH;
+        return true;
+    }
+    if(debugger != nullptr && debugger->check(PC, memory)){
+        stopped = STOP_BREAK;
+        return true;
+    }
+    return false;
 }
\ No newline at end of file
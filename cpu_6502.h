@@ -13,8 +13,113 @@
 
 #include "6502.h"
 #include "mem_6502.h"
+#include "sched_6502.h"
+#include <unordered_map>
+#ifdef SHADOW_STACK_6502
+#include "shadow_6502.h"
+#endif
+
+class debug_6502;
+class aot_6502;
+
+/*
+ *  struct regs_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Copy of the programmer visible CPU registers
+ */
+struct regs_6502 {
+    word PC;
+    byte SP;
+    byte A, X, Y;
+    byte P;         // status register, packed NV1BDIZC
+};
+
+/*
+ *  hostcall_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Native implementation of a 6502 subroutine, see addtrap()
+ *  @param:     ctx - Pointer given to addtrap()
+ *              regs - Registers on entry, to be updated with the results;
+ *                     PC is ignored
+ *              memory - 6502 memory, to read arguments and write results
+ *  @return:    true if handled, false to run the 6502 code instead
+ */
+typedef bool (*hostcall_6502)(void* ctx, regs_6502& regs, mem_6502& memory);
+
+/*
+ *  struct trap_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      A host call registered at an address
+ */
+struct trap_6502 {
+    hostcall_6502 call;
+    void* ctx;
+    uint32_t cycles;    // charged per call, the RTS included
+};
+
+#ifdef CYCLE_EXACT_6502
+/*
+ *  bushook_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called once per bus cycle in cycle exact builds
+ *  @param:     ctx - Pointer given to setbushook()
+ *              cycle - Clock cycle of the access
+ *              addr - Address on the bus
+ *              val - Value read or written
+ *              kind - cpu_6502::BUS_* kind of access
+ */
+typedef void (*bushook_6502)(void* ctx, uint64_t cycle, word addr, byte val, byte kind);
+#endif
 
 class cpu_6502 {
+    // translated code runs directly on the registers, see aot_6502
+    friend class aot_6502;
+
+public:
+    // reasons for execute() to return before its cycles ran out
+    static constexpr byte
+            STOP_NONE  = 0x00,
+            STOP_WATCH = 0x01,  // a memory watchpoint triggered
+            STOP_BREAK = 0x02,  // a debugger breakpoint triggered
+            STOP_JAM   = 0x03;  // a JAM opcode ran under JAM_TRAP or JAM_HALT
+
+    // what a JAM opcode does, see setjam()
+    static constexpr byte
+            JAM_EMULATE = 0x00, // lock up until reset() as the NMOS part does,
+                                // the clock and devices keep running
+            JAM_TRAP    = 0x01, // stop before the opcode, every time it runs
+            JAM_HALT    = 0x02; // lock up and stop; execute() returns at once
+                                // until reset()
+
+    // interrupt vectors
+    static constexpr word
+            NMI_VECTOR   = 0xFFFA,
+            RESET_VECTOR = 0xFFFC,
+            IRQ_VECTOR   = 0xFFFE;  // shared by BRK
+
+    // status register bits
+    static constexpr byte
+            FLAG_C = 0x01,
+            FLAG_Z = 0x02,
+            FLAG_I = 0x04,
+            FLAG_D = 0x08,
+            FLAG_B = 0x10,
+            FLAG_U = 0x20,      // unused, always reads as 1
+            FLAG_V = 0x40,
+            FLAG_N = 0x80;
+
+    // kinds of bus cycle reported in cycle exact builds
+    static constexpr byte
+            BUS_FETCH       = 0x00, // opcode or operand byte at PC
+            BUS_READ        = 0x01,
+            BUS_WRITE       = 0x02,
+            BUS_DUMMY_READ  = 0x03, // read whose value is discarded
+            BUS_DUMMY_WRITE = 0x04; // RMW write of the unmodified value
+
 private:
     /*
      *  private CPU struct
@@ -37,6 +142,308 @@ private:
     byte V : 1;     // overflow
     byte N : 1;     // negative
 
+    uint64_t clock;     // cycles executed since construction
+    uint64_t retired;   // instructions executed since construction
+    const int32_t* left;    // budget of the running execute(), else nullptr
+    uint64_t endclock;      // clock once that budget is spent
+
+    // Interrupt Fields
+    uint32_t irqlines;  // one bit per device holding IRQ low
+    bool nmiline;       // NMI held low
+    bool nmiedge;       // NMI went low and has not been taken yet
+    bool polldelay;     // CLI, SEI or PLP ran, IRQ poll uses ipoll once
+    byte ipoll;         // I before the CLI, SEI or PLP
+    bool pending;       // an interrupt may have to be taken or the CPU is
+                        // jammed, checked before each opcode fetch
+    bool jammed;        // a JAM opcode locked the CPU up
+    byte jampolicy;     // JAM_* policy
+
+    // Debugging Fields
+    static constexpr uint32_t NO_PC = 0x10000;
+    uint32_t watchpc;   // PC of the execute watchpoint execution stopped on
+    byte stopped;       // STOP_* reason the last execute() returned early
+    debug_6502* debugger;
+
+    // Device Fields
+    sched_6502* sched;
+    const uint64_t* deadline;   // earliest event of sched, never reached if none
+
+    // Host Call Fields
+    std::unordered_map<word, trap_6502> traps;
+    uint64_t trapcalls; // host calls handled
+
+    // Turbo Fields
+    bool fusion;        // run common pairs as one dispatch, see setfusion()
+    bool idleskip;      // fast-forward idle loops, see setidleskip()
+    uint64_t skipped;   // cycles fast-forwarded
+
+#ifdef CYCLE_EXACT_6502
+    bushook_6502 bushook;
+    void* busctx;
+    uint64_t buscycle;  // clock of the bus cycle in progress
+#endif
+
+#ifdef SHADOW_STACK_6502
+    shadow_6502 shadow;
+    word instpc;        // PC of the instruction in progress
+#endif
+
+    /*
+     *  bus()
+     *
+     *  @desc:      Reports one bus cycle to the bus hook. Compiles to nothing
+     *              unless CYCLE_EXACT_6502 is defined.
+     * */
+    void bus(word addr, byte val, byte kind){
+#ifdef CYCLE_EXACT_6502
+        if(bushook != nullptr){
+            bushook(busctx, buscycle, addr, val, kind);
+        }
+        buscycle++;
+#else
+        (void)addr;
+        (void)val;
+        (void)kind;
+#endif
+    }
+
+    /*
+     *  shadowcall() / shadowret()
+     *
+     *  @desc:      Report a call to PC from the instruction in progress and
+     *              a return to the shadow stack. Compile to nothing unless
+     *              SHADOW_STACK_6502 is defined.
+     *  @param:     sp - SP before the push
+     *              root - Vector of an interrupt, 0 for JSR
+     * */
+    void shadowcall(byte sp, word root){
+#ifdef SHADOW_STACK_6502
+        shadow.call(instpc, PC, sp, getclock(), root);
+#else
+        (void)sp;
+        (void)root;
+#endif
+    }
+
+    void shadowret(){
+#ifdef SHADOW_STACK_6502
+        shadow.ret(SP, getclock());
+#endif
+    }
+
+    /*
+     *  dummyread() / dummywrite()
+     *
+     *  @desc:      Spend a bus cycle whose value the CPU ignores. Memory is
+     *              only touched in cycle exact builds.
+     * */
+    void dummyread(int32_t& cycles, uint32_t addr, mem_6502& memory);
+    void dummywrite(int32_t& cycles, uint32_t addr, byte val, mem_6502& memory);
+
+    /*
+     *  implied()
+     *
+     *  @desc:      Second cycle of a one byte instruction, a discarded read
+     *              of the next byte
+     * */
+    void implied(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  execcheck()
+     *
+     *  @desc:      Slow path taken before an opcode fetch on a page holding
+     *              an execute watchpoint or a breakpoint
+     *  @param:     memory - 6502 memory
+     *  @return:    true if execution should stop
+     * */
+    bool execcheck(mem_6502& memory);
+
+    /*
+     *  hostcall()
+     *
+     *  @desc:      Slow path taken before an opcode fetch on a page holding
+     *              a host call: runs the one at PC, if any, and returns
+     *  @param:     cycles - Budget, charged the call's cycles
+     *              memory - 6502 memory
+     *  @return:    true if a host call ran in place of the opcode
+     * */
+    bool hostcall(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  updatepending()
+     *
+     *  @desc:      Recomputes pending after a line or I changed. A poll
+     *              still delayed by CLI, SEI or PLP stays pending, since an
+     *              IRQ raised now is checked against the old I.
+     * */
+    void updatepending(){
+        pending = jammed || nmiedge || polldelay || (irqlines != 0 && !I);
+    }
+
+    /*
+     *  pollinterrupt()
+     *
+     *  @desc:      Slow path taken before an opcode fetch while pending is
+     *              set. Takes an NMI, or an IRQ unless masked by I as it
+     *              was before a CLI, SEI or PLP that just ran.
+     *  @param:     memory - 6502 memory
+     *  @return:    true if an interrupt was taken
+     * */
+    bool pollinterrupt(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  interrupt()
+     *
+     *  @desc:      Pushes PC and P, sets I and loads PC from a vector. An NMI
+     *              arriving before the vector fetch hijacks BRK and IRQ
+     *              entries to the NMI vector.
+     *  @param:     vector - IRQ_VECTOR or NMI_VECTOR
+     *              brk - true for BRK, which pushes P with B set
+     * */
+    void interrupt(int32_t& cycles, mem_6502& memory, word vector, bool brk);
+
+    // Addressing modes --------------------------------------------------------
+    // Each returns the effective address of the operand, consuming the cycles
+    // of the operand fetch. Indexed modes used by read instructions only pay
+    // the extra cycle when the index crosses a page; write and
+    // read-modify-write instructions always pay it.
+    word addrzp(int32_t& cycles, mem_6502& memory);
+    word addrzpx(int32_t& cycles, mem_6502& memory);
+    word addrzpy(int32_t& cycles, mem_6502& memory);
+    word addrabs(int32_t& cycles, mem_6502& memory);
+    word addrabsx(int32_t& cycles, mem_6502& memory, bool write);
+    word addrabsy(int32_t& cycles, mem_6502& memory, bool write);
+    word addrindx(int32_t& cycles, mem_6502& memory);
+    word addrindy(int32_t& cycles, mem_6502& memory, bool write);
+
+    // Operations --------------------------------------------------------------
+    /*
+     *  ZNSetStatus()
+     *
+     *  @desc:      Set zero and negative flags from a result
+     *  @param:     val - Result of the instruction
+     * */
+    void ZNSetStatus(byte val);
+
+    /*
+     *  adc() / sbc()
+     *
+     *  @desc:      Add or subtract with carry into A, in binary or decimal
+     *              mode depending on D
+     *  @param:     val - Operand
+     * */
+    void adc(byte val);
+    void sbc(byte val);
+
+    /*
+     *  compare()
+     *
+     *  @desc:      Set C, Z and N as for reg - val (CMP, CPX, CPY)
+     * */
+    void compare(byte reg, byte val);
+
+    /*
+     *  asl() / lsr() / rol() / ror()
+     *
+     *  @desc:      Shift or rotate a value, setting C, Z and N
+     *  @return:    Shifted value
+     * */
+    byte asl(byte val);
+    byte lsr(byte val);
+    byte rol(byte val);
+    byte ror(byte val);
+
+    /*
+     *  bit()
+     *
+     *  @desc:      Test bits in memory against A, setting Z, V and N
+     * */
+    void bit(byte val);
+
+    /*
+     *  branch()
+     *
+     *  @desc:      Fetches a relative offset and branches if cond holds,
+     *              one extra cycle if taken and another on a page crossing
+     * */
+    void branch(int32_t& cycles, mem_6502& memory, bool cond);
+
+    /*
+     *  fusable()
+     *
+     *  @desc:      Returns true if the instruction boundary before the next
+     *              opcode would do nothing: budget left, nothing pending or
+     *              due and no watchpoint on or hit by the opcode fetch
+     * */
+    bool fusable(int32_t cycles, const mem_6502& memory) const;
+
+    /*
+     *  fusebranch()
+     *
+     *  @desc:      Runs a BNE or BEQ following the instruction just run in
+     *              the same dispatch, as the loop counters before them do
+     *  @return:    true if one was run
+     * */
+    bool fusebranch(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  fusearith()
+     *
+     *  @desc:      Runs an immediate, zero page or absolute ADC or SBC
+     *              following CLC or SEC in the same dispatch
+     *  @return:    true if one was run
+     * */
+    bool fusearith(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  fusestore()
+     *
+     *  @desc:      Runs a zero page or absolute STA following LDA in the
+     *              same dispatch
+     *  @return:    true if one was run
+     * */
+    bool fusestore(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  arr()
+     *
+     *  @desc:      Undocumented ARR, AND then ROR A with flags of its own
+     *              and a BCD adjust in decimal mode
+     * */
+    void arr(byte val);
+
+    /*
+     *  storehigh()
+     *
+     *  @desc:      Undocumented SHA, SHX, SHY and TAS store: val & (high
+     *              byte of base + 1) to base + index, and when the index
+     *              crosses a page the stored value replaces the high byte
+     *              of the address
+     * */
+    void storehigh(int32_t& cycles, mem_6502& memory, word base, byte index, byte val);
+
+    /*
+     *  fastforward()
+     *
+     *  @desc:      Slow path of a backward jump while idle skipping is on.
+     *              If the loop from loop to next only reads plain memory and
+     *              would run again unchanged, skips whole iterations up to
+     *              the next event or the end of the budget.
+     *  @param:     loop - Jump target, the start of the loop
+     *              next - Address after the jump instruction
+     * */
+    void fastforward(int32_t& cycles, mem_6502& memory, word loop, word next);
+
+    /*
+     *  modify()
+     *
+     *  @desc:      Read-modify-write of a memory operand, including the
+     *              dummy write cycle of the NMOS 6502
+     *  @param:     addr - Operand address
+     *              op - Operation applied to the value read
+     * */
+    template<typename Op>
+    void modify(int32_t& cycles, word addr, mem_6502& memory, Op op);
 
 public:
     // Class Constructors & Destructors ----------------------------------------
@@ -61,7 +468,173 @@ public:
      * */
     void LDASetStatus();
 
+    /*
+     *  setregs()
+     *
+     *  @desc:      Loads all programmer visible registers
+     *  @param:     regs - New register values
+     *  @return:    None
+     * */
+    void setregs(const regs_6502& regs);
+
+    /*
+     *  setstatus()
+     *
+     *  @desc:      Unpacks the status register into the flag bits
+     *  @param:     status - Packed NV1BDIZC status byte
+     *  @return:    None
+     * */
+    void setstatus(byte status);
+
+    /*
+     *  setirq()
+     *
+     *  @desc:      Drives the level sensitive IRQ line. Devices share it
+     *              wired-OR, each owning a bit of lines; an IRQ is taken at
+     *              every instruction boundary while any holds it with I
+     *              clear.
+     *  @param:     lines - Bits of the devices changing their output
+     *              on - true to assert (pull low)
+     *  @return:    None
+     * */
+    void setirq(uint32_t lines, bool on);
+
+    /*
+     *  setnmi()
+     *
+     *  @desc:      Drives the edge sensitive NMI line. Asserting it latches
+     *              one NMI, taken at the next instruction boundary; holding
+     *              it asserted does not retrigger.
+     *  @param:     on - true to assert (pull low)
+     *  @return:    None
+     * */
+    void setnmi(bool on);
+
+    /*
+     *  attach()
+     *
+     *  @desc:      Attaches a debugger consulted at breakpoint addresses
+     *  @param:     dbg - Debugger, or nullptr to detach
+     *  @return:    None
+     * */
+    void attach(debug_6502* dbg);
+
+    /*
+     *  attach()
+     *
+     *  @desc:      Attaches an event scheduler, run at the first instruction
+     *              boundary at or after each event's deadline
+     *  @param:     events - Scheduler, or nullptr to detach
+     *  @return:    None
+     *  @note:      Takes effect on the next execute() call, so it must not
+     *              be called from an event
+     * */
+    void attach(sched_6502* events);
+
+    /*
+     *  setidleskip()
+     *
+     *  @desc:      Turns idle loop fast-forwarding on or off. A short loop
+     *              that polls plain memory without writing anything, such as
+     *              JMP * or LDA flag / BEQ *-2, can only leave when an event
+     *              or an interrupt changes something, so its iterations are
+     *              skipped in one step up to the next scheduler deadline.
+     *              The machine state is the same as running them, but the
+     *              skipped cycles never reach the bus hook, so this does
+     *              nothing in cycle exact builds.
+     *  @param:     on - true to fast-forward
+     *  @return:    None
+     * */
+    void setidleskip(bool on);
+
+    /*
+     *  setfusion()
+     *
+     *  @desc:      Turns superinstructions on or off. LDA then STA, CLC or
+     *              SEC then ADC or SBC, and the loop counters (DEX, DEY,
+     *              INX, INY, INC and DEC zero page, CMP, CPX and CPY
+     *              immediate) then BNE or BEQ run as one dispatch when
+     *              nothing could happen between the two. Cycles, bus
+     *              accesses and flags are exactly those of running them
+     *              apart; on by default.
+     *  @param:     on - true to fuse
+     *  @return:    None
+     * */
+    void setfusion(bool on);
+
+    /*
+     *  setjam()
+     *
+     *  @desc:      Chooses what the twelve JAM opcodes do: lock the CPU up
+     *              as the hardware does (JAM_EMULATE, the default), stop
+     *              execute() on the opcode each time it is reached,
+     *              without counting it or its fetch cycle (JAM_TRAP), or
+     *              lock up and stop (JAM_HALT). getstop() reports STOP_JAM
+     *              for the last two.
+     *  @param:     policy - JAM_EMULATE, JAM_TRAP or JAM_HALT
+     *  @return:    None
+     * */
+    void setjam(byte policy);
+
+    /*
+     *  unjam()
+     *
+     *  @desc:      Releases a CPU held by a JAM opcode without reset(),
+     *              which would also clear memory; registers are untouched
+     *  @return:    None
+     * */
+    void unjam();
+
+    /*
+     *  addtrap()
+     *
+     *  @desc:      Runs call instead of the subroutine at addr whenever an
+     *              opcode is about to be fetched there, then returns as RTS
+     *              would and charges cycles. Breakpoints and execute
+     *              watchpoints at addr still stop first. Replaces any trap
+     *              already at addr.
+     *  @param:     addr - Entry point of the subroutine
+     *              call - Native implementation
+     *              ctx - Passed through to call
+     *              cycles - Cycles to charge per call, RTS included
+     *              memory - 6502 memory, whose page at addr is flagged
+     *  @return:    None
+     * */
+    void addtrap(word addr, hostcall_6502 call, void* ctx, uint32_t cycles, mem_6502& memory);
+
+    /*
+     *  deltrap()
+     *
+     *  @desc:      Removes the trap at addr
+     *  @param:     addr - Entry point given to addtrap()
+     *              memory - 6502 memory
+     *  @return:    false if there was none
+     * */
+    bool deltrap(word addr, mem_6502& memory);
+
     // Access functions --------------------------------------------------------
+    /*
+     *  getregs()
+     *
+     *  @desc:      Returns a copy of all programmer visible registers
+     * */
+    regs_6502 getregs() const;
+
+    /*
+     *  getstatus()
+     *
+     *  @desc:      Returns the flag bits packed as NV1BDIZC
+     * */
+    byte getstatus() const;
+
+    /*
+     *  getstop()
+     *
+     *  @desc:      Returns why the last execute() returned early, STOP_NONE
+     *              if it ran out of cycles
+     * */
+    byte getstop() const;
+
     /*
      *  fetchbyte()
      *
@@ -70,7 +643,7 @@ public:
      *              memory - 6502 memory
      *  @return:    Fetched byte
      * */
-    byte fetchbyte(uint32_t& cycles, mem_6502& memory);
+    byte fetchbyte(int32_t& cycles, mem_6502& memory);
 
     /*
      *  fetchword()
@@ -80,7 +653,7 @@ public:
      *              memory - 6502 memory
      *  @return:    Fetched byte
      * */
-    word fetchword(uint32_t& cycles, mem_6502& memory);
+    word fetchword(int32_t& cycles, mem_6502& memory);
 
     /*
      *  readbyte()
@@ -90,7 +663,126 @@ public:
      *              memory - 6502 memory
      *  @return:    Read byte
      * */
-    static byte readbyte(uint32_t& cycles, uint32_t addr, mem_6502& memory);
+    byte readbyte(int32_t& cycles, uint32_t addr, mem_6502& memory);
+
+    /*
+     *  readword()
+     *
+     *  @desc:      Reads a little endian word from memory
+     *  @param:     cycles - Number of cycles to read based on instruction
+     *              addr - Address of the low byte
+     *              memory - 6502 memory
+     *  @return:    Read word
+     * */
+    word readword(int32_t& cycles, uint32_t addr, mem_6502& memory);
+
+    /*
+     *  writebyte()
+     *
+     *  @desc:      Writes a single byte to memory
+     *  @param:     cycles - Number of cycles to write based on instruction
+     *              addr - Address to write to
+     *              val - Value to write
+     *              memory - 6502 memory
+     *  @return:    None
+     * */
+    void writebyte(int32_t& cycles, uint32_t addr, byte val, mem_6502& memory);
+
+    /*
+     *  pushbyte() / pushword()
+     *
+     *  @desc:      Pushes onto the stack in page 1, high byte first for
+     *              words, decrementing SP
+     *  @param:     cycles - Number of cycles to push based on instruction
+     *              val - Value to push
+     *              memory - 6502 memory
+     *  @return:    None
+     * */
+    void pushbyte(int32_t& cycles, byte val, mem_6502& memory);
+    void pushword(int32_t& cycles, word val, mem_6502& memory);
+
+    /*
+     *  popbyte() / popword()
+     *
+     *  @desc:      Pulls from the stack in page 1, incrementing SP
+     *  @param:     cycles - Number of cycles to pull based on instruction
+     *              memory - 6502 memory
+     *  @return:    Pulled value
+     * */
+    byte popbyte(int32_t& cycles, mem_6502& memory);
+    word popword(int32_t& cycles, mem_6502& memory);
+
+    /*
+     *  getclock()
+     *
+     *  @desc:      Returns the number of cycles executed since construction.
+     *              Devices called from inside execute() get the cycle of
+     *              the bus access in progress.
+     * */
+    uint64_t getclock() const;
+
+    /*
+     *  getretired()
+     *
+     *  @desc:      Returns the number of instructions executed since
+     *              construction
+     * */
+    uint64_t getretired() const;
+
+    /*
+     *  getskipped()
+     *
+     *  @desc:      Returns the number of cycles fast-forwarded over idle
+     *              loops, included in getclock()
+     * */
+    uint64_t getskipped() const;
+
+    /*
+     *  gettrapcalls()
+     *
+     *  @desc:      Returns the number of host calls run in place of 6502
+     *              code, each also counted as one retired instruction
+     * */
+    uint64_t gettrapcalls() const;
+
+    /*
+     *  getjammed()
+     *
+     *  @desc:      Returns true while a JAM opcode holds the CPU, until
+     *              reset()
+     * */
+    bool getjammed() const;
+
+    /*
+     *  getfusion()
+     *
+     *  @desc:      Returns true while superinstructions are on, see
+     *              setfusion()
+     * */
+    bool getfusion() const;
+
+#ifdef SHADOW_STACK_6502
+    /*
+     *  getshadow()
+     *
+     *  @desc:      Returns the shadow call stack
+     * */
+    shadow_6502& getshadow();
+    const shadow_6502& getshadow() const;
+#endif
+
+#ifdef CYCLE_EXACT_6502
+    /*
+     *  setbushook()
+     *
+     *  @desc:      Installs a function called for every bus cycle, in
+     *              order, including dummy reads and writes
+     *  @param:     hook - Function to call, nullptr to remove
+     *              ctx - Passed through to hook
+     *  @return:    None
+     * */
+    void setbushook(bushook_6502 hook, void* ctx);
+#endif
 
     // Other Functions ---------------------------------------------------------
     /*
@@ -100,8 +792,61 @@ public:
      *  @param:     cycles - Number of cycles to fetchbyte based on instruction
      *              memory - 6502 memory
      *  @return:    None
+     *  @note:      Stops early at the instruction boundary after a watchpoint
+     *              triggers, or before an opcode under an execute watchpoint
+     *              or breakpoint. Resuming skips the one it stopped on.
      * */
-    void execute(uint32_t cycles, mem_6502& memory);
+    void execute(int32_t cycles, mem_6502& memory);
 };
 
+// Inline Operations -----------------------------------------------------------
+// Shared by the interpreter and translated code, so they are defined in the
+// header.
+
+inline void cpu_6502::ZNSetStatus(byte val){
+    Z = (val == 0);
+    N = (val >> 7) & 0b1;
+}
+
+inline void cpu_6502::compare(byte reg, byte val){
+    C = reg >= val;
+    ZNSetStatus(reg - val);
+}
+
+inline byte cpu_6502::asl(byte val){
+    C = (val >> 7) & 0b1;
+    val <<= 1;
+    ZNSetStatus(val);
+    return val;
+}
+
+inline byte cpu_6502::lsr(byte val){
+    C = val & 0b1;
+    val >>= 1;
+    ZNSetStatus(val);
+    return val;
+}
+
+inline byte cpu_6502::rol(byte val){
+    byte carry = C;
+    C = (val >> 7) & 0b1;
+    val = (val << 1) | carry;
+    ZNSetStatus(val);
+    return val;
+}
+
+inline byte cpu_6502::ror(byte val){
+    byte carry = C;
+    C = val & 0b1;
+    val = (val >> 1) | (carry << 7);
+    ZNSetStatus(val);
+    return val;
+}
+
+inline void cpu_6502::bit(byte val){
+    Z = (A & val) == 0;
+    V = (val >> 6) & 0b1;
+    N = (val >> 7) & 0b1;
+}
+
 #endif //INC_6502_CPU_6502_H
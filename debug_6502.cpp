@@ -0,0 +1,464 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       debug_6502.cpp
+ * @desc:       Source file for 6502 breakpoint debugger
+ *****************************************************************************/
+
+#include "debug_6502.h"
+#include <cctype>
+
+// Conditions compute in 32 bit two's complement, wrapping on overflow as
+// the unsigned arithmetic they are done in does.
+static int32_t wrap(uint32_t val){
+    return val <= INT32_MAX ? (int32_t)val : -(int32_t)(UINT32_MAX - val) - 1;
+}
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a debugger attached to cpu, setting breakpoints in memory.
+debug_6502::debug_6502(cpu_6502& cpu, mem_6502& memory) : cpu(cpu), mem(memory){
+    memset(pcbits, 0, sizeof(pcbits));
+    nextbreak = 1;
+    lastid = 0;
+    src = nullptr;
+    depth = maxdepth = 0;
+    cpu.attach(this);
+}
+
+// Detaches from the cpu and removes all breakpoints.
+debug_6502::~debug_6502(){
+    clearbreaks();
+    cpu.attach((debug_6502*)nullptr);
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  addbreak()
+ *
+ *  @desc:      Adds a breakpoint, compiling its condition once
+ *  @param:     pc - Address of the instruction to stop before
+ *              cond - Condition such as "A == 0x42 && X > 3", or nullptr
+ *                     to always stop
+ *  @return:    Breakpoint id, or -1 if the condition does not compile
+ * */
+int debug_6502::addbreak(word pc, const char* cond){
+    break_6502 bp{nextbreak, pc, true, 0, "", {}};
+    if(cond != nullptr && *cond != '\0'){
+        if(!compile(cond, bp.code)){
+            return -1;
+        }
+        bp.cond = cond;
+    }
+    breaks.push_back(bp);
+    pcbits[pc >> 3] |= 1 << (pc & 7);
+    mem.markbreak(pc, true);
+    return nextbreak++;
+}
+
+/*
+ *  delbreak()
+ *
+ *  @desc:      Removes a breakpoint
+ *  @param:     id - Breakpoint id returned by addbreak()
+ *  @return:    true if the breakpoint existed
+ * */
+bool debug_6502::delbreak(int id){
+    for(auto it = breaks.begin(); it != breaks.end(); ++it){
+        if(it->id == id){
+            word pc = it->pc;
+            breaks.erase(it);
+            mem.markbreak(pc, false);
+            bool others = false;
+            for(const break_6502& bp : breaks){
+                others |= bp.pc == pc;
+            }
+            if(!others){
+                pcbits[pc >> 3] &= ~(1 << (pc & 7));
+            }
+            if(lastid == id){
+                lastid = 0;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  enablebreak()
+ *
+ *  @desc:      Enables or disables a breakpoint without removing it
+ *  @param:     id - Breakpoint id returned by addbreak()
+ *              on - true to enable
+ *  @return:    true if the breakpoint existed
+ * */
+bool debug_6502::enablebreak(int id, bool on){
+    for(break_6502& bp : breaks){
+        if(bp.id == id){
+            bp.enabled = on;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  clearbreaks()
+ *
+ *  @desc:      Removes all breakpoints
+ *  @param:     None
+ *  @return:    None
+ * */
+void debug_6502::clearbreaks(){
+    for(const break_6502& bp : breaks){
+        mem.markbreak(bp.pc, false);
+    }
+    breaks.clear();
+    memset(pcbits, 0, sizeof(pcbits));
+    lastid = 0;
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  check()
+ *
+ *  @desc:      Called by the cpu before executing an opcode on a page
+ *              holding a breakpoint
+ *  @param:     pc - Address of the opcode
+ *              memory - 6502 memory
+ *  @return:    true if an enabled breakpoint at pc has a true condition
+ * */
+bool debug_6502::check(word pc, mem_6502& memory){
+    if(!hasbreak(pc)){
+        return false;
+    }
+    for(break_6502& bp : breaks){
+        if(bp.pc == pc && bp.enabled
+                && (bp.code.empty() || eval(bp.code, memory) != 0)){
+            bp.hits++;
+            lastid = bp.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  hasbreak()
+ *
+ *  @desc:      Returns true if any breakpoint is set at pc
+ * */
+bool debug_6502::hasbreak(word pc) const{
+    return (pcbits[pc >> 3] >> (pc & 7)) & 1;
+}
+
+/*
+ *  lastbreak()
+ *
+ *  @desc:      Returns the breakpoint that last stopped execution, or
+ *              nullptr
+ * */
+const debug_6502::break_6502* debug_6502::lastbreak() const{
+    for(const break_6502& bp : breaks){
+        if(bp.id == lastid){
+            return &bp;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ *  getbreaks()
+ *
+ *  @desc:      Returns the list of breakpoints
+ * */
+const std::vector<debug_6502::break_6502>& debug_6502::getbreaks() const{
+    return breaks;
+}
+
+/*
+ *  geterror()
+ *
+ *  @desc:      Returns the reason the last addbreak() failed
+ * */
+const std::string& debug_6502::geterror() const{
+    return error;
+}
+
+
+// Condition compiler ------------------------------------------------------
+/*
+ *  compile()
+ *
+ *  @desc:      Compiles a condition expression to bytecode
+ *  @param:     text - Condition source, e.g. "A == 0x42 && X > 3"
+ *              code - Receives the compiled program
+ *  @return:    true on success, otherwise geterror() describes the problem
+ * */
+bool debug_6502::compile(const char* text, std::vector<int32_t>& code){
+    src = text;
+    depth = maxdepth = 0;
+    error.clear();
+    code.clear();
+
+    if(!parsebinary(0, code)){
+        return false;
+    }
+    skipspace();
+    if(*src != '\0'){
+        error = std::string("unexpected '") + src + "'";
+        return false;
+    }
+    if(maxdepth > MAX_STACK){
+        error = "condition is too deeply nested";
+        return false;
+    }
+    return true;
+}
+
+/*
+ *  parsebinary()
+ *
+ *  @desc:      Parses one precedence level of binary operators
+ *  @param:     level - Precedence level, 0 is the loosest
+ *              code - Program to emit into
+ *  @return:    true on success
+ * */
+bool debug_6502::parsebinary(int level, std::vector<int32_t>& code){
+    // operators from loosest to tightest binding, as in C; longer spellings
+    // come first so "<=" is not read as "<"
+    static const struct { int level; const char* text; int32_t op; } ops[] = {
+        {0, "||", OP_LOR}, {1, "&&", OP_LAND}, {2, "|", OP_OR},
+        {3, "^", OP_XOR},  {4, "&", OP_AND},   {5, "==", OP_EQ},
+        {5, "!=", OP_NE},  {6, "<=", OP_LE},   {6, ">=", OP_GE},
+        {6, "<", OP_LT},   {6, ">", OP_GT},    {7, "+", OP_ADD},
+        {7, "-", OP_SUB},  {8, "*", OP_MUL},
+    };
+    static constexpr int LEVELS = 9;
+
+    if(level == LEVELS){
+        return parseunary(code);
+    }
+    if(!parsebinary(level + 1, code)){
+        return false;
+    }
+    for(;;){
+        skipspace();
+        int32_t found = -1;
+        size_t len = 0;
+        for(const auto& o : ops){
+            size_t n = strlen(o.text);
+            if(o.level == level && strncmp(src, o.text, n) == 0){
+                // keep "&" and "|" from matching the first half of "&&"/"||"
+                if(n == 1 && (src[0] == '&' || src[0] == '|') && src[1] == src[0]){
+                    continue;
+                }
+                found = o.op;
+                len = n;
+                break;
+            }
+        }
+        if(found < 0){
+            return true;
+        }
+        src += len;
+        if(!parsebinary(level + 1, code)){
+            return false;
+        }
+        emit(code, found, -1);
+    }
+}
+
+/*
+ *  parseunary()
+ *
+ *  @desc:      Parses a unary expression or primary
+ *  @param:     code - Program to emit into
+ *  @return:    true on success
+ * */
+bool debug_6502::parseunary(std::vector<int32_t>& code){
+    static const struct { const char* name; int32_t reg; } regs[] = {
+        {"SP", REG_SP}, {"PC", REG_PC}, {"A", REG_A}, {"X", REG_X},
+        {"Y", REG_Y},   {"P", REG_P},   {"C", REG_C}, {"Z", REG_Z},
+        {"I", REG_I},   {"D", REG_D},   {"B", REG_B}, {"V", REG_V},
+        {"N", REG_N},
+    };
+
+    skipspace();
+    char c = *src;
+
+    if(c == '!' || c == '~' || c == '-'){
+        src++;
+        if(!parseunary(code)){
+            return false;
+        }
+        emit(code, c == '!' ? OP_NOT : c == '~' ? OP_INV : OP_NEG, 0);
+        return true;
+    }
+
+    if(c == '(' || c == '['){
+        src++;
+        if(!parsebinary(0, code)){
+            return false;
+        }
+        skipspace();
+        if(*src != (c == '(' ? ')' : ']')){
+            error = std::string("missing '") + (c == '(' ? ')' : ']') + "'";
+            return false;
+        }
+        src++;
+        if(c == '['){
+            emit(code, OP_MEM, 0);
+        }
+        return true;
+    }
+
+    int base = 10;
+    if(c == '$'){
+        base = 16;
+        src++;
+    } else if(c == '%'){
+        base = 2;
+        src++;
+    } else if(c == '0' && (src[1] == 'x' || src[1] == 'X')){
+        base = 16;
+        src += 2;
+    }
+    if(base != 10 || isdigit((unsigned char)c)){
+        char* end;
+        unsigned long long val = strtoull(src, &end, base);
+        if(end == src){
+            error = "malformed number";
+            return false;
+        }
+        src = end;
+        emit(code, OP_PUSH, 1);
+        code.push_back(wrap((uint32_t)val));
+        return true;
+    }
+
+    if(isalpha((unsigned char)c)){
+        const char* start = src;
+        while(isalnum((unsigned char)*src)){
+            src++;
+        }
+        std::string name(start, src - start);
+        for(char& ch : name){
+            ch = (char)toupper((unsigned char)ch);
+        }
+        for(const auto& r : regs){
+            if(name == r.name){
+                emit(code, OP_REG, 1);
+                code.push_back(r.reg);
+                return true;
+            }
+        }
+        error = "unknown register '" + std::string(start, src - start) + "'";
+        return false;
+    }
+
+    error = c == '\0' ? "unexpected end of condition"
+                      : std::string("unexpected '") + c + "'";
+    return false;
+}
+
+/*
+ *  emit()
+ *
+ *  @desc:      Appends an opcode, tracking the stack depth it leaves
+ *  @param:     code - Program to emit into
+ *              op - Opcode
+ *              effect - Change in stack depth
+ *  @return:    None
+ * */
+void debug_6502::emit(std::vector<int32_t>& code, int32_t op, int effect){
+    code.push_back(op);
+    depth += effect;
+    if(depth > maxdepth){
+        maxdepth = depth;
+    }
+}
+
+/*
+ *  skipspace()
+ *
+ *  @desc:      Advances the source past whitespace
+ * */
+void debug_6502::skipspace(){
+    while(isspace((unsigned char)*src)){
+        src++;
+    }
+}
+
+/*
+ *  eval()
+ *
+ *  @desc:      Runs a compiled condition against the current CPU state
+ *  @param:     code - Compiled program
+ *              memory - 6502 memory
+ *  @return:    Value of the condition
+ * */
+int32_t debug_6502::eval(const std::vector<int32_t>& code, const mem_6502& memory) const{
+    int32_t stack[MAX_STACK];
+    int sp = -1;
+    regs_6502 r = cpu.getregs();
+
+    for(size_t i = 0; i < code.size(); i++){
+        switch(code[i]){
+            case OP_PUSH: stack[++sp] = code[++i]; break;
+
+            case OP_REG:{
+                int32_t val = 0;
+                switch(code[++i]){
+                    case REG_A:  val = r.A; break;
+                    case REG_X:  val = r.X; break;
+                    case REG_Y:  val = r.Y; break;
+                    case REG_SP: val = r.SP; break;
+                    case REG_PC: val = r.PC; break;
+                    case REG_P:  val = r.P; break;
+                    case REG_C:  val = (r.P & cpu_6502::FLAG_C) != 0; break;
+                    case REG_Z:  val = (r.P & cpu_6502::FLAG_Z) != 0; break;
+                    case REG_I:  val = (r.P & cpu_6502::FLAG_I) != 0; break;
+                    case REG_D:  val = (r.P & cpu_6502::FLAG_D) != 0; break;
+                    case REG_B:  val = (r.P & cpu_6502::FLAG_B) != 0; break;
+                    case REG_V:  val = (r.P & cpu_6502::FLAG_V) != 0; break;
+                    case REG_N:  val = (r.P & cpu_6502::FLAG_N) != 0; break;
+                }
+                stack[++sp] = val;
+            } break;
+
+            case OP_MEM: stack[sp] = memory[stack[sp] & 0xFFFF]; break;
+            case OP_NOT: stack[sp] = !stack[sp]; break;
+            case OP_NEG: stack[sp] = wrap(0u - (uint32_t)stack[sp]); break;
+            case OP_INV: stack[sp] = ~stack[sp]; break;
+
+            default:{
+                int32_t b = stack[sp--];
+                int32_t& a = stack[sp];
+                switch(code[i]){
+                    case OP_MUL:  a = wrap((uint32_t)a * (uint32_t)b); break;
+                    case OP_ADD:  a = wrap((uint32_t)a + (uint32_t)b); break;
+                    case OP_SUB:  a = wrap((uint32_t)a - (uint32_t)b); break;
+                    case OP_LT:   a = a < b; break;
+                    case OP_LE:   a = a <= b; break;
+                    case OP_GT:   a = a > b; break;
+                    case OP_GE:   a = a >= b; break;
+                    case OP_EQ:   a = a == b; break;
+                    case OP_NE:   a = a != b; break;
+                    case OP_AND:  a = a & b; break;
+                    case OP_XOR:  a = a ^ b; break;
+                    case OP_OR:   a = a | b; break;
+                    case OP_LAND: a = a && b; break;
+                    case OP_LOR:  a = a || b; break;
+                }
+            } break;
+        }
+    }
+    return stack[0];
+}
@@ -0,0 +1,230 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       debug_6502.h
+ * @desc:       Header file for 6502 breakpoint debugger
+ *****************************************************************************/
+
+#ifndef INC_6502_DEBUG_6502_H
+#define INC_6502_DEBUG_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include <string>
+#include <vector>
+
+class debug_6502 {
+public:
+    /*
+     *  struct break_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      A PC breakpoint with an optional compiled condition
+     */
+    struct break_6502 {
+        int id;
+        word pc;
+        bool enabled;
+        uint32_t hits;              // times the breakpoint stopped execution
+        std::string cond;           // source text of the condition
+        std::vector<int32_t> code;  // compiled condition, empty if none
+    };
+
+private:
+    /*
+     *  Condition bytecode
+     *
+     *  @desc:      Conditions compile to a postfix program over a small
+     *              value stack. Operands follow their opcode inline.
+     */
+    enum : int32_t {
+        OP_PUSH,    // push the next word
+        OP_REG,     // push the register named by the next word
+        OP_MEM,     // replace top with the byte at that address
+        OP_NOT, OP_NEG, OP_INV,
+        OP_MUL, OP_ADD, OP_SUB,
+        OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE,
+        OP_AND, OP_XOR, OP_OR,
+        OP_LAND, OP_LOR
+    };
+
+    // registers an OP_REG can name
+    enum : int32_t {
+        REG_A, REG_X, REG_Y, REG_SP, REG_PC, REG_P,
+        REG_C, REG_Z, REG_I, REG_D, REG_B, REG_V, REG_N
+    };
+
+    static constexpr int MAX_STACK = 32;
+
+    // Debugger Fields
+    cpu_6502& cpu;
+    mem_6502& mem;
+    std::vector<break_6502> breaks;
+    byte pcbits[0x10000 / 8];       // one bit per address holding a breakpoint
+    int nextbreak;
+    int lastid;                     // breakpoint that last stopped execution
+    std::string error;
+
+    // Condition compiler state
+    const char* src;
+    int depth, maxdepth;
+
+    /*
+     *  compile()
+     *
+     *  @desc:      Compiles a condition expression to bytecode
+     *  @param:     text - Condition source, e.g. "A == 0x42 && X > 3"
+     *              code - Receives the compiled program
+     *  @return:    true on success, otherwise geterror() describes the problem
+     * */
+    bool compile(const char* text, std::vector<int32_t>& code);
+
+    /*
+     *  parsebinary()
+     *
+     *  @desc:      Parses one precedence level of binary operators
+     *  @param:     level - Precedence level, 0 is the loosest
+     *              code - Program to emit into
+     *  @return:    true on success
+     * */
+    bool parsebinary(int level, std::vector<int32_t>& code);
+
+    /*
+     *  parseunary()
+     *
+     *  @desc:      Parses a unary expression or primary
+     *  @param:     code - Program to emit into
+     *  @return:    true on success
+     * */
+    bool parseunary(std::vector<int32_t>& code);
+
+    /*
+     *  emit()
+     *
+     *  @desc:      Appends an opcode, tracking the stack depth it leaves
+     *  @param:     code - Program to emit into
+     *              op - Opcode
+     *              effect - Change in stack depth
+     *  @return:    None
+     * */
+    void emit(std::vector<int32_t>& code, int32_t op, int effect);
+
+    /*
+     *  skipspace()
+     *
+     *  @desc:      Advances the source past whitespace
+     * */
+    void skipspace();
+
+    /*
+     *  eval()
+     *
+     *  @desc:      Runs a compiled condition against the current CPU state
+     *  @param:     code - Compiled program
+     *              memory - 6502 memory
+     *  @return:    Value of the condition
+     * */
+    int32_t eval(const std::vector<int32_t>& code, const mem_6502& memory) const;
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a debugger attached to cpu, setting breakpoints in memory.
+    debug_6502(cpu_6502& cpu, mem_6502& memory);
+
+    // Detaches from the cpu and removes all breakpoints.
+    ~debug_6502();
+
+    debug_6502(const debug_6502&) = delete;
+    debug_6502& operator=(const debug_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  addbreak()
+     *
+     *  @desc:      Adds a breakpoint, compiling its condition once
+     *  @param:     pc - Address of the instruction to stop before
+     *              cond - Condition such as "A == 0x42 && X > 3", or nullptr
+     *                     to always stop
+     *  @return:    Breakpoint id, or -1 if the condition does not compile
+     *  @note:      Conditions may use the registers A X Y SP PC P, the flags
+     *              C Z I D B V N, numbers ($FF, 0xFF, %1111, 255), memory
+     *              reads [addr], and the C operators ! ~ - * + - < <= > >=
+     *              == != & ^ | && || with C precedence.
+     * */
+    int addbreak(word pc, const char* cond = nullptr);
+
+    /*
+     *  delbreak()
+     *
+     *  @desc:      Removes a breakpoint
+     *  @param:     id - Breakpoint id returned by addbreak()
+     *  @return:    true if the breakpoint existed
+     * */
+    bool delbreak(int id);
+
+    /*
+     *  enablebreak()
+     *
+     *  @desc:      Enables or disables a breakpoint without removing it
+     *  @param:     id - Breakpoint id returned by addbreak()
+     *              on - true to enable
+     *  @return:    true if the breakpoint existed
+     * */
+    bool enablebreak(int id, bool on);
+
+    /*
+     *  clearbreaks()
+     *
+     *  @desc:      Removes all breakpoints
+     *  @param:     None
+     *  @return:    None
+     * */
+    void clearbreaks();
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  check()
+     *
+     *  @desc:      Called by the cpu before executing an opcode on a page
+     *              holding a breakpoint
+     *  @param:     pc - Address of the opcode
+     *              memory - 6502 memory
+     *  @return:    true if an enabled breakpoint at pc has a true condition
+     * */
+    bool check(word pc, mem_6502& memory);
+
+    /*
+     *  hasbreak()
+     *
+     *  @desc:      Returns true if any breakpoint is set at pc
+     * */
+    bool hasbreak(word pc) const;
+
+    /*
+     *  lastbreak()
+     *
+     *  @desc:      Returns the breakpoint that last stopped execution, or
+     *              nullptr
+     * */
+    const break_6502* lastbreak() const;
+
+    /*
+     *  getbreaks()
+     *
+     *  @desc:      Returns the list of breakpoints
+     * */
+    const std::vector<break_6502>& getbreaks() const;
+
+    /*
+     *  geterror()
+     *
+     *  @desc:      Returns the reason the last addbreak() failed
+     * */
+    const std::string& geterror() const;
+};
+
+#endif //INC_6502_DEBUG_6502_H
@@ -0,0 +1,211 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       diff_6502.cpp
+ * @desc:       Source file for 6502 differential testing engine
+ *****************************************************************************/
+
+#include "diff_6502.h"
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates an engine over two backends and their memories, which must
+// hold the same image and register state before run().
+diff_6502::diff_6502(cpu_6502& a, mem_6502& memorya, cpu_6502& b, mem_6502& memoryb)
+        : cpua(a), cpub(b), mema(memorya), memb(memoryb){
+    checked = 0;
+    mema.setwritelog(&loga);
+    memb.setwritelog(&logb);
+}
+
+// Stops logging writes.
+diff_6502::~diff_6502(){
+    mema.setwritelog(nullptr);
+    memb.setwritelog(nullptr);
+}
+
+
+// Other Functions ---------------------------------------------------------
+/*
+ *  run()
+ *
+ *  @desc:      Runs both sides in lockstep
+ *  @param:     cycles - Cycles to run for
+ *              block - Cycles per comparison; 1 compares after every
+ *                      instruction
+ *  @return:    true if no divergence was found, otherwise report()
+ *              describes the first differing instruction and both
+ *              sides are left just after it
+ * */
+bool diff_6502::run(uint64_t cycles, int32_t block){
+    // snapshots live across calls, a block is at most 2 x 64 KiB to copy
+    static thread_local mem_6502 savea, saveb;
+    why.clear();
+
+    uint64_t end = cpua.getclock() + cycles;
+    while(cpua.getclock() < end){
+        uint64_t left = end - cpua.getclock();
+        int32_t slice = left < (uint64_t)block ? (int32_t)left : block;
+        cpu_6502 snapa = cpua;
+        cpu_6502 snapb = cpub;
+        if(slice > 1){
+            savea = mema;
+            saveb = memb;
+        }
+        uint64_t before = cpua.getretired();
+        loga.clear();
+        logb.clear();
+
+        cpua.execute(slice, mema);
+        cpub.execute(slice, memb);
+        if(!compare()){
+            if(slice > 1){
+                bisect(snapa, snapb, savea, saveb, slice);
+            } else {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "at $%04X after %llu instructions: ",
+                         snapa.getregs().PC, (unsigned long long)checked);
+                why = buf + why;
+            }
+            return false;
+        }
+        checked += cpua.getretired() - before;
+    }
+    return true;
+}
+
+/*
+ *  compare()
+ *
+ *  @desc:      Compares registers, clocks and write logs of both sides
+ *  @return:    true if they agree
+ * */
+bool diff_6502::compare(){
+    regs_6502 a = cpua.getregs();
+    regs_6502 b = cpub.getregs();
+    char buf[256];
+
+    if(a.PC != b.PC || a.SP != b.SP || a.A != b.A || a.X != b.X || a.Y != b.Y || a.P != b.P){
+        snprintf(buf, sizeof(buf),
+                 "registers differ: A pc=%04X s=%02X a=%02X x=%02X y=%02X p=%02X, "
+                 "B pc=%04X s=%02X a=%02X x=%02X y=%02X p=%02X",
+                 a.PC, a.SP, a.A, a.X, a.Y, a.P, b.PC, b.SP, b.A, b.X, b.Y, b.P);
+        why = buf;
+        return false;
+    }
+    if(cpua.getclock() != cpub.getclock()){
+        snprintf(buf, sizeof(buf), "cycle counts differ: A %llu, B %llu",
+                 (unsigned long long)cpua.getclock(), (unsigned long long)cpub.getclock());
+        why = buf;
+        return false;
+    }
+    if(loga != logb){
+        size_t i = 0;
+        while(i < loga.size() && i < logb.size() && loga[i] == logb[i]){
+            i++;
+        }
+        std::string sa = i < loga.size() ? "" : "none";
+        std::string sb = i < logb.size() ? "" : "none";
+        if(i < loga.size()){
+            snprintf(buf, sizeof(buf), "$%02X->$%04X", loga[i].value, loga[i].addr);
+            sa = buf;
+        }
+        if(i < logb.size()){
+            snprintf(buf, sizeof(buf), "$%02X->$%04X", logb[i].value, logb[i].addr);
+            sb = buf;
+        }
+        why = "memory writes differ at write " + std::to_string(i) + ": A " + sa + ", B " + sb;
+        return false;
+    }
+    return true;
+}
+
+/*
+ *  replay()
+ *
+ *  @desc:      Restores both sides from the snapshots of a block and
+ *              runs them for part of it
+ *  @param:     snapa, snapb - CPU state at the start of the block
+ *              savea, saveb - Memory at the start of the block
+ *              cycles - Cycles to run, 0 to only restore
+ *  @return:    true if both sides agree afterwards
+ * */
+bool diff_6502::replay(const cpu_6502& snapa, const cpu_6502& snapb,
+                       const mem_6502& savea, const mem_6502& saveb, int32_t cycles){
+    cpua = snapa;
+    cpub = snapb;
+    mema = savea;
+    memb = saveb;
+    loga.clear();
+    logb.clear();
+    if(cycles > 0){
+        cpua.execute(cycles, mema);
+        cpub.execute(cycles, memb);
+    }
+    return compare();
+}
+
+/*
+ *  bisect()
+ *
+ *  @desc:      Finds the shortest replay of a diverging block that
+ *              still diverges and builds the report
+ *  @param:     snapa, snapb - CPU state at the start of the block
+ *              savea, saveb - Memory at the start of the block
+ *              slice - Cycles the block ran for
+ *  @return:    None
+ * */
+void diff_6502::bisect(const cpu_6502& snapa, const cpu_6502& snapb,
+                       const mem_6502& savea, const mem_6502& saveb, int32_t slice){
+    // single steps never fuse, so the block is replayed whole with a budget
+    // one cycle apart from one that agrees; a pair fuses when cycles are
+    // left after its first instruction, so the agreeing replay stops right
+    // before the instruction that differs
+    std::string blockwhy = why;
+    int32_t agree = 0;
+    int32_t differ = slice;
+    while(differ - agree > 1){
+        int32_t mid = agree + (differ - agree) / 2;
+        if(replay(snapa, snapb, savea, saveb, mid)){
+            agree = mid;
+        } else {
+            differ = mid;
+        }
+    }
+
+    replay(snapa, snapb, savea, saveb, agree);
+    regs_6502 pre = cpua.getregs();
+    byte op[3] = {mema[pre.PC], mema[(pre.PC + 1) & 0xFFFF], mema[(pre.PC + 2) & 0xFFFF]};
+    checked += cpua.getretired() - snapa.getretired();
+    if(replay(snapa, snapb, savea, saveb, differ)){
+        why = "block diverged but its replays agree: " + blockwhy;
+        return;
+    }
+    char buf[96];
+    snprintf(buf, sizeof(buf), "at $%04X (%02X %02X %02X) after %llu instructions: ",
+             pre.PC, op[0], op[1], op[2], (unsigned long long)checked);
+    why = buf + why;
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  report()
+ *
+ *  @desc:      Returns the description of the divergence
+ * */
+const std::string& diff_6502::report() const{
+    return why;
+}
+
+/*
+ *  getchecked()
+ *
+ *  @desc:      Returns the number of instructions found to agree
+ * */
+uint64_t diff_6502::getchecked() const{
+    return checked;
+}
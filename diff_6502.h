@@ -0,0 +1,123 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       diff_6502.h
+ * @desc:       Header file for 6502 differential testing engine
+ *****************************************************************************/
+
+#ifndef INC_6502_DIFF_6502_H
+#define INC_6502_DIFF_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include <string>
+#include <vector>
+
+/*
+ *  class diff_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Runs two CPU backends in lockstep on their own copies of the
+ *              same memory and stops at the first instruction where their
+ *              registers, cycle counts or memory writes differ.
+ *  @note:      Both sides run a block of cycles at full speed and are only
+ *              compared at the block boundary. The blocks are snapshotted
+ *              first, so a diverging block is replayed with ever shorter
+ *              budgets to pin down the differing instruction. Budgets
+ *              rather than single steps keep superinstructions fused.
+ */
+class diff_6502 {
+private:
+    // Machine Fields
+    cpu_6502& cpua;
+    cpu_6502& cpub;
+    mem_6502& mema;
+    mem_6502& memb;
+
+    // Lockstep Fields
+    std::vector<mem_6502::memwrite_6502> loga, logb;
+    uint64_t checked;       // instructions known to agree
+    std::string why;
+
+    /*
+     *  replay()
+     *
+     *  @desc:      Restores both sides from the snapshots of a block and
+     *              runs them for part of it
+     *  @param:     snapa, snapb - CPU state at the start of the block
+     *              savea, saveb - Memory at the start of the block
+     *              cycles - Cycles to run, 0 to only restore
+     *  @return:    true if both sides agree afterwards
+     * */
+    bool replay(const cpu_6502& snapa, const cpu_6502& snapb,
+                const mem_6502& savea, const mem_6502& saveb, int32_t cycles);
+
+    /*
+     *  compare()
+     *
+     *  @desc:      Compares registers, clocks and write logs of both sides
+     *  @return:    true if they agree
+     * */
+    bool compare();
+
+    /*
+     *  bisect()
+     *
+     *  @desc:      Finds the shortest replay of a diverging block that
+     *              still diverges and builds the report
+     *  @param:     snapa, snapb - CPU state at the start of the block
+     *              savea, saveb - Memory at the start of the block
+     *              slice - Cycles the block ran for
+     *  @return:    None
+     * */
+    void bisect(const cpu_6502& snapa, const cpu_6502& snapb,
+                const mem_6502& savea, const mem_6502& saveb, int32_t slice);
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates an engine over two backends and their memories, which must
+    // hold the same image and register state before run().
+    diff_6502(cpu_6502& a, mem_6502& memorya, cpu_6502& b, mem_6502& memoryb);
+
+    // Stops logging writes.
+    ~diff_6502();
+
+    diff_6502(const diff_6502&) = delete;
+    diff_6502& operator=(const diff_6502&) = delete;
+
+    // Other Functions ---------------------------------------------------------
+    /*
+     *  run()
+     *
+     *  @desc:      Runs both sides in lockstep
+     *  @param:     cycles - Cycles to run for
+     *              block - Cycles per comparison; 1 compares after every
+     *                      instruction
+     *  @return:    true if no divergence was found, otherwise report()
+     *              describes the first differing instruction and both
+     *              sides are left just after it
+     * */
+    bool run(uint64_t cycles, int32_t block);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  report()
+     *
+     *  @desc:      Returns the description of the divergence
+     * */
+    const std::string& report() const;
+
+    /*
+     *  getchecked()
+     *
+     *  @desc:      Returns the number of instructions found to agree
+     * */
+    uint64_t getchecked() const;
+};
+
+#endif //INC_6502_DIFF_6502_H
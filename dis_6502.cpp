@@ -0,0 +1,659 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       dis_6502.cpp
+ * @desc:       Source file for 6502 static disassembler and control flow graph
+ * @ref:        http://www.6502.org/users/obelisk/
+ *              https://www.masswerk.at/6502/6502_instruction_set.html
+ *****************************************************************************/
+
+#include "dis_6502.h"
+
+// data runs of one repeated byte at least this long are listed as .fill
+static constexpr uint32_t FILL_MIN = 16;
+
+// data bytes per .byte line
+static constexpr uint32_t BYTES_PER_LINE = 8;
+
+// operand bytes of each addressing mode
+static constexpr byte OPERANDS[] = {
+        0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 1, 1, 1
+};
+
+const dis_6502::opinfo_6502 dis_6502::OPS[0x100] = {
+        // $00
+        {BRK,      "BRK", MODE_IMP,  FLOW_STOP,     7, false, false},
+        {ORA_INDX, "ORA", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {JAM_02,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {SLO_INDX, "SLO", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {NOP_04,   "NOP", MODE_ZP,   FLOW_NEXT,     3, false, true},
+        {ORA_ZP,   "ORA", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {ASL_ZP,   "ASL", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {SLO_ZP,   "SLO", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {PHP,      "PHP", MODE_IMP,  FLOW_NEXT,     3, false, false},
+        {ORA_IM,   "ORA", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {ASL_ACC,  "ASL", MODE_ACC,  FLOW_NEXT,     2, false, false},
+        {ANC_IM,   "ANC", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {NOP_0C,   "NOP", MODE_ABS,  FLOW_NEXT,     4, false, true},
+        {ORA_ABS,  "ORA", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {ASL_ABS,  "ASL", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {SLO_ABS,  "SLO", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $10
+        {BPL,      "BPL", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {ORA_INDY, "ORA", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_12,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {SLO_INDY, "SLO", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_14,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {ORA_ZPX,  "ORA", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {ASL_ZPX,  "ASL", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {SLO_ZPX,  "SLO", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {CLC,      "CLC", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {ORA_ABSY, "ORA", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_1A,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {SLO_ABSY, "SLO", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_1C,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {ORA_ABSX, "ORA", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {ASL_ABSX, "ASL", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {SLO_ABSX, "SLO", MODE_ABSX, FLOW_NEXT,     7, false, true},
+        // $20
+        {JSR,      "JSR", MODE_ABS,  FLOW_CALL,     6, false, false},
+        {AND_INDX, "AND", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {JAM_22,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {RLA_INDX, "RLA", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {BIT_ZP,   "BIT", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {AND_ZP,   "AND", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {ROL_ZP,   "ROL", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {RLA_ZP,   "RLA", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {PLP,      "PLP", MODE_IMP,  FLOW_NEXT,     4, false, false},
+        {AND_IM,   "AND", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {ROL_ACC,  "ROL", MODE_ACC,  FLOW_NEXT,     2, false, false},
+        {ANC_2B,   "ANC", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {BIT_ABS,  "BIT", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {AND_ABS,  "AND", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {ROL_ABS,  "ROL", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {RLA_ABS,  "RLA", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $30
+        {BMI,      "BMI", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {AND_INDY, "AND", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_32,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {RLA_INDY, "RLA", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_34,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {AND_ZPX,  "AND", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {ROL_ZPX,  "ROL", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {RLA_ZPX,  "RLA", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {SEC,      "SEC", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {AND_ABSY, "AND", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_3A,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {RLA_ABSY, "RLA", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_3C,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {AND_ABSX, "AND", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {ROL_ABSX, "ROL", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {RLA_ABSX, "RLA", MODE_ABSX, FLOW_NEXT,     7, false, true},
+        // $40
+        {RTI,      "RTI", MODE_IMP,  FLOW_RETURN,   6, false, false},
+        {EOR_INDX, "EOR", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {JAM_42,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {SRE_INDX, "SRE", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {NOP_44,   "NOP", MODE_ZP,   FLOW_NEXT,     3, false, true},
+        {EOR_ZP,   "EOR", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {LSR_ZP,   "LSR", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {SRE_ZP,   "SRE", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {PHA,      "PHA", MODE_IMP,  FLOW_NEXT,     3, false, false},
+        {EOR_IM,   "EOR", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {LSR_ACC,  "LSR", MODE_ACC,  FLOW_NEXT,     2, false, false},
+        {ALR_IM,   "ALR", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {JMP_ABS,  "JMP", MODE_ABS,  FLOW_JUMP,     3, false, false},
+        {EOR_ABS,  "EOR", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {LSR_ABS,  "LSR", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {SRE_ABS,  "SRE", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $50
+        {BVC,      "BVC", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {EOR_INDY, "EOR", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_52,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {SRE_INDY, "SRE", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_54,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {EOR_ZPX,  "EOR", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {LSR_ZPX,  "LSR", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {SRE_ZPX,  "SRE", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {CLI,      "CLI", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {EOR_ABSY, "EOR", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_5A,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {SRE_ABSY, "SRE", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_5C,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {EOR_ABSX, "EOR", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {LSR_ABSX, "LSR", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {SRE_ABSX, "SRE", MODE_ABSX, FLOW_NEXT,     7, false, true},
+        // $60
+        {RTS,      "RTS", MODE_IMP,  FLOW_RETURN,   6, false, false},
+        {ADC_INDX, "ADC", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {JAM_62,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {RRA_INDX, "RRA", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {NOP_64,   "NOP", MODE_ZP,   FLOW_NEXT,     3, false, true},
+        {ADC_ZP,   "ADC", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {ROR_ZP,   "ROR", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {RRA_ZP,   "RRA", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {PLA,      "PLA", MODE_IMP,  FLOW_NEXT,     4, false, false},
+        {ADC_IM,   "ADC", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {ROR_ACC,  "ROR", MODE_ACC,  FLOW_NEXT,     2, false, false},
+        {ARR_IM,   "ARR", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {JMP_IND,  "JMP", MODE_IND,  FLOW_INDIRECT, 5, false, false},
+        {ADC_ABS,  "ADC", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {ROR_ABS,  "ROR", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {RRA_ABS,  "RRA", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $70
+        {BVS,      "BVS", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {ADC_INDY, "ADC", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_72,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {RRA_INDY, "RRA", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_74,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {ADC_ZPX,  "ADC", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {ROR_ZPX,  "ROR", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {RRA_ZPX,  "RRA", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {SEI,      "SEI", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {ADC_ABSY, "ADC", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_7A,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {RRA_ABSY, "RRA", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_7C,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {ADC_ABSX, "ADC", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {ROR_ABSX, "ROR", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {RRA_ABSX, "RRA", MODE_ABSX, FLOW_NEXT,     7, false, true},
+        // $80
+        {NOP_80,   "NOP", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {STA_INDX, "STA", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {NOP_82,   "NOP", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {SAX_INDX, "SAX", MODE_INDX, FLOW_NEXT,     6, false, true},
+        {STY_ZP,   "STY", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {STA_ZP,   "STA", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {STX_ZP,   "STX", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {SAX_ZP,   "SAX", MODE_ZP,   FLOW_NEXT,     3, false, true},
+        {DEY,      "DEY", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {NOP_89,   "NOP", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {TXA,      "TXA", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {ANE_IM,   "ANE", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {STY_ABS,  "STY", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {STA_ABS,  "STA", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {STX_ABS,  "STX", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {SAX_ABS,  "SAX", MODE_ABS,  FLOW_NEXT,     4, false, true},
+        // $90
+        {BCC,      "BCC", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {STA_INDY, "STA", MODE_INDY, FLOW_NEXT,     6, false, false},
+        {JAM_92,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {SHA_INDY, "SHA", MODE_INDY, FLOW_NEXT,     6, false, true},
+        {STY_ZPX,  "STY", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {STA_ZPX,  "STA", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {STX_ZPY,  "STX", MODE_ZPY,  FLOW_NEXT,     4, false, false},
+        {SAX_ZPY,  "SAX", MODE_ZPY,  FLOW_NEXT,     4, false, true},
+        {TYA,      "TYA", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {STA_ABSY, "STA", MODE_ABSY, FLOW_NEXT,     5, false, false},
+        {TXS,      "TXS", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {TAS_ABSY, "TAS", MODE_ABSY, FLOW_NEXT,     5, false, true},
+        {SHY_ABSX, "SHY", MODE_ABSX, FLOW_NEXT,     5, false, true},
+        {STA_ABSX, "STA", MODE_ABSX, FLOW_NEXT,     5, false, false},
+        {SHX_ABSY, "SHX", MODE_ABSY, FLOW_NEXT,     5, false, true},
+        {SHA_ABSY, "SHA", MODE_ABSY, FLOW_NEXT,     5, false, true},
+        // $A0
+        {LDY_IM,   "LDY", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {LDA_INDX, "LDA", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {LDX_IM,   "LDX", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {LAX_INDX, "LAX", MODE_INDX, FLOW_NEXT,     6, false, true},
+        {LDY_ZP,   "LDY", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {LDA_ZP,   "LDA", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {LDX_ZP,   "LDX", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {LAX_ZP,   "LAX", MODE_ZP,   FLOW_NEXT,     3, false, true},
+        {TAY,      "TAY", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {LDA_IM,   "LDA", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {TAX,      "TAX", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {LXA_IM,   "LXA", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {LDY_ABS,  "LDY", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {LDA_ABS,  "LDA", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {LDX_ABS,  "LDX", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {LAX_ABS,  "LAX", MODE_ABS,  FLOW_NEXT,     4, false, true},
+        // $B0
+        {BCS,      "BCS", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {LDA_INDY, "LDA", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_B2,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {LAX_INDY, "LAX", MODE_INDY, FLOW_NEXT,     5, true,  true},
+        {LDY_ZPX,  "LDY", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {LDA_ZPX,  "LDA", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {LDX_ZPY,  "LDX", MODE_ZPY,  FLOW_NEXT,     4, false, false},
+        {LAX_ZPY,  "LAX", MODE_ZPY,  FLOW_NEXT,     4, false, true},
+        {CLV,      "CLV", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {LDA_ABSY, "LDA", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {TSX,      "TSX", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {LAS_ABSY, "LAS", MODE_ABSY, FLOW_NEXT,     4, true,  true},
+        {LDY_ABSX, "LDY", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {LDA_ABSX, "LDA", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {LDX_ABSY, "LDX", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {LAX_ABSY, "LAX", MODE_ABSY, FLOW_NEXT,     4, true,  true},
+        // $C0
+        {CPY_IM,   "CPY", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {CMP_INDX, "CMP", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {NOP_C2,   "NOP", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {DCP_INDX, "DCP", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {CPY_ZP,   "CPY", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {CMP_ZP,   "CMP", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {DEC_ZP,   "DEC", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {DCP_ZP,   "DCP", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {INY,      "INY", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {CMP_IM,   "CMP", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {DEX,      "DEX", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {SBX_IM,   "SBX", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {CPY_ABS,  "CPY", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {CMP_ABS,  "CMP", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {DEC_ABS,  "DEC", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {DCP_ABS,  "DCP", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $D0
+        {BNE,      "BNE", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {CMP_INDY, "CMP", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_D2,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {DCP_INDY, "DCP", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_D4,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {CMP_ZPX,  "CMP", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {DEC_ZPX,  "DEC", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {DCP_ZPX,  "DCP", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {CLD,      "CLD", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {CMP_ABSY, "CMP", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_DA,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {DCP_ABSY, "DCP", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_DC,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {CMP_ABSX, "CMP", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {DEC_ABSX, "DEC", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {DCP_ABSX, "DCP", MODE_ABSX, FLOW_NEXT,     7, false, true},
+        // $E0
+        {CPX_IM,   "CPX", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {SBC_INDX, "SBC", MODE_INDX, FLOW_NEXT,     6, false, false},
+        {NOP_E2,   "NOP", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {ISC_INDX, "ISC", MODE_INDX, FLOW_NEXT,     8, false, true},
+        {CPX_ZP,   "CPX", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {SBC_ZP,   "SBC", MODE_ZP,   FLOW_NEXT,     3, false, false},
+        {INC_ZP,   "INC", MODE_ZP,   FLOW_NEXT,     5, false, false},
+        {ISC_ZP,   "ISC", MODE_ZP,   FLOW_NEXT,     5, false, true},
+        {INX,      "INX", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {SBC_IM,   "SBC", MODE_IMM,  FLOW_NEXT,     2, false, false},
+        {NOP,      "NOP", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {SBC_EB,   "SBC", MODE_IMM,  FLOW_NEXT,     2, false, true},
+        {CPX_ABS,  "CPX", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {SBC_ABS,  "SBC", MODE_ABS,  FLOW_NEXT,     4, false, false},
+        {INC_ABS,  "INC", MODE_ABS,  FLOW_NEXT,     6, false, false},
+        {ISC_ABS,  "ISC", MODE_ABS,  FLOW_NEXT,     6, false, true},
+        // $F0
+        {BEQ,      "BEQ", MODE_REL,  FLOW_BRANCH,   2, false, false},
+        {SBC_INDY, "SBC", MODE_INDY, FLOW_NEXT,     5, true,  false},
+        {JAM_F2,   "JAM", MODE_IMP,  FLOW_STOP,     0, false, true},
+        {ISC_INDY, "ISC", MODE_INDY, FLOW_NEXT,     8, false, true},
+        {NOP_F4,   "NOP", MODE_ZPX,  FLOW_NEXT,     4, false, true},
+        {SBC_ZPX,  "SBC", MODE_ZPX,  FLOW_NEXT,     4, false, false},
+        {INC_ZPX,  "INC", MODE_ZPX,  FLOW_NEXT,     6, false, false},
+        {ISC_ZPX,  "ISC", MODE_ZPX,  FLOW_NEXT,     6, false, true},
+        {SED,      "SED", MODE_IMP,  FLOW_NEXT,     2, false, false},
+        {SBC_ABSY, "SBC", MODE_ABSY, FLOW_NEXT,     4, true,  false},
+        {NOP_FA,   "NOP", MODE_IMP,  FLOW_NEXT,     2, false, true},
+        {ISC_ABSY, "ISC", MODE_ABSY, FLOW_NEXT,     7, false, true},
+        {NOP_FC,   "NOP", MODE_ABSX, FLOW_NEXT,     4, true,  true},
+        {SBC_ABSX, "SBC", MODE_ABSX, FLOW_NEXT,     4, true,  false},
+        {INC_ABSX, "INC", MODE_ABSX, FLOW_NEXT,     7, false, false},
+        {ISC_ABSX, "ISC", MODE_ABSX, FLOW_NEXT,     7, false, true}
+};
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Copies the image to analyse out of memory; later writes to memory are
+// not seen.
+dis_6502::dis_6502(const mem_6502& memory){
+    for(uint32_t addr = 0; addr < 0x10000; addr++){
+        image[addr] = memory.fetch((word)addr);
+    }
+    memset(flags, 0, sizeof(flags));
+    insts = 0;
+    overlaps = 0;
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  addentry()
+ *
+ *  @desc:      Adds an address execution can start from
+ *  @param:     addr - Entry point
+ *  @return:    None
+ * */
+void dis_6502::addentry(word addr){
+    entries.push_back(addr);
+}
+
+/*
+ *  addvectors()
+ *
+ *  @desc:      Adds the NMI, reset and IRQ vector targets as entry points
+ *  @return:    None
+ * */
+void dis_6502::addvectors(){
+    for(uint32_t vector = 0xFFFA; vector < 0x10000; vector += 2){
+        addentry((word)(image[vector] | image[vector + 1] << 8));
+    }
+}
+
+/*
+ *  explore()
+ *
+ *  @desc:      Recursively disassembles from every entry point and builds
+ *              the basic blocks
+ *  @return:    Number of instructions decoded
+ * */
+uint32_t dis_6502::explore(){
+    // an explicit work list rather than recursion, call chains in real
+    // firmware are deep enough to matter
+    std::vector<word> work;
+    for(word addr : entries){
+        flags[addr] |= BYTE_ENTRY;
+        mark(addr, work);
+    }
+    while(!work.empty()){
+        word addr = work.back();
+        work.pop_back();
+        decode(addr, work);
+    }
+    buildblocks();
+    return insts;
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  info()
+ *
+ *  @desc:      Returns the table entry of an opcode
+ *  @param:     opcode - Opcode byte
+ *  @return:    Opcode information
+ * */
+const dis_6502::opinfo_6502& dis_6502::info(byte opcode){
+    return OPS[opcode];
+}
+
+/*
+ *  length()
+ *
+ *  @desc:      Returns the length of an instruction in bytes
+ *  @param:     opcode - Opcode byte
+ *  @return:    1, 2 or 3
+ * */
+byte dis_6502::length(byte opcode){
+    return 1 + OPERANDS[OPS[opcode].mode];
+}
+
+/*
+ *  format()
+ *
+ *  @desc:      Disassembles the instruction at addr
+ *  @param:     addr - Address of the instruction
+ *              buf, size - Receives the text, e.g. "LDA $1234,X"
+ *  @return:    Length of the instruction
+ * */
+byte dis_6502::format(word addr, char* buf, size_t size) const{
+    const opinfo_6502& op = OPS[image[addr]];
+    byte lo = image[(word)(addr + 1)];
+    word abs = lo | image[(word)(addr + 2)] << 8;
+
+    switch(op.mode){
+        case MODE_IMP:  snprintf(buf, size, "%s", op.name); break;
+        case MODE_ACC:  snprintf(buf, size, "%s A", op.name); break;
+        case MODE_IMM:  snprintf(buf, size, "%s #$%02X", op.name, lo); break;
+        case MODE_ZP:   snprintf(buf, size, "%s $%02X", op.name, lo); break;
+        case MODE_ZPX:  snprintf(buf, size, "%s $%02X,X", op.name, lo); break;
+        case MODE_ZPY:  snprintf(buf, size, "%s $%02X,Y", op.name, lo); break;
+        case MODE_ABS:  snprintf(buf, size, "%s $%04X", op.name, abs); break;
+        case MODE_ABSX: snprintf(buf, size, "%s $%04X,X", op.name, abs); break;
+        case MODE_ABSY: snprintf(buf, size, "%s $%04X,Y", op.name, abs); break;
+        case MODE_IND:  snprintf(buf, size, "%s ($%04X)", op.name, abs); break;
+        case MODE_INDX: snprintf(buf, size, "%s ($%02X,X)", op.name, lo); break;
+        case MODE_INDY: snprintf(buf, size, "%s ($%02X),Y", op.name, lo); break;
+        default:        snprintf(buf, size, "%s $%04X", op.name, target(addr)); break;
+    }
+    return length(image[addr]);
+}
+
+/*
+ *  findblock()
+ *
+ *  @desc:      Returns the block starting at addr
+ *  @param:     addr - Leader address
+ *  @return:    Index into getblocks(), -1 if no block starts there
+ * */
+int32_t dis_6502::findblock(word addr) const{
+    // blocks are built in address order
+    size_t lo = 0, hi = blocks.size();
+    while(lo < hi){
+        size_t mid = (lo + hi) / 2;
+        if(blocks[mid].start < addr){
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < blocks.size() && blocks[lo].start == addr ? (int32_t)lo : -1;
+}
+
+
+// Output functions --------------------------------------------------------
+/*
+ *  linear()
+ *
+ *  @desc:      Prints a linear sweep listing, decoding every byte in the
+ *              range as code
+ *  @param:     file - Output stream
+ *              from, to - Inclusive address range
+ *  @return:    None
+ * */
+void dis_6502::linear(FILE* file, word from, word to) const{
+    for(uint32_t addr = from; addr <= to;){
+        addr += printinst(file, (word)addr);
+    }
+}
+
+/*
+ *  listing()
+ *
+ *  @desc:      Prints the image as explored, code by block and
+ *              everything else as data bytes
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void dis_6502::listing(FILE* file) const{
+    fprintf(file, "; %u instructions in %zu blocks", insts, blocks.size());
+    if(overlaps > 0){
+        fprintf(file, ", %u byte%s decoded both as opcode and operand", overlaps,
+                overlaps == 1 ? "" : "s");
+    }
+    fprintf(file, "\n");
+
+    uint32_t addr = 0;
+    while(addr < 0x10000){
+        if(flags[addr] & BYTE_CODE){
+            if(flags[addr] & BYTE_LEADER){
+                fprintf(file, "\nL%04X:%s\n", addr, flags[addr] & BYTE_ENTRY ? "  ; entry" : "");
+            }
+            byte len = printinst(file, (word)addr);
+            for(byte i = 1; i < len && addr + i < 0x10000; i++){
+                if(flags[addr + i] & BYTE_CODE){
+                    char text[32];
+                    format((word)(addr + i), text, sizeof(text));
+                    fprintf(file, "    %04X            ; also entered here: %s\n", addr + i, text);
+                }
+            }
+            addr += len;
+            continue;
+        }
+
+        // data up to the next instruction, operands of an instruction only
+        // entered off its first byte included
+        uint32_t end = addr;
+        while(end < 0x10000 && !(flags[end] & BYTE_CODE)){
+            end++;
+        }
+        while(addr < end){
+            uint32_t run = 1;
+            while(addr + run < end && image[addr + run] == image[addr]){
+                run++;
+            }
+            if(run >= FILL_MIN){
+                fprintf(file, "    %04X  .fill %u, $%02X\n", addr, run, image[addr]);
+                addr += run;
+                continue;
+            }
+            uint32_t n = end - addr < BYTES_PER_LINE ? end - addr : BYTES_PER_LINE;
+            fprintf(file, "    %04X  .byte ", addr);
+            for(uint32_t i = 0; i < n; i++){
+                fprintf(file, i ? ",$%02X" : "$%02X", image[addr + i]);
+            }
+            fprintf(file, "\n");
+            addr += n;
+        }
+    }
+}
+
+/*
+ *  writedot()
+ *
+ *  @desc:      Prints the control flow graph in Graphviz DOT
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void dis_6502::writedot(FILE* file) const{
+    fprintf(file, "digraph cfg {\n");
+    fprintf(file, "    node [shape=box, fontname=\"monospace\"];\n");
+    for(const block_6502& b : blocks){
+        fprintf(file, "    b%04X [label=\"L%04X:\\l", b.start, b.start);
+        char text[32];
+        for(uint32_t addr = b.start; addr < b.end;){
+            addr += format((word)addr, text, sizeof(text));
+            fprintf(file, "  %s\\l", text);
+        }
+        fprintf(file, "\"%s];\n", flags[b.start] & BYTE_ENTRY ? ", penwidth=2" : "");
+    }
+    for(const block_6502& b : blocks){
+        if(b.target >= 0){
+            const char* style = b.flow == FLOW_CALL ? " [style=dashed]"
+                              : b.flow == FLOW_BRANCH ? " [label=\"T\"]" : "";
+            fprintf(file, "    b%04X -> b%04X%s;\n", b.start, b.target, style);
+        }
+        if(b.next >= 0){
+            fprintf(file, "    b%04X -> b%04X%s;\n", b.start, b.next,
+                    b.flow == FLOW_BRANCH ? " [label=\"F\"]" : "");
+        }
+    }
+    fprintf(file, "}\n");
+}
+
+
+// Private helpers ---------------------------------------------------------
+byte dis_6502::printinst(FILE* file, word addr) const{
+    char text[32];
+    byte len = format(addr, text, sizeof(text));
+    char hex[12];
+    int at = 0;
+    for(byte i = 0; i < len; i++){
+        at += snprintf(hex + at, sizeof(hex) - at, i ? " %02X" : "%02X", image[(word)(addr + i)]);
+    }
+    fprintf(file, "    %04X  %-8s  %s\n", addr, hex, text);
+    return len;
+}
+
+void dis_6502::mark(word addr, std::vector<word>& work){
+    if(!(flags[addr] & BYTE_LEADER)){
+        flags[addr] |= BYTE_LEADER;
+        work.push_back(addr);
+    }
+}
+
+void dis_6502::decode(word addr, std::vector<word>& work){
+    for(;;){
+        if(flags[addr] & BYTE_CODE){
+            // ran into decoded code, which is entered from two places now
+            flags[addr] |= BYTE_LEADER;
+            return;
+        }
+        const opinfo_6502& op = OPS[image[addr]];
+        byte len = 1 + OPERANDS[op.mode];
+        if(flags[addr] & BYTE_OPERAND){
+            flags[addr] |= BYTE_OVERLAP;
+            overlaps++;
+        }
+        flags[addr] |= BYTE_CODE;
+        for(byte i = 1; i < len; i++){
+            word at = (word)(addr + i);
+            if(flags[at] & BYTE_CODE){
+                flags[at] |= BYTE_OVERLAP;
+                overlaps++;
+            }
+            flags[at] |= BYTE_OPERAND;
+        }
+        insts++;
+
+        word next = (word)(addr + len);
+        switch(op.flow){
+            case FLOW_NEXT:
+                addr = next;
+                continue;
+            case FLOW_BRANCH:
+                mark((word)target(addr), work);
+                mark(next, work);
+                return;
+            case FLOW_JUMP:
+                mark((word)target(addr), work);
+                return;
+            case FLOW_CALL:
+                // assumes the subroutine returns
+                flags[(word)target(addr)] |= BYTE_ENTRY;
+                mark((word)target(addr), work);
+                mark(next, work);
+                return;
+            default:
+                return;
+        }
+    }
+}
+
+void dis_6502::buildblocks(){
+    blocks.clear();
+    for(uint32_t start = 0; start < 0x10000; start++){
+        if((flags[start] & (BYTE_LEADER | BYTE_CODE)) != (BYTE_LEADER | BYTE_CODE)){
+            continue;
+        }
+        block_6502 b = {(word)start, (word)start, start, 0, FLOW_NEXT, -1, -1};
+        uint32_t addr = start;
+        for(;;){
+            const opinfo_6502& op = OPS[image[addr]];
+            b.last = (word)addr;
+            b.insts++;
+            addr += 1 + OPERANDS[op.mode];
+            if(op.flow != FLOW_NEXT){
+                b.flow = op.flow;
+                b.target = target(b.last);
+                if(op.flow == FLOW_BRANCH || op.flow == FLOW_CALL){
+                    b.next = (word)addr;
+                }
+                break;
+            }
+            if(addr >= 0x10000 || (flags[addr] & BYTE_LEADER)){
+                b.next = (word)addr;
+                break;
+            }
+        }
+        b.end = addr;
+        blocks.push_back(b);
+    }
+}
+
+int32_t dis_6502::target(word addr) const{
+    const opinfo_6502& op = OPS[image[addr]];
+    if(op.mode == MODE_REL){
+        return (word)(addr + 2 + (int8_t)image[(word)(addr + 1)]);
+    }
+    if(op.flow == FLOW_JUMP || op.flow == FLOW_CALL){
+        return image[(word)(addr + 1)] | image[(word)(addr + 2)] << 8;
+    }
+    return -1;
+}
@@ -0,0 +1,260 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       dis_6502.h
+ * @desc:       Header file for 6502 static disassembler and control flow graph
+ * @note:       explore() follows control flow from the entry points through
+ *              a copy of the image, marking every byte it decodes, and then
+ *              cuts the code into basic blocks at each branch target, call
+ *              target and return point. Everything is held in flat 64 KiB
+ *              arrays, so a full image takes a few milliseconds.
+ *****************************************************************************/
+
+#ifndef INC_6502_DIS_6502_H
+#define INC_6502_DIS_6502_H
+
+#include "6502.h"
+#include "mem_6502.h"
+#include <vector>
+
+class dis_6502 {
+public:
+    // addressing modes
+    static constexpr byte
+            MODE_IMP  = 0x00,
+            MODE_ACC  = 0x01,
+            MODE_IMM  = 0x02,
+            MODE_ZP   = 0x03,
+            MODE_ZPX  = 0x04,
+            MODE_ZPY  = 0x05,
+            MODE_ABS  = 0x06,
+            MODE_ABSX = 0x07,
+            MODE_ABSY = 0x08,
+            MODE_IND  = 0x09,
+            MODE_INDX = 0x0A,
+            MODE_INDY = 0x0B,
+            MODE_REL  = 0x0C;
+
+    // how an instruction passes control on
+    static constexpr byte
+            FLOW_NEXT     = 0x00,   // to the following instruction
+            FLOW_BRANCH   = 0x01,   // to its target or the following one
+            FLOW_JUMP     = 0x02,   // to its target
+            FLOW_INDIRECT = 0x03,   // through a pointer, unknown statically
+            FLOW_CALL     = 0x04,   // to its target, returning after it
+            FLOW_RETURN   = 0x05,   // RTS, RTI
+            FLOW_STOP     = 0x06;   // BRK, JAM
+
+    // per address flags set by explore()
+    static constexpr byte
+            BYTE_CODE    = 0x01,    // first byte of a decoded instruction
+            BYTE_OPERAND = 0x02,    // operand byte of a decoded instruction
+            BYTE_LEADER  = 0x04,    // first instruction of a basic block
+            BYTE_ENTRY   = 0x08,    // entry point or subroutine
+            BYTE_OVERLAP = 0x10;    // decoded both as opcode and operand
+
+    /*
+     *  struct opinfo_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      What the disassembler knows about one opcode
+     */
+    struct opinfo_6502 {
+        byte opcode;
+        const char* name;
+        byte mode;
+        byte flow;
+        byte cycles;        // NMOS cycles, branches not taken, 0 for JAM
+        bool cross;         // one more when the index crosses a page
+        bool undocumented;
+    };
+
+    /*
+     *  struct block_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      A basic block, entered only at start and left only after
+     *              its last instruction
+     */
+    struct block_6502 {
+        word start;
+        word last;          // address of the last instruction
+        uint32_t end;       // one past the last byte, past 0x10000 if the
+                            // last instruction wraps around $FFFF
+        uint32_t insts;
+        byte flow;          // flow of the last instruction
+        int32_t target;     // branch, jump or call target, -1 if none
+        int32_t next;       // fall through or return address, -1 if none
+    };
+
+private:
+    // every opcode, indexed by opcode
+    static const opinfo_6502 OPS[0x100];
+
+    // Image Fields
+    byte image[0x10000];
+    byte flags[0x10000];
+
+    // Analysis Fields
+    std::vector<word> entries;
+    std::vector<block_6502> blocks;
+    uint32_t insts;
+    uint32_t overlaps;
+
+    /*
+     *  decode()
+     *
+     *  @desc:      Marks the instructions of one path starting at addr and
+     *              queues the targets it leaves to
+     *  @param:     addr - First instruction
+     *              work - Addresses still to decode
+     *  @return:    None
+     * */
+    void decode(word addr, std::vector<word>& work);
+
+    /*
+     *  mark()
+     *
+     *  @desc:      Queues addr to be decoded and starts a block there
+     * */
+    void mark(word addr, std::vector<word>& work);
+
+    /*
+     *  buildblocks()
+     *
+     *  @desc:      Cuts the decoded code into blocks at the leaders
+     * */
+    void buildblocks();
+
+    /*
+     *  target()
+     *
+     *  @desc:      Returns the static target of the instruction at addr, -1
+     *              if it has none
+     * */
+    int32_t target(word addr) const;
+
+    /*
+     *  printinst()
+     *
+     *  @desc:      Prints one listing line: address, bytes and disassembly
+     *  @return:    Length of the instruction
+     * */
+    byte printinst(FILE* file, word addr) const;
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Copies the image to analyse out of memory; later writes to memory are
+    // not seen.
+    explicit dis_6502(const mem_6502& memory);
+
+    dis_6502(const dis_6502&) = delete;
+    dis_6502& operator=(const dis_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  addentry()
+     *
+     *  @desc:      Adds an address execution can start from
+     *  @param:     addr - Entry point
+     *  @return:    None
+     * */
+    void addentry(word addr);
+
+    /*
+     *  addvectors()
+     *
+     *  @desc:      Adds the NMI, reset and IRQ vector targets as entry points
+     *  @return:    None
+     * */
+    void addvectors();
+
+    /*
+     *  explore()
+     *
+     *  @desc:      Recursively disassembles from every entry point and builds
+     *              the basic blocks
+     *  @return:    Number of instructions decoded
+     * */
+    uint32_t explore();
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  info()
+     *
+     *  @desc:      Returns the table entry of an opcode
+     *  @param:     opcode - Opcode byte
+     *  @return:    Opcode information
+     * */
+    static const opinfo_6502& info(byte opcode);
+
+    /*
+     *  length()
+     *
+     *  @desc:      Returns the length of an instruction in bytes
+     *  @param:     opcode - Opcode byte
+     *  @return:    1, 2 or 3
+     * */
+    static byte length(byte opcode);
+
+    /*
+     *  format()
+     *
+     *  @desc:      Disassembles the instruction at addr
+     *  @param:     addr - Address of the instruction
+     *              buf, size - Receives the text, e.g. "LDA $1234,X"
+     *  @return:    Length of the instruction
+     * */
+    byte format(word addr, char* buf, size_t size) const;
+
+    /*
+     *  findblock()
+     *
+     *  @desc:      Returns the block starting at addr
+     *  @param:     addr - Leader address
+     *  @return:    Index into getblocks(), -1 if no block starts there
+     * */
+    int32_t findblock(word addr) const;
+
+    byte getbyte(word addr) const{ return image[addr]; }
+    byte getflags(word addr) const{ return flags[addr]; }
+    bool isleader(word addr) const{ return (flags[addr] & BYTE_LEADER) != 0; }
+    const std::vector<block_6502>& getblocks() const{ return blocks; }
+    uint32_t getinsts() const{ return insts; }
+    uint32_t getoverlaps() const{ return overlaps; }
+
+    // Output functions --------------------------------------------------------
+    /*
+     *  linear()
+     *
+     *  @desc:      Prints a linear sweep listing, decoding every byte in the
+     *              range as code
+     *  @param:     file - Output stream
+     *              from, to - Inclusive address range
+     *  @return:    None
+     * */
+    void linear(FILE* file, word from, word to) const;
+
+    /*
+     *  listing()
+     *
+     *  @desc:      Prints the image as explored, code by block and
+     *              everything else as data bytes
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void listing(FILE* file) const;
+
+    /*
+     *  writedot()
+     *
+     *  @desc:      Prints the control flow graph in Graphviz DOT
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void writedot(FILE* file) const;
+};
+
+#endif //INC_6502_DIS_6502_H
@@ -0,0 +1,281 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       fb_6502.cpp
+ * @desc:       Source file for the memory mapped framebuffer
+ *****************************************************************************/
+
+#include "fb_6502.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FB_SSSE3_6502
+#endif
+
+// glyph bytes of a full 256 character font
+static constexpr uint32_t FONT_BYTES = 256 * 8;
+
+// power-on palette, the C64 colours so that 0 and 1 are black and white
+static const byte PALETTE[16][3] = {
+    {0x00, 0x00, 0x00}, {0xFF, 0xFF, 0xFF}, {0x88, 0x00, 0x00}, {0xAA, 0xFF, 0xEE},
+    {0xCC, 0x44, 0xCC}, {0x00, 0xCC, 0x55}, {0x00, 0x00, 0xAA}, {0xEE, 0xEE, 0x77},
+    {0xDD, 0x88, 0x55}, {0x66, 0x44, 0x00}, {0xFF, 0x77, 0x77}, {0x33, 0x33, 0x33},
+    {0x77, 0x77, 0x77}, {0xAA, 0xFF, 0x66}, {0x00, 0x88, 0xFF}, {0xBB, 0xBB, 0xBB}
+};
+
+/*
+ *  expand4()
+ *
+ *  @desc:      Converts n bytes of 4bpp pixels to RGBA, one at a time
+ * */
+static void expand4(const byte* src, uint32_t* dst, uint32_t n, const uint32_t* palette){
+    for(uint32_t i = 0; i < n; i++){
+        dst[2 * i] = palette[src[i] >> 4];
+        dst[2 * i + 1] = palette[src[i] & 0x0F];
+    }
+}
+
+#ifdef FB_SSSE3_6502
+/*
+ *  expand4ssse3()
+ *
+ *  @desc:      Converts n bytes of 4bpp pixels to RGBA, 32 pixels at a time.
+ *              Each channel of the palette fits one register, so pshufb
+ *              looks up 16 pixels of a channel at once and the unpacks
+ *              interleave the four channels into RGBA.
+ * */
+__attribute__((target("ssse3")))
+static void expand4ssse3(const byte* src, uint32_t* dst, uint32_t n, const uint32_t* palette){
+    alignas(16) byte chan[4][16];
+    for(int i = 0; i < 16; i++){
+        for(int c = 0; c < 4; c++){
+            chan[c][i] = (byte)(palette[i] >> (8 * c));
+        }
+    }
+    const __m128i r = _mm_load_si128((const __m128i*)chan[0]);
+    const __m128i g = _mm_load_si128((const __m128i*)chan[1]);
+    const __m128i b = _mm_load_si128((const __m128i*)chan[2]);
+    const __m128i a = _mm_load_si128((const __m128i*)chan[3]);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+
+    uint32_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        __m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_and_si128(in, nibble);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+        // the high nibble is the left pixel
+        __m128i idx[2] = {_mm_unpacklo_epi8(hi, lo), _mm_unpackhi_epi8(hi, lo)};
+        __m128i* out = (__m128i*)(dst + 2 * i);
+        for(int k = 0; k < 2; k++){
+            __m128i pr = _mm_shuffle_epi8(r, idx[k]);
+            __m128i pg = _mm_shuffle_epi8(g, idx[k]);
+            __m128i pb = _mm_shuffle_epi8(b, idx[k]);
+            __m128i pa = _mm_shuffle_epi8(a, idx[k]);
+            __m128i rglo = _mm_unpacklo_epi8(pr, pg), rghi = _mm_unpackhi_epi8(pr, pg);
+            __m128i balo = _mm_unpacklo_epi8(pb, pa), bahi = _mm_unpackhi_epi8(pb, pa);
+            _mm_storeu_si128(out + 4 * k + 0, _mm_unpacklo_epi16(rglo, balo));
+            _mm_storeu_si128(out + 4 * k + 1, _mm_unpackhi_epi16(rglo, balo));
+            _mm_storeu_si128(out + 4 * k + 2, _mm_unpacklo_epi16(rghi, bahi));
+            _mm_storeu_si128(out + 4 * k + 3, _mm_unpackhi_epi16(rghi, bahi));
+        }
+    }
+    expand4(src + i, dst + 2 * i, n - i, palette);
+}
+#endif
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a width x height framebuffer read from memory at base. Width
+// must be a multiple of 8, and height too in text mode.
+fb_6502::fb_6502(mem_6502& memory, word base, uint32_t width, uint32_t height, byte mode, word font)
+        : mem(memory){
+    this->base = base;
+    this->font = font;
+    this->width = width & ~7u;
+    this->mode = mode;
+    if(mode == MODE_TEXT){
+        this->height = height & ~7u;
+        rowbytes = this->width / 8;
+        rows = this->height / 8;
+        rowlines = 8;
+    } else {
+        this->height = height;
+        rowbytes = mode == MODE_4BPP ? this->width / 2 : this->width / 8;
+        rows = this->height;
+        rowlines = 1;
+    }
+    if((uint32_t)base + rowbytes * rows > 0x10000
+            || (mode == MODE_TEXT && (uint32_t)font + FONT_BYTES > 0x10000)){
+        fprintf(stderr, "ERROR: Framebuffer at %04X does not fit in memory\n", base);
+        exit(EXIT_FAILURE);
+    }
+    for(byte i = 0; i < 16; i++){
+        setpalette(i, PALETTE[i][0], PALETTE[i][1], PALETTE[i][2]);
+    }
+    shadow.assign(rowbytes * rows, 0);
+    fontshadow.assign(mode == MODE_TEXT ? FONT_BYTES : 0, 0);
+    rgba.assign((size_t)this->width * this->height, 0);
+    rendered = 0;
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  setpalette()
+ *
+ *  @desc:      Sets a palette entry and redraws everything on the next
+ *              render()
+ *  @param:     index - Entry, 0 to 15
+ *              r, g, b - Colour
+ *  @return:    None
+ * */
+void fb_6502::setpalette(byte index, byte r, byte g, byte b){
+    palette[index & 0x0F] = r | (g << 8) | (b << 16) | 0xFF000000u;
+    // 1bpp and text mode draw with entries 0 and 1, a byte at a time
+    for(uint32_t val = 0; val < 256; val++){
+        for(int bit = 0; bit < 8; bit++){
+            mono[val][bit] = palette[(val >> (7 - bit)) & 1];
+        }
+    }
+    full = true;
+}
+
+/*
+ *  render()
+ *
+ *  @desc:      Converts the rows that changed since the last call
+ *  @param:     None
+ *  @return:    true if any pixel may have changed
+ * */
+bool fb_6502::render(){
+    const byte* src = &mem[base];
+    if(mode == MODE_TEXT){
+        // a new glyph may appear anywhere on screen
+        const byte* glyphs = &mem[font];
+        if(memcmp(glyphs, fontshadow.data(), FONT_BYTES) != 0){
+            memcpy(fontshadow.data(), glyphs, FONT_BYTES);
+            full = true;
+        }
+    }
+
+    bool changed = false;
+    for(uint32_t row = 0; row < rows; row++){
+        const byte* line = src + row * rowbytes;
+        byte* old = shadow.data() + row * rowbytes;
+        if(full || memcmp(line, old, rowbytes) != 0){
+            memcpy(old, line, rowbytes);
+            renderrow(row, line);
+            rendered++;
+            changed = true;
+        }
+    }
+    full = false;
+    return changed;
+}
+
+/*
+ *  writeppm()
+ *
+ *  @desc:      Writes the last rendered frame as a binary PPM image
+ *  @param:     path - Output file
+ *  @return:    true on success
+ * */
+bool fb_6502::writeppm(const char* path) const{
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr){
+        fprintf(stderr, "ERROR: Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    fprintf(file, "P6\n%u %u\n255\n", width, height);
+    std::vector<byte> line(width * 3);
+    bool ok = true;
+    for(uint32_t y = 0; y < height && ok; y++){
+        const uint32_t* px = rgba.data() + (size_t)y * width;
+        for(uint32_t x = 0; x < width; x++){
+            line[3 * x] = (byte)px[x];
+            line[3 * x + 1] = (byte)(px[x] >> 8);
+            line[3 * x + 2] = (byte)(px[x] >> 16);
+        }
+        ok = fwrite(line.data(), 1, line.size(), file) == line.size();
+    }
+    if(fclose(file) != 0 || !ok){
+        fprintf(stderr, "ERROR: Cannot write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+/*
+ *  writeraw()
+ *
+ *  @desc:      Appends the last rendered frame to a stream as raw RGBA,
+ *              width * height * 4 bytes
+ *  @param:     file - Open output stream
+ *  @return:    true on success
+ * */
+bool fb_6502::writeraw(FILE* file) const{
+    // rgba holds R in the lowest byte, which is byte order R, G, B, A on the
+    // little endian hosts this runs on
+    if(fwrite(rgba.data(), sizeof(uint32_t), rgba.size(), file) != rgba.size()){
+        fprintf(stderr, "ERROR: Cannot write frame\n");
+        return false;
+    }
+    return true;
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  pixels()
+ *
+ *  @desc:      Returns the frame, width * height RGBA pixels
+ * */
+const uint32_t* fb_6502::pixels() const{
+    return rgba.data();
+}
+
+/*
+ *  getrendered()
+ *
+ *  @desc:      Returns the number of display rows converted so far
+ * */
+uint64_t fb_6502::getrendered() const{
+    return rendered;
+}
+
+
+// Private helpers ---------------------------------------------------------
+void fb_6502::renderrow(uint32_t row, const byte* src){
+    uint32_t* dst = rgba.data() + (size_t)row * rowlines * width;
+    switch(mode){
+        case MODE_4BPP:{
+#ifdef FB_SSSE3_6502
+            static const bool ssse3 = __builtin_cpu_supports("ssse3");
+            if(ssse3){
+                expand4ssse3(src, dst, rowbytes, palette);
+                break;
+            }
+#endif
+            expand4(src, dst, rowbytes, palette);
+            break;
+        }
+        case MODE_TEXT:{
+            const byte* glyphs = fontshadow.data();
+            for(uint32_t line = 0; line < 8; line++){
+                uint32_t* out = dst + line * width;
+                for(uint32_t col = 0; col < rowbytes; col++){
+                    memcpy(out + 8 * col, mono[glyphs[src[col] * 8 + line]], sizeof(mono[0]));
+                }
+            }
+            break;
+        }
+        default:    // MODE_1BPP
+            for(uint32_t col = 0; col < rowbytes; col++){
+                memcpy(dst + 8 * col, mono[src[col]], sizeof(mono[0]));
+            }
+            break;
+    }
+}
@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       fb_6502.h
+ * @desc:       Header file for the memory mapped framebuffer
+ * @note:       The framebuffer is plain memory; nothing is intercepted on
+ *              the CPU path. render() compares each display row with a
+ *              shadow copy of the previous frame and converts only rows that
+ *              changed, so a static screen costs one memcmp per frame.
+ *****************************************************************************/
+
+#ifndef INC_6502_FB_6502_H
+#define INC_6502_FB_6502_H
+
+#include "6502.h"
+#include "mem_6502.h"
+#include <vector>
+
+class fb_6502 {
+public:
+    // display modes
+    static constexpr byte
+            MODE_1BPP = 0x00,   // 8 pixels per byte, MSB first, palette 0/1
+            MODE_4BPP = 0x01,   // 2 pixels per byte, high nibble first
+            MODE_TEXT = 0x02;   // one character code per 8x8 cell, glyphs
+                                // of 8 bytes each read from the font address
+
+private:
+    // Device Fields
+    mem_6502& mem;
+    word base;
+    word font;
+    uint32_t width, height;
+    byte mode;
+    uint32_t rowbytes;          // bytes of memory per display row
+    uint32_t rows;              // display rows, 8 pixel lines each in text mode
+    uint32_t rowlines;          // pixel lines per display row
+
+    uint32_t palette[16];       // RGBA, R in the lowest byte
+    uint32_t mono[256][8];      // pixels of each byte in 1bpp and text mode
+    std::vector<byte> shadow;   // memory as last rendered
+    std::vector<byte> fontshadow;
+    std::vector<uint32_t> rgba; // converted frame
+    bool full;                  // everything must be redrawn
+    uint64_t rendered;          // display rows converted since creation
+
+    /*
+     *  renderrow()
+     *
+     *  @desc:      Converts one display row from memory into rgba
+     * */
+    void renderrow(uint32_t row, const byte* src);
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a width x height framebuffer read from memory at base. Width
+    // must be a multiple of 8, and height too in text mode.
+    fb_6502(mem_6502& memory, word base, uint32_t width, uint32_t height, byte mode, word font = 0);
+
+    fb_6502(const fb_6502&) = delete;
+    fb_6502& operator=(const fb_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  setpalette()
+     *
+     *  @desc:      Sets a palette entry and redraws everything on the next
+     *              render()
+     *  @param:     index - Entry, 0 to 15
+     *              r, g, b - Colour
+     *  @return:    None
+     * */
+    void setpalette(byte index, byte r, byte g, byte b);
+
+    /*
+     *  render()
+     *
+     *  @desc:      Converts the rows that changed since the last call
+     *  @param:     None
+     *  @return:    true if any pixel may have changed
+     * */
+    bool render();
+
+    /*
+     *  writeppm()
+     *
+     *  @desc:      Writes the last rendered frame as a binary PPM image
+     *  @param:     path - Output file
+     *  @return:    true on success
+     * */
+    bool writeppm(const char* path) const;
+
+    /*
+     *  writeraw()
+     *
+     *  @desc:      Appends the last rendered frame to a stream as raw RGBA,
+     *              width * height * 4 bytes
+     *  @param:     file - Open output stream
+     *  @return:    true on success
+     * */
+    bool writeraw(FILE* file) const;
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  pixels()
+     *
+     *  @desc:      Returns the frame, width * height RGBA pixels
+     * */
+    const uint32_t* pixels() const;
+
+    /*
+     *  getrendered()
+     *
+     *  @desc:      Returns the number of display rows converted so far
+     * */
+    uint64_t getrendered() const;
+
+    uint32_t getwidth() const{ return width; }
+    uint32_t getheight() const{ return height; }
+};
+
+#endif //INC_6502_FB_6502_H
@@ -0,0 +1,573 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       gdb_6502.cpp
+ * @desc:       Source file for 6502 GDB remote serial protocol stub
+ * @ref:        https://sourceware.org/gdb/current/onlinedocs/gdb.html/Remote-Protocol.html
+ *****************************************************************************/
+
+#include "gdb_6502.h"
+#include "sock_6502.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+// register layout reported to the debugger, all little endian
+static const char* const TARGET_XML =
+        "<?xml version=\"1.0\"?>"
+        "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+        "<target version=\"1.0\">"
+        "<feature name=\"org.6502.core\">"
+        "<reg name=\"a\" bitsize=\"8\" regnum=\"0\"/>"
+        "<reg name=\"x\" bitsize=\"8\"/>"
+        "<reg name=\"y\" bitsize=\"8\"/>"
+        "<reg name=\"sp\" bitsize=\"8\"/>"
+        "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+        "<reg name=\"p\" bitsize=\"8\"/>"
+        "</feature>"
+        "</target>";
+
+static constexpr int REG_COUNT = 6;
+static constexpr int PC_REG = 4;
+
+// signals reported in stop replies
+static constexpr int SIGINT_GDB = 2;
+static constexpr int SIGILL_GDB = 4;     // a JAM opcode under JAM_TRAP or JAM_HALT
+static constexpr int SIGTRAP_GDB = 5;
+
+static const char HEX[] = "0123456789abcdef";
+
+// Appends the value as little endian hex bytes.
+static void puthex(std::string& out, uint32_t val, int bytes){
+    for(int i = 0; i < bytes; i++, val >>= 8){
+        out += HEX[(val >> 4) & 0xF];
+        out += HEX[val & 0xF];
+    }
+}
+
+// Parses little endian hex bytes starting at pos.
+static uint32_t gethex(const std::string& in, size_t pos, int bytes){
+    uint32_t val = 0;
+    for(int i = 0; i < bytes && pos + 2 * i + 1 < in.size(); i++){
+        val |= (uint32_t)strtoul(in.substr(pos + 2 * i, 2).c_str(), nullptr, 16) << (8 * i);
+    }
+    return val;
+}
+
+// Checks a packet against the two hex digits of its checksum.
+static bool validsum(const std::string& packet, const std::string& digits){
+    byte sum = 0;
+    for(char c : packet){
+        sum += (byte)c;
+    }
+    char* end;
+    unsigned long want = strtoul(digits.c_str(), &end, 16);
+    return digits.size() == 2 && *end == '\0' && want == sum;
+}
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a stub serving the given machine.
+gdb_6502::gdb_6502(cpu_6502& cpu, mem_6502& memory, debug_6502& dbg)
+        : cpu(cpu), mem(memory), dbg(dbg){
+    server = client = -1;
+    noack = false;
+    state = STATE_RUNNING;
+    interrupt = false;
+    replypending = false;
+    interrupted = false;
+}
+
+// Stops the I/O thread and closes all sockets.
+gdb_6502::~gdb_6502(){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        state = STATE_QUIT;
+        interrupt = true;
+        if(client >= 0){
+            shutdown(client, SHUT_RDWR);
+        }
+        if(server >= 0){
+            shutdown(server, SHUT_RDWR);
+        }
+    }
+    changed.notify_all();
+    if(io.joinable()){
+        io.join();
+    }
+    if(server >= 0){
+        close(server);
+    }
+    if(!unixpath.empty()){
+        unlink(unixpath.c_str());
+    }
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  listen()
+ *
+ *  @desc:      Opens the server socket and starts the I/O thread
+ *  @param:     spec - "PORT" or "tcp:PORT" for TCP on 127.0.0.1,
+ *                     "unix:PATH" for a Unix domain socket
+ *  @return:    true on success
+ * */
+bool gdb_6502::listen(const char* spec){
+    int fd = openserver(spec, unixpath);
+    if(fd < 0){
+        return false;
+    }
+    server = fd;
+    io = std::thread(&gdb_6502::serve, this);
+    return true;
+}
+
+/*
+ *  run()
+ *
+ *  @desc:      Runs the CPU on the calling thread until the debugger
+ *              kills the target. The CPU runs free in slices and is only
+ *              stopped at instruction boundaries between slices, or by a
+ *              breakpoint or watchpoint.
+ *  @param:     slice - Cycles to execute between interrupt checks
+ *              halted - true to wait for a debugger before running
+ *  @return:    None
+ * */
+void gdb_6502::run(int32_t slice, bool halted){
+    std::unique_lock<std::mutex> guard(lock);
+    if(halted && state == STATE_RUNNING){
+        state = STATE_HALTED;
+    }
+    for(;;){
+        changed.wait(guard, [this]{ return state != STATE_HALTED; });
+        if(state == STATE_QUIT){
+            return;
+        }
+        byte mode = state;
+        guard.unlock();
+
+        // free-running: the only per-slice cost is one relaxed load
+        do {
+            cpu.execute(mode == STATE_STEPPING ? 1 : slice, mem);
+        } while(mode == STATE_RUNNING && cpu.getstop() == cpu_6502::STOP_NONE
+                && !interrupt.load(std::memory_order_relaxed));
+
+        guard.lock();
+        if(state == STATE_QUIT){
+            return;
+        }
+        interrupted = interrupt.exchange(false) && mode == STATE_RUNNING
+                      && cpu.getstop() == cpu_6502::STOP_NONE;
+        state = STATE_HALTED;
+        if(replypending){
+            replypending = false;
+            sendpacket(stopreply());
+        }
+        changed.notify_all();
+    }
+}
+
+/*
+ *  halt()
+ *
+ *  @desc:      Stops the CPU thread at the next instruction boundary and
+ *              waits for it to park; caller holds the lock
+ *  @param:     guard - Held lock
+ *  @return:    None
+ * */
+void gdb_6502::halt(std::unique_lock<std::mutex>& guard){
+    if(state == STATE_RUNNING || state == STATE_STEPPING){
+        interrupt = true;
+        changed.wait(guard, [this]{ return state == STATE_HALTED || state == STATE_QUIT; });
+    }
+}
+
+
+// I/O thread --------------------------------------------------------------
+/*
+ *  serve()
+ *
+ *  @desc:      I/O thread body, accepts debuggers and services packets
+ * */
+void gdb_6502::serve(){
+    for(;;){
+        int fd = accept(server, nullptr, nullptr);
+        if(fd < 0){
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if(state == STATE_QUIT){
+                close(fd);
+                return;
+            }
+            client = fd;
+            noack = false;
+            replypending = false;
+            halt(guard);
+        }
+
+        std::string packet;
+        bool inpacket = false;
+        int checksum = -1;          // digits of the checksum still to read
+        std::string digits;         // checksum digits read so far
+        char buf[4096];
+        ssize_t len;
+        while((len = recv(fd, buf, sizeof(buf), 0)) > 0){
+            for(ssize_t i = 0; i < len; i++){
+                char c = buf[i];
+                if(inpacket){
+                    if(checksum > 0){
+                        digits += c;
+                        if(--checksum == 0){
+                            inpacket = false;
+                            std::unique_lock<std::mutex> guard(lock);
+                            if(!noack){
+                                // a damaged packet is dropped and resent
+                                if(!validsum(packet, digits)){
+                                    sendraw("-");
+                                    continue;
+                                }
+                                sendraw("+");
+                            }
+                            // all-stop protocol: packets only arrive while
+                            // halted, but wait out a pending stop anyway
+                            changed.wait(guard, [this]{
+                                return state == STATE_HALTED || state == STATE_QUIT; });
+                            if(state == STATE_QUIT){
+                                break;
+                            }
+                            std::string reply;
+                            if(handle(packet, reply)){
+                                sendpacket(reply);
+                            }
+                            changed.notify_all();
+                        }
+                    } else if(c == '#'){
+                        checksum = 2;
+                        digits.clear();
+                    } else {
+                        packet += c;
+                    }
+                } else if(c == '$'){
+                    inpacket = true;
+                    checksum = 0;
+                    packet.clear();
+                } else if(c == '\x03'){
+                    // a break while halted has nothing to stop
+                    std::lock_guard<std::mutex> guard(lock);
+                    if(state == STATE_RUNNING || state == STATE_STEPPING){
+                        interrupt = true;
+                    }
+                } else if(c == '-'){
+                    std::lock_guard<std::mutex> guard(lock);
+                    sendraw(lastreply);
+                }
+            }
+        }
+
+        // debugger went away: drop its points and let the machine run free
+        std::lock_guard<std::mutex> guard(lock);
+        client = -1;
+        close(fd);
+        if(state == STATE_QUIT){
+            return;
+        }
+        for(const auto& p : points){
+            if(p.first.first <= 1){
+                dbg.delbreak(p.second);
+            } else {
+                mem.delwatch(p.second);
+            }
+        }
+        points.clear();
+        if(state == STATE_HALTED){
+            state = STATE_RUNNING;
+            changed.notify_all();
+        }
+    }
+}
+
+/*
+ *  handle()
+ *
+ *  @desc:      Handles one packet while the CPU is halted
+ *  @param:     packet - Packet payload without framing
+ *              reply - Receives the reply payload
+ *  @return:    false for packets that resume the CPU and are answered
+ *              later by a stop reply
+ * */
+bool gdb_6502::handle(const std::string& packet, std::string& reply){
+    regs_6502 regs = cpu.getregs();
+    char cmd = packet.empty() ? '\0' : packet[0];
+
+    switch(cmd){
+        case '?':{
+            reply = stopreply();
+        } break;
+
+        case 'g':{
+            puthex(reply, regs.A, 1);
+            puthex(reply, regs.X, 1);
+            puthex(reply, regs.Y, 1);
+            puthex(reply, regs.SP, 1);
+            puthex(reply, regs.PC, 2);
+            puthex(reply, regs.P, 1);
+        } break;
+
+        case 'G':{
+            regs.A = gethex(packet, 1, 1);
+            regs.X = gethex(packet, 3, 1);
+            regs.Y = gethex(packet, 5, 1);
+            regs.SP = gethex(packet, 7, 1);
+            regs.PC = gethex(packet, 9, 2);
+            regs.P = gethex(packet, 13, 1);
+            cpu.setregs(regs);
+            reply = "OK";
+        } break;
+
+        case 'p':{
+            int n = (int)strtol(packet.c_str() + 1, nullptr, 16);
+            byte* r8[] = {&regs.A, &regs.X, &regs.Y, &regs.SP, nullptr, &regs.P};
+            if(n == PC_REG){
+                puthex(reply, regs.PC, 2);
+            } else if(n >= 0 && n < REG_COUNT){
+                puthex(reply, *r8[n], 1);
+            } else {
+                reply = "E01";
+            }
+        } break;
+
+        case 'P':{
+            size_t eq = packet.find('=');
+            int n = (int)strtol(packet.c_str() + 1, nullptr, 16);
+            byte* r8[] = {&regs.A, &regs.X, &regs.Y, &regs.SP, nullptr, &regs.P};
+            if(eq == std::string::npos || n < 0 || n >= REG_COUNT){
+                reply = "E01";
+                break;
+            }
+            if(n == PC_REG){
+                regs.PC = gethex(packet, eq + 1, 2);
+            } else {
+                *r8[n] = gethex(packet, eq + 1, 1);
+            }
+            cpu.setregs(regs);
+            reply = "OK";
+        } break;
+
+        case 'm':{
+            char* end;
+            uint32_t addr = strtoul(packet.c_str() + 1, &end, 16);
+            uint32_t len = *end == ',' ? strtoul(end + 1, nullptr, 16) : 0;
+            for(uint32_t i = 0; i < len; i++){
+                puthex(reply, mem[(addr + i) & 0xFFFF], 1);
+            }
+        } break;
+
+        case 'M':{
+            char* end;
+            uint32_t addr = strtoul(packet.c_str() + 1, &end, 16);
+            uint32_t len = *end == ',' ? strtoul(end + 1, &end, 16) : 0;
+            if(*end != ':'){
+                reply = "E01";
+                break;
+            }
+            size_t pos = end + 1 - packet.c_str();
+            for(uint32_t i = 0; i < len; i++){
+                mem[(addr + i) & 0xFFFF] = gethex(packet, pos + 2 * i, 1);
+            }
+            reply = "OK";
+        } break;
+
+        case 'c':
+        case 's':{
+            if(packet.size() > 1){
+                regs.PC = strtoul(packet.c_str() + 1, nullptr, 16);
+                cpu.setregs(regs);
+            }
+            state = cmd == 'c' ? STATE_RUNNING : STATE_STEPPING;
+            replypending = true;
+            interrupted = false;
+            interrupt = false;
+            return false;
+        }
+
+        case 'Z':
+        case 'z':{
+            reply = setpoint(packet.substr(1), cmd == 'Z');
+        } break;
+
+        case 'D':{
+            reply = "OK";
+            sendpacket(reply);
+            shutdown(client, SHUT_RD);
+            return false;
+        }
+
+        case 'k':{
+            state = STATE_QUIT;
+            interrupt = true;
+            shutdown(client, SHUT_RD);
+            return false;
+        }
+
+        case 'H':{
+            reply = "OK";
+        } break;
+
+        case 'q':{
+            if(packet.compare(0, 10, "qSupported") == 0){
+                reply = "PacketSize=4000;qXfer:features:read+;QStartNoAckMode+";
+            } else if(packet == "qAttached"){
+                reply = "1";
+            } else if(packet.compare(0, 31, "qXfer:features:read:target.xml:") == 0){
+                char* end;
+                size_t off = strtoul(packet.c_str() + 31, &end, 16);
+                size_t len = *end == ',' ? strtoul(end + 1, nullptr, 16) : 0;
+                std::string xml = TARGET_XML;
+                if(off >= xml.size()){
+                    reply = "l";
+                } else {
+                    std::string chunk = xml.substr(off, len);
+                    reply = (off + chunk.size() >= xml.size() ? "l" : "m") + chunk;
+                }
+            } else if(packet == "qC"){
+                reply = "QC1";
+            } else if(packet == "qfThreadInfo"){
+                reply = "m1";
+            } else if(packet == "qsThreadInfo"){
+                reply = "l";
+            }
+        } break;
+
+        case 'Q':{
+            if(packet == "QStartNoAckMode"){
+                sendpacket("OK");
+                noack = true;
+                return false;
+            }
+        } break;
+
+        default:
+            // unsupported packets get an empty reply
+            break;
+    }
+    return true;
+}
+
+/*
+ *  setpoint()
+ *
+ *  @desc:      Inserts or removes a breakpoint or watchpoint (Z/z)
+ *  @param:     args - Packet arguments after the 'Z' or 'z'
+ *              insert - true for Z, false for z
+ *  @return:    Reply payload
+ * */
+std::string gdb_6502::setpoint(const std::string& args, bool insert){
+    // Z0/Z1 break, Z2 write, Z3 read and Z4 access watchpoints
+    static const byte kinds[] = {
+        0, 0, mem_6502::WATCH_WRITE, mem_6502::WATCH_READ,
+        mem_6502::WATCH_READ | mem_6502::WATCH_WRITE
+    };
+    char* end;
+    int type = (int)strtol(args.c_str(), &end, 10);
+    if(*end != ',' || type < 0 || type > 4){
+        return "";
+    }
+    word addr = strtoul(end + 1, &end, 16);
+    uint32_t len = *end == ',' ? strtoul(end + 1, nullptr, 16) : 1;
+    auto key = std::make_pair(type, addr);
+
+    if(!insert){
+        auto it = points.find(key);
+        if(it == points.end()){
+            return "E01";
+        }
+        if(type <= 1){
+            dbg.delbreak(it->second);
+        } else {
+            mem.delwatch(it->second);
+        }
+        points.erase(it);
+        return "OK";
+    }
+
+    if(points.count(key)){
+        return "OK";
+    }
+    int id = type <= 1 ? dbg.addbreak(addr)
+                       : mem.addwatch(addr, addr + (len ? len - 1 : 0), kinds[type]);
+    points[key] = id;
+    return "OK";
+}
+
+/*
+ *  stopreply()
+ *
+ *  @desc:      Builds the stop reply describing why the CPU halted
+ * */
+std::string gdb_6502::stopreply() const{
+    std::string reply = "T";
+    puthex(reply, interrupted ? SIGINT_GDB
+                : cpu.getstop() == cpu_6502::STOP_JAM ? SIGILL_GDB : SIGTRAP_GDB, 1);
+    if(!interrupted && cpu.getstop() == cpu_6502::STOP_WATCH && mem.watchhit()){
+        const mem_6502::watchhit_6502& hit = mem.lastwatch();
+        if(hit.kind != mem_6502::WATCH_EXEC){
+            // reported by how the point was set, so a Z4 hit is an awatch
+            byte kind = hit.kind;
+            for(const mem_6502::watch_6502& w : mem.getwatches()){
+                if(w.id == hit.id){
+                    kind = w.kind;
+                }
+            }
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%x;", hit.addr);
+            reply += kind == (mem_6502::WATCH_READ | mem_6502::WATCH_WRITE) ? "awatch:"
+                   : kind == mem_6502::WATCH_WRITE ? "watch:" : "rwatch:";
+            reply += buf;
+        }
+    }
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%x:", PC_REG);
+    reply += buf;
+    puthex(reply, cpu.getregs().PC, 2);
+    reply += ";";
+    return reply;
+}
+
+/*
+ *  sendpacket()
+ *
+ *  @desc:      Frames and sends a packet; caller holds the lock
+ *  @param:     payload - Packet payload
+ *  @return:    None
+ * */
+void gdb_6502::sendpacket(const std::string& payload){
+    byte sum = 0;
+    for(char c : payload){
+        sum += (byte)c;
+    }
+    std::string frame = "$" + payload + "#";
+    puthex(frame, sum, 1);
+    lastreply = frame;
+    sendraw(frame);
+}
+
+/*
+ *  sendraw()
+ *
+ *  @desc:      Sends bytes to the connected debugger, if any
+ * */
+void gdb_6502::sendraw(const std::string& bytes){
+    size_t sent = 0;
+    while(client >= 0 && sent < bytes.size()){
+        ssize_t n = send(client, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if(n <= 0){
+            return;
+        }
+        sent += n;
+    }
+}
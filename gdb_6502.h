@@ -0,0 +1,159 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       gdb_6502.h
+ * @desc:       Header file for 6502 GDB remote serial protocol stub
+ * @ref:        https://sourceware.org/gdb/current/onlinedocs/gdb.html/Remote-Protocol.html
+ *****************************************************************************/
+
+#ifndef INC_6502_GDB_6502_H
+#define INC_6502_GDB_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "debug_6502.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class gdb_6502 {
+private:
+    // run states of the CPU thread
+    static constexpr byte
+            STATE_RUNNING  = 0x00,
+            STATE_HALTED   = 0x01,
+            STATE_STEPPING = 0x02,
+            STATE_QUIT     = 0x03;
+
+    // Machine Fields
+    cpu_6502& cpu;
+    mem_6502& mem;
+    debug_6502& dbg;
+
+    // Connection Fields
+    int server;                 // listening socket
+    int client;                 // connected debugger, -1 if none
+    std::string unixpath;       // socket file to remove, if any
+    std::thread io;
+    bool noack;                 // QStartNoAckMode negotiated
+    std::string lastreply;      // resent when the debugger NAKs
+
+    // Run-state Fields
+    // The CPU thread owns cpu and mem while the state is not HALTED; the I/O
+    // thread only touches them once the CPU thread has parked itself.
+    std::mutex lock;
+    std::condition_variable changed;
+    byte state;
+    std::atomic<bool> interrupt;    // polled by the CPU thread between slices
+    bool replypending;              // debugger awaits a stop reply
+    bool interrupted;               // stop was requested rather than hit
+
+    // Z-packet points, keyed by type and address, mapped to their ids
+    std::map<std::pair<int, word>, int> points;
+
+    /*
+     *  serve()
+     *
+     *  @desc:      I/O thread body, accepts debuggers and services packets
+     * */
+    void serve();
+
+    /*
+     *  halt()
+     *
+     *  @desc:      Stops the CPU thread at the next instruction boundary and
+     *              waits for it to park; caller holds the lock
+     *  @param:     guard - Held lock
+     *  @return:    None
+     * */
+    void halt(std::unique_lock<std::mutex>& guard);
+
+    /*
+     *  handle()
+     *
+     *  @desc:      Handles one packet while the CPU is halted
+     *  @param:     packet - Packet payload without framing
+     *              reply - Receives the reply payload
+     *  @return:    false for packets that resume the CPU and are answered
+     *              later by a stop reply
+     * */
+    bool handle(const std::string& packet, std::string& reply);
+
+    /*
+     *  setpoint()
+     *
+     *  @desc:      Inserts or removes a breakpoint or watchpoint (Z/z)
+     *  @param:     args - Packet arguments after the 'Z' or 'z'
+     *              insert - true for Z, false for z
+     *  @return:    Reply payload
+     * */
+    std::string setpoint(const std::string& args, bool insert);
+
+    /*
+     *  stopreply()
+     *
+     *  @desc:      Builds the stop reply describing why the CPU halted
+     * */
+    std::string stopreply() const;
+
+    /*
+     *  sendpacket()
+     *
+     *  @desc:      Frames and sends a packet; caller holds the lock
+     *  @param:     payload - Packet payload
+     *  @return:    None
+     * */
+    void sendpacket(const std::string& payload);
+
+    /*
+     *  sendraw()
+     *
+     *  @desc:      Sends bytes to the connected debugger, if any
+     * */
+    void sendraw(const std::string& bytes);
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a stub serving the given machine.
+    gdb_6502(cpu_6502& cpu, mem_6502& memory, debug_6502& dbg);
+
+    // Stops the I/O thread and closes all sockets.
+    ~gdb_6502();
+
+    gdb_6502(const gdb_6502&) = delete;
+    gdb_6502& operator=(const gdb_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  listen()
+     *
+     *  @desc:      Opens the server socket and starts the I/O thread
+     *  @param:     spec - "PORT" or "tcp:PORT" for TCP on 127.0.0.1,
+     *                     "unix:PATH" for a Unix domain socket
+     *  @return:    true on success
+     * */
+    bool listen(const char* spec);
+
+    /*
+     *  run()
+     *
+     *  @desc:      Runs the CPU on the calling thread until the debugger
+     *              kills the target. The CPU runs free in slices and is only
+     *              stopped at instruction boundaries between slices, or by a
+     *              breakpoint or watchpoint.
+     *  @param:     slice - Cycles to execute between interrupt checks
+     *              halted - true to wait for a debugger before running
+     *  @return:    None
+     * */
+    void run(int32_t slice, bool halted);
+};
+
+#endif //INC_6502_GDB_6502_H
@@ -0,0 +1,416 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       lib6502.cpp
+ * @desc:       Source file for the C interface to the emulator
+ *****************************************************************************/
+
+#include "lib6502.h"
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "sched_6502.h"
+#include <algorithm>
+#include <new>
+#include <unordered_map>
+
+// longest execute() call made by lib6502_run(), well inside its int32_t
+static constexpr uint64_t RUN_SLICE = 1u << 30;
+
+// the C constants are handed to and from the C++ core unchanged
+static_assert(LIB6502_STOP_NONE == cpu_6502::STOP_NONE, "LIB6502_STOP_NONE");
+static_assert(LIB6502_STOP_WATCH == cpu_6502::STOP_WATCH, "LIB6502_STOP_WATCH");
+static_assert(LIB6502_STOP_JAM == cpu_6502::STOP_JAM, "LIB6502_STOP_JAM");
+static_assert(LIB6502_WATCH_READ == mem_6502::WATCH_READ, "LIB6502_WATCH_READ");
+static_assert(LIB6502_WATCH_WRITE == mem_6502::WATCH_WRITE, "LIB6502_WATCH_WRITE");
+static_assert(LIB6502_WATCH_EXEC == mem_6502::WATCH_EXEC, "LIB6502_WATCH_EXEC");
+static_assert(LIB6502_JAM_EMULATE == cpu_6502::JAM_EMULATE, "LIB6502_JAM_EMULATE");
+static_assert(LIB6502_JAM_TRAP == cpu_6502::JAM_TRAP, "LIB6502_JAM_TRAP");
+static_assert(LIB6502_JAM_HALT == cpu_6502::JAM_HALT, "LIB6502_JAM_HALT");
+
+/*
+ *  struct libtrap_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      A host call registered through the C interface, the context
+ *              cpu_6502 passes to hosttrap()
+ */
+struct libtrap_6502 {
+    lib6502_hostcall fn;
+    void* ctx;
+    lib6502_machine* m;
+};
+
+struct lib6502_machine {
+    cpu_6502 cpu;
+    mem_6502 mem;
+    sched_6502 events;
+    std::unordered_map<word, libtrap_6502> traps;   // nodes never move
+};
+
+// Calls a C host call with the registers converted both ways.
+static bool hosttrap(void* ctx, regs_6502& regs, mem_6502& memory){
+    libtrap_6502* t = static_cast<libtrap_6502*>(ctx);
+    lib6502_regs r = {regs.PC, regs.SP, regs.A, regs.X, regs.Y, regs.P};
+    if(t->fn(t->ctx, &r, t->m) == 0){
+        return false;
+    }
+    regs = {r.pc, r.sp, r.a, r.x, r.y, r.p};
+    (void)memory;
+    return true;
+}
+
+
+// Machine ---------------------------------------------------------------------
+/*
+ *  lib6502_abi()
+ *
+ *  @desc:      Returns the LIB6502_ABI the library was built with
+ * */
+int lib6502_abi(void){
+    return LIB6502_ABI;
+}
+
+/*
+ *  lib6502_create()
+ *
+ *  @desc:      Creates a machine with cleared memory, PC at $FFFC
+ *  @return:    Machine, or NULL if out of memory
+ * */
+lib6502_machine* lib6502_create(void){
+    lib6502_machine* m = new(std::nothrow) lib6502_machine;
+    if(m == nullptr){
+        return nullptr;
+    }
+    m->cpu.reset(m->mem);
+    m->cpu.attach(&m->events);
+    return m;
+}
+
+/*
+ *  lib6502_destroy()
+ *
+ *  @desc:      Frees a machine; NULL is ignored
+ * */
+void lib6502_destroy(lib6502_machine* m){
+    delete m;
+}
+
+/*
+ *  lib6502_reset()
+ *
+ *  @desc:      Resets the CPU and clears memory; devices, events,
+ *              watchpoints and host calls stay
+ * */
+void lib6502_reset(lib6502_machine* m){
+    m->cpu.reset(m->mem);
+}
+
+/*
+ *  lib6502_load()
+ *
+ *  @desc:      Copies a binary image file into memory
+ *  @param:     m - Machine
+ *              path - Image file
+ *              addr - Address to load the first byte at
+ *  @return:    1, or 0 if the file cannot be read or does not fit
+ * */
+int lib6502_load(lib6502_machine* m, const char* path, uint16_t addr){
+    return m->mem.loadfile(path, addr) ? 1 : 0;
+}
+
+/*
+ *  lib6502_run()
+ *
+ *  @desc:      Runs until the clock has advanced by at least cycles or
+ *              execution stops early
+ *  @param:     m - Machine
+ *              cycles - Cycles to run
+ *  @return:    LIB6502_STOP_* reason
+ * */
+int lib6502_run(lib6502_machine* m, uint64_t cycles){
+    uint64_t end = m->cpu.getclock() + cycles;
+    for(uint64_t now = m->cpu.getclock(); now < end; now = m->cpu.getclock()){
+        uint64_t left = end - now;
+        m->cpu.execute((int32_t)(left < RUN_SLICE ? left : RUN_SLICE), m->mem);
+        if(m->cpu.getstop() != cpu_6502::STOP_NONE){
+            return m->cpu.getstop();
+        }
+    }
+    return LIB6502_STOP_NONE;
+}
+
+/*
+ *  lib6502_getregs()
+ *
+ *  @desc:      Copies the registers into regs
+ * */
+void lib6502_getregs(const lib6502_machine* m, lib6502_regs* regs){
+    regs_6502 r = m->cpu.getregs();
+    *regs = {r.PC, r.SP, r.A, r.X, r.Y, r.P};
+}
+
+/*
+ *  lib6502_setregs()
+ *
+ *  @desc:      Loads the registers from regs
+ * */
+void lib6502_setregs(lib6502_machine* m, const lib6502_regs* regs){
+    m->cpu.setregs({regs->pc, regs->sp, regs->a, regs->x, regs->y, regs->p});
+}
+
+/*
+ *  lib6502_clock()
+ *
+ *  @desc:      Returns the cycles run since the machine was created
+ * */
+uint64_t lib6502_clock(const lib6502_machine* m){
+    return m->cpu.getclock();
+}
+
+/*
+ *  lib6502_retired()
+ *
+ *  @desc:      Returns the instructions run since the machine was created
+ * */
+uint64_t lib6502_retired(const lib6502_machine* m){
+    return m->cpu.getretired();
+}
+
+/*
+ *  lib6502_setirq()
+ *
+ *  @desc:      Raises or releases IRQ lines, each device owning a bit of
+ *              the wired-OR line
+ *  @param:     m - Machine
+ *              lines - Bits to change
+ *              on - Nonzero to assert
+ *  @return:    None
+ * */
+void lib6502_setirq(lib6502_machine* m, uint32_t lines, int on){
+    m->cpu.setirq(lines, on != 0);
+}
+
+/*
+ *  lib6502_setnmi()
+ *
+ *  @desc:      Drives the NMI line, taken on its rising edge
+ * */
+void lib6502_setnmi(lib6502_machine* m, int on){
+    m->cpu.setnmi(on != 0);
+}
+
+/*
+ *  lib6502_setjam()
+ *
+ *  @desc:      Sets what JAM opcodes do, LIB6502_JAM_EMULATE by default
+ * */
+void lib6502_setjam(lib6502_machine* m, int policy){
+    m->cpu.setjam((byte)policy);
+}
+
+
+// Memory ----------------------------------------------------------------------
+/*
+ *  lib6502_memory()
+ *
+ *  @desc:      Returns the 64 KiB memory block, valid until the machine is
+ *              destroyed
+ * */
+uint8_t* lib6502_memory(lib6502_machine* m){
+    return m->mem.getdata();
+}
+
+/*
+ *  lib6502_peek()
+ *
+ *  @desc:      Returns the byte at addr
+ * */
+uint8_t lib6502_peek(const lib6502_machine* m, uint16_t addr){
+    return m->mem[addr];
+}
+
+/*
+ *  lib6502_poke()
+ *
+ *  @desc:      Stores val at addr
+ * */
+void lib6502_poke(lib6502_machine* m, uint16_t addr, uint8_t val){
+    m->mem[addr] = val;
+}
+
+/*
+ *  lib6502_readblock()
+ *
+ *  @desc:      Copies memory out, wrapping at $FFFF
+ *  @param:     m - Machine
+ *              addr - First address
+ *              buf - Receives len bytes
+ *              len - Bytes to copy
+ *  @return:    None
+ * */
+void lib6502_readblock(const lib6502_machine* m, uint16_t addr, void* buf, size_t len){
+    const byte* data = m->mem.getdata();
+    byte* out = static_cast<byte*>(buf);
+    while(len > 0){
+        size_t run = std::min((size_t)0x10000 - addr, len);
+        memcpy(out, data + addr, run);
+        out += run;
+        len -= run;
+        addr = (uint16_t)(addr + run);
+    }
+}
+
+/*
+ *  lib6502_writeblock()
+ *
+ *  @desc:      Copies into memory, wrapping at $FFFF
+ *  @param:     m - Machine
+ *              addr - First address
+ *              buf - len bytes to store
+ *              len - Bytes to copy
+ *  @return:    None
+ * */
+void lib6502_writeblock(lib6502_machine* m, uint16_t addr, const void* buf, size_t len){
+    byte* data = m->mem.getdata();
+    const byte* in = static_cast<const byte*>(buf);
+    while(len > 0){
+        size_t run = std::min((size_t)0x10000 - addr, len);
+        memcpy(data + addr, in, run);
+        in += run;
+        len -= run;
+        addr = (uint16_t)(addr + run);
+    }
+}
+
+
+// Devices and events ----------------------------------------------------------
+// Registration is the only place the interface allocates; running out of
+// memory there is reported instead of thrown across the C boundary.
+
+/*
+ *  lib6502_mapio()
+ *
+ *  @desc:      Maps a device over the inclusive range [lo, hi]. CPU reads
+ *              and writes there go to its callbacks; writes also land in
+ *              memory.
+ *  @param:     m - Machine
+ *              lo, hi - Device addresses
+ *              read, write - Callbacks
+ *              ctx - Passed through to the callbacks
+ *  @return:    Mapping id for lib6502_unmapio()
+ * */
+int lib6502_mapio(lib6502_machine* m, uint16_t lo, uint16_t hi,
+                  lib6502_ioread read, lib6502_iowrite write, void* ctx){
+    try {
+        return m->mem.mapio(lo, hi, read, write, ctx);
+    } catch(const std::bad_alloc&){
+        return -1;
+    }
+}
+
+/*
+ *  lib6502_unmapio()
+ *
+ *  @desc:      Removes a device mapping
+ *  @return:    0 if there was none
+ * */
+int lib6502_unmapio(lib6502_machine* m, int id){
+    return m->mem.unmapio(id) ? 1 : 0;
+}
+
+/*
+ *  lib6502_schedule()
+ *
+ *  @desc:      Calls fn once the clock reaches when
+ *  @param:     m - Machine
+ *              when - Clock cycle
+ *              fn - Callback, which may schedule again
+ *              ctx - Passed through to fn
+ *  @return:    Event id for lib6502_cancel()
+ * */
+int lib6502_schedule(lib6502_machine* m, uint64_t when, lib6502_event fn, void* ctx){
+    try {
+        return (int)m->events.schedule(when, fn, ctx);
+    } catch(const std::bad_alloc&){
+        return -1;
+    }
+}
+
+/*
+ *  lib6502_cancel()
+ *
+ *  @desc:      Removes a pending event
+ *  @return:    0 if it had fired or never existed
+ * */
+int lib6502_cancel(lib6502_machine* m, int id){
+    return id > 0 && m->events.cancel((uint32_t)id) ? 1 : 0;
+}
+
+/*
+ *  lib6502_addwatch()
+ *
+ *  @desc:      Stops lib6502_run() on accesses to the inclusive range
+ *              [lo, hi]
+ *  @param:     m - Machine
+ *              lo, hi - Watched addresses
+ *              kind - LIB6502_WATCH_* bits
+ *  @return:    Watchpoint id for lib6502_delwatch()
+ * */
+int lib6502_addwatch(lib6502_machine* m, uint16_t lo, uint16_t hi, int kind){
+    try {
+        return m->mem.addwatch(lo, hi, (byte)(kind & (mem_6502::WATCH_READ
+                | mem_6502::WATCH_WRITE | mem_6502::WATCH_EXEC)));
+    } catch(const std::bad_alloc&){
+        return -1;
+    }
+}
+
+/*
+ *  lib6502_delwatch()
+ *
+ *  @desc:      Removes a watchpoint
+ *  @return:    0 if there was none
+ * */
+int lib6502_delwatch(lib6502_machine* m, int id){
+    return m->mem.delwatch(id) ? 1 : 0;
+}
+
+/*
+ *  lib6502_addtrap()
+ *
+ *  @desc:      Runs fn instead of the subroutine at addr, then returns as
+ *              RTS would, charging cycles; replaces any host call there
+ *  @param:     m - Machine
+ *              addr - Entry point of the subroutine
+ *              fn - Native implementation
+ *              ctx - Passed through to fn
+ *              cycles - Cycles to charge per call, RTS included
+ *  @return:    1, or 0 if out of memory
+ * */
+int lib6502_addtrap(lib6502_machine* m, uint16_t addr, lib6502_hostcall fn, void* ctx,
+                    uint32_t cycles){
+    try {
+        libtrap_6502& t = m->traps[addr];
+        t = {fn, ctx, m};
+        m->cpu.addtrap(addr, hosttrap, &t, cycles, m->mem);
+    } catch(const std::bad_alloc&){
+        m->traps.erase(addr);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ *  lib6502_deltrap()
+ *
+ *  @desc:      Removes the host call at addr
+ *  @return:    0 if there was none
+ * */
+int lib6502_deltrap(lib6502_machine* m, uint16_t addr){
+    m->traps.erase(addr);
+    return m->cpu.deltrap(addr, m->mem) ? 1 : 0;
+}
@@ -0,0 +1,364 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       lib6502.h
+ * @desc:       C interface to the emulator, built as lib6502.so and lib6502.a
+ * @note:       A machine is a CPU, 64 KiB of memory and an event scheduler,
+ *              allocated once by lib6502_create(). Nothing after that
+ *              allocates except registering a device, event, watchpoint or
+ *              host call, so running and memory access can be called in a
+ *              tight loop. A machine is not thread safe, but separate
+ *              machines can run on separate threads. Callbacks run on the
+ *              thread calling lib6502_run() and must not call
+ *              lib6502_run() themselves. Functions returning int return 1
+ *              on success and 0 on failure unless stated otherwise.
+ *              LIB6502_ABI changes whenever a declaration here changes
+ *              incompatibly.
+ *****************************************************************************/
+
+#ifndef INC_6502_LIB6502_H
+#define INC_6502_LIB6502_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIB6502_API __attribute__((visibility("default")))
+
+#define LIB6502_ABI 1
+
+// why lib6502_run() returned
+#define LIB6502_STOP_NONE   0x00    // ran the cycles asked for
+#define LIB6502_STOP_WATCH  0x01    // a watchpoint triggered
+#define LIB6502_STOP_JAM    0x03    // a JAM opcode ran under LIB6502_JAM_TRAP or
+                                    // LIB6502_JAM_HALT
+
+// watchpoint kinds, combinable
+#define LIB6502_WATCH_READ  0x01
+#define LIB6502_WATCH_WRITE 0x02
+#define LIB6502_WATCH_EXEC  0x04
+
+// JAM opcode policies, see lib6502_setjam()
+#define LIB6502_JAM_EMULATE 0x00    // lock up until reset, as the chip does
+#define LIB6502_JAM_TRAP    0x01    // stop before the opcode, every time it runs
+#define LIB6502_JAM_HALT    0x02    // lock up and stop
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lib6502_machine lib6502_machine;
+
+/*
+ *  struct lib6502_regs
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Programmer visible CPU registers
+ */
+typedef struct lib6502_regs {
+    uint16_t pc;
+    uint8_t sp;
+    uint8_t a, x, y;
+    uint8_t p;      // status register, packed NV1BDIZC
+} lib6502_regs;
+
+/*
+ *  lib6502_ioread
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called for a CPU read from a mapped device
+ *  @param:     ctx - Pointer given to lib6502_mapio()
+ *              addr - Address read
+ *  @return:    Value read
+ */
+typedef uint8_t (*lib6502_ioread)(void* ctx, uint16_t addr);
+
+/*
+ *  lib6502_iowrite
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called for a CPU write to a mapped device
+ *  @param:     ctx - Pointer given to lib6502_mapio()
+ *              addr - Address written
+ *              val - Value written
+ */
+typedef void (*lib6502_iowrite)(void* ctx, uint16_t addr, uint8_t val);
+
+/*
+ *  lib6502_event
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called when an event comes due
+ *  @param:     ctx - Pointer given to lib6502_schedule()
+ *              when - Cycle the event was scheduled for
+ *              now - Cycle of the instruction boundary it fired on
+ */
+typedef void (*lib6502_event)(void* ctx, uint64_t when, uint64_t now);
+
+/*
+ *  lib6502_hostcall
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Native implementation of a 6502 subroutine, see
+ *              lib6502_addtrap()
+ *  @param:     ctx - Pointer given to lib6502_addtrap()
+ *              regs - Registers on entry, to be updated with the results;
+ *                     pc is ignored
+ *              m - Machine, for its memory
+ *  @return:    Nonzero if handled, 0 to run the 6502 code instead
+ */
+typedef int (*lib6502_hostcall)(void* ctx, lib6502_regs* regs, lib6502_machine* m);
+
+// Machine ---------------------------------------------------------------------
+/*
+ *  lib6502_abi()
+ *
+ *  @desc:      Returns the LIB6502_ABI the library was built with
+ * */
+LIB6502_API int lib6502_abi(void);
+
+/*
+ *  lib6502_create()
+ *
+ *  @desc:      Creates a machine with cleared memory, PC at $FFFC
+ *  @return:    Machine, or NULL if out of memory
+ * */
+LIB6502_API lib6502_machine* lib6502_create(void);
+
+/*
+ *  lib6502_destroy()
+ *
+ *  @desc:      Frees a machine; NULL is ignored
+ * */
+LIB6502_API void lib6502_destroy(lib6502_machine* m);
+
+/*
+ *  lib6502_reset()
+ *
+ *  @desc:      Resets the CPU and clears memory; devices, events,
+ *              watchpoints and host calls stay
+ * */
+LIB6502_API void lib6502_reset(lib6502_machine* m);
+
+/*
+ *  lib6502_load()
+ *
+ *  @desc:      Copies a binary image file into memory
+ *  @param:     m - Machine
+ *              path - Image file
+ *              addr - Address to load the first byte at
+ *  @return:    1, or 0 if the file cannot be read or does not fit
+ * */
+LIB6502_API int lib6502_load(lib6502_machine* m, const char* path, uint16_t addr);
+
+/*
+ *  lib6502_run()
+ *
+ *  @desc:      Runs until the clock has advanced by at least cycles or
+ *              execution stops early
+ *  @param:     m - Machine
+ *              cycles - Cycles to run
+ *  @return:    LIB6502_STOP_* reason
+ * */
+LIB6502_API int lib6502_run(lib6502_machine* m, uint64_t cycles);
+
+/*
+ *  lib6502_getregs()
+ *
+ *  @desc:      Copies the registers into regs
+ * */
+LIB6502_API void lib6502_getregs(const lib6502_machine* m, lib6502_regs* regs);
+
+/*
+ *  lib6502_setregs()
+ *
+ *  @desc:      Loads the registers from regs
+ * */
+LIB6502_API void lib6502_setregs(lib6502_machine* m, const lib6502_regs* regs);
+
+/*
+ *  lib6502_clock()
+ *
+ *  @desc:      Returns the cycles run since the machine was created
+ * */
+LIB6502_API uint64_t lib6502_clock(const lib6502_machine* m);
+
+/*
+ *  lib6502_retired()
+ *
+ *  @desc:      Returns the instructions run since the machine was created
+ * */
+LIB6502_API uint64_t lib6502_retired(const lib6502_machine* m);
+
+/*
+ *  lib6502_setirq()
+ *
+ *  @desc:      Raises or releases IRQ lines, each device owning a bit of
+ *              the wired-OR line
+ *  @param:     m - Machine
+ *              lines - Bits to change
+ *              on - Nonzero to assert
+ *  @return:    None
+ * */
+LIB6502_API void lib6502_setirq(lib6502_machine* m, uint32_t lines, int on);
+
+/*
+ *  lib6502_setnmi()
+ *
+ *  @desc:      Drives the NMI line, taken on its rising edge
+ * */
+LIB6502_API void lib6502_setnmi(lib6502_machine* m, int on);
+
+/*
+ *  lib6502_setjam()
+ *
+ *  @desc:      Sets what JAM opcodes do, LIB6502_JAM_EMULATE by default
+ * */
+LIB6502_API void lib6502_setjam(lib6502_machine* m, int policy);
+
+// Memory ----------------------------------------------------------------------
+// Host access bypasses watchpoints and devices.
+
+/*
+ *  lib6502_memory()
+ *
+ *  @desc:      Returns the 64 KiB memory block, valid until the machine is
+ *              destroyed
+ * */
+LIB6502_API uint8_t* lib6502_memory(lib6502_machine* m);
+
+/*
+ *  lib6502_peek()
+ *
+ *  @desc:      Returns the byte at addr
+ * */
+LIB6502_API uint8_t lib6502_peek(const lib6502_machine* m, uint16_t addr);
+
+/*
+ *  lib6502_poke()
+ *
+ *  @desc:      Stores val at addr
+ * */
+LIB6502_API void lib6502_poke(lib6502_machine* m, uint16_t addr, uint8_t val);
+
+/*
+ *  lib6502_readblock()
+ *
+ *  @desc:      Copies memory out, wrapping at $FFFF
+ *  @param:     m - Machine
+ *              addr - First address
+ *              buf - Receives len bytes
+ *              len - Bytes to copy
+ *  @return:    None
+ * */
+LIB6502_API void lib6502_readblock(const lib6502_machine* m, uint16_t addr, void* buf,
+                                   size_t len);
+
+/*
+ *  lib6502_writeblock()
+ *
+ *  @desc:      Copies into memory, wrapping at $FFFF
+ *  @param:     m - Machine
+ *              addr - First address
+ *              buf - len bytes to store
+ *              len - Bytes to copy
+ *  @return:    None
+ * */
+LIB6502_API void lib6502_writeblock(lib6502_machine* m, uint16_t addr, const void* buf,
+                                    size_t len);
+
+// Devices and events ----------------------------------------------------------
+/*
+ *  lib6502_mapio()
+ *
+ *  @desc:      Maps a device over the inclusive range [lo, hi]. CPU reads
+ *              and writes there go to its callbacks; writes also land in
+ *              memory.
+ *  @param:     m - Machine
+ *              lo, hi - Device addresses
+ *              read, write - Callbacks
+ *              ctx - Passed through to the callbacks
+ *  @return:    Mapping id for lib6502_unmapio()
+ * */
+LIB6502_API int lib6502_mapio(lib6502_machine* m, uint16_t lo, uint16_t hi,
+                              lib6502_ioread read, lib6502_iowrite write, void* ctx);
+
+/*
+ *  lib6502_unmapio()
+ *
+ *  @desc:      Removes a device mapping
+ *  @return:    0 if there was none
+ * */
+LIB6502_API int lib6502_unmapio(lib6502_machine* m, int id);
+
+/*
+ *  lib6502_schedule()
+ *
+ *  @desc:      Calls fn once the clock reaches when
+ *  @param:     m - Machine
+ *              when - Clock cycle
+ *              fn - Callback, which may schedule again
+ *              ctx - Passed through to fn
+ *  @return:    Event id for lib6502_cancel()
+ * */
+LIB6502_API int lib6502_schedule(lib6502_machine* m, uint64_t when, lib6502_event fn,
+                                 void* ctx);
+
+/*
+ *  lib6502_cancel()
+ *
+ *  @desc:      Removes a pending event
+ *  @return:    0 if it had fired or never existed
+ * */
+LIB6502_API int lib6502_cancel(lib6502_machine* m, int id);
+
+/*
+ *  lib6502_addwatch()
+ *
+ *  @desc:      Stops lib6502_run() on accesses to the inclusive range
+ *              [lo, hi]
+ *  @param:     m - Machine
+ *              lo, hi - Watched addresses
+ *              kind - LIB6502_WATCH_* bits
+ *  @return:    Watchpoint id for lib6502_delwatch()
+ * */
+LIB6502_API int lib6502_addwatch(lib6502_machine* m, uint16_t lo, uint16_t hi, int kind);
+
+/*
+ *  lib6502_delwatch()
+ *
+ *  @desc:      Removes a watchpoint
+ *  @return:    0 if there was none
+ * */
+LIB6502_API int lib6502_delwatch(lib6502_machine* m, int id);
+
+/*
+ *  lib6502_addtrap()
+ *
+ *  @desc:      Runs fn instead of the subroutine at addr, then returns as
+ *              RTS would, charging cycles; replaces any host call there
+ *  @param:     m - Machine
+ *              addr - Entry point of the subroutine
+ *              fn - Native implementation
+ *              ctx - Passed through to fn
+ *              cycles - Cycles to charge per call, RTS included
+ *  @return:    1, or 0 if out of memory
+ * */
+LIB6502_API int lib6502_addtrap(lib6502_machine* m, uint16_t addr, lib6502_hostcall fn,
+                                void* ctx, uint32_t cycles);
+
+/*
+ *  lib6502_deltrap()
+ *
+ *  @desc:      Removes the host call at addr
+ *  @return:    0 if there was none
+ * */
+LIB6502_API int lib6502_deltrap(lib6502_machine* m, uint16_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //INC_6502_LIB6502_H
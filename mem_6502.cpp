@@ -15,11 +15,57 @@
 // Creates new mem_6502 in the empty state.
 mem_6502::mem_6502(){
     memset(data, 0, sizeof(data));
+    memset(pageflags, 0, sizeof(pageflags));
+    memset(breakrefs, 0, sizeof(breakrefs));
+    memset(coderefs, 0, sizeof(coderefs));
+    memset(traprefs, 0, sizeof(traprefs));
+    memset(codedirty, 0, sizeof(codedirty));
+    nextwatch = 1;
+    watchkinds = 0;
+    hit = false;
+    lasthit = {};
+    writelog = nullptr;
+    nextio = 1;
+    iohits = 0;
 }
 
 // Copy constructor.
-mem_6502::mem_6502(const mem_6502& Mem){
-    memcpy(data, Mem.data, sizeof(MAX_MEM));
+mem_6502::mem_6502(const mem_6502& Mem) : watches(Mem.watches), devices(Mem.devices){
+    memcpy(data, Mem.data, sizeof(data));
+    memcpy(pageflags, Mem.pageflags, sizeof(pageflags));
+    memcpy(breakrefs, Mem.breakrefs, sizeof(breakrefs));
+    memcpy(coderefs, Mem.coderefs, sizeof(coderefs));
+    memcpy(traprefs, Mem.traprefs, sizeof(traprefs));
+    memcpy(codedirty, Mem.codedirty, sizeof(codedirty));
+    nextwatch = Mem.nextwatch;
+    watchkinds = Mem.watchkinds;
+    hit = Mem.hit;
+    lasthit = Mem.lasthit;
+    writelog = Mem.writelog;
+    nextio = Mem.nextio;
+    iohits = Mem.iohits;
+}
+
+// Copy assignment, used to snapshot and restore memory.
+mem_6502& mem_6502::operator=(const mem_6502& Mem){
+    if(this != &Mem){
+        memcpy(data, Mem.data, sizeof(data));
+        memcpy(pageflags, Mem.pageflags, sizeof(pageflags));
+        memcpy(breakrefs, Mem.breakrefs, sizeof(breakrefs));
+        memcpy(coderefs, Mem.coderefs, sizeof(coderefs));
+        memcpy(traprefs, Mem.traprefs, sizeof(traprefs));
+        memcpy(codedirty, Mem.codedirty, sizeof(codedirty));
+        watches = Mem.watches;
+        nextwatch = Mem.nextwatch;
+        watchkinds = Mem.watchkinds;
+        hit = Mem.hit;
+        lasthit = Mem.lasthit;
+        writelog = Mem.writelog;
+        devices = Mem.devices;
+        nextio = Mem.nextio;
+        iohits = Mem.iohits;
+    }
+    return *this;
 }
 
 
@@ -35,6 +81,34 @@ void mem_6502::init(){
     memset(data, 0, sizeof(data));
 }
 
+/*
+ *  loadfile()
+ *
+ *  @desc:      Copies a binary image file into memory
+ *  @param:     path - Image file
+ *              addr - Address to load the first byte at
+ *  @return:    true on success, false if the file cannot be read or
+ *              does not fit
+ * */
+bool mem_6502::loadfile(const char* path, word addr){
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr){
+        fprintf(stderr, "ERROR: Cannot open image %s: ", path);
+        perror("");
+        return false;
+    }
+    size_t room = MAX_MEM - addr;
+    size_t len = fread(data + addr, 1, room, file);
+    bool fits = len < room || fgetc(file) == EOF;
+    fclose(file);
+    if(!fits){
+        fprintf(stderr, "ERROR: Image %s does not fit at $%04X (%zu bytes free)\n",
+                path, addr, room);
+        return false;
+    }
+    return true;
+}
+
 /*
  *  writeword()
  *
@@ -44,12 +118,323 @@ void mem_6502::init(){
  *              memory - 6502 memory
  *  @return:    None
  * */
-void mem_6502::writeword(uint32_t& cycles, word writedata, uint32_t addr){
-    data[addr] = writedata & 0xFF;
-    data[addr + 1] = (writedata << 8);
+void mem_6502::writeword(int32_t& cycles, word writedata, uint32_t addr){
+    write(addr, writedata & 0xFF);
+    write(addr + 1, writedata >> 8);
     cycles -= 2;
 }
 
+/*
+ *  addwatch()
+ *
+ *  @desc:      Adds a watchpoint over the inclusive range [lo, hi]
+ *  @param:     lo - First watched address
+ *              hi - Last watched address
+ *              kind - WATCH_READ, WATCH_WRITE and/or WATCH_EXEC
+ *  @return:    Watchpoint id, used to remove it again
+ * */
+int mem_6502::addwatch(word lo, word hi, byte kind){
+    if(lo > hi){
+        word tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+    watches.push_back({nextwatch, lo, hi, kind});
+    updatepages();
+    return nextwatch++;
+}
+
+/*
+ *  delwatch()
+ *
+ *  @desc:      Removes a watchpoint
+ *  @param:     id - Watchpoint id returned by addwatch()
+ *  @return:    true if the watchpoint existed
+ * */
+bool mem_6502::delwatch(int id){
+    for(auto it = watches.begin(); it != watches.end(); ++it){
+        if(it->id == id){
+            watches.erase(it);
+            updatepages();
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  clearwatches()
+ *
+ *  @desc:      Removes all watchpoints
+ *  @param:     None
+ *  @return:    None
+ * */
+void mem_6502::clearwatches(){
+    watches.clear();
+    updatepages();
+}
+
+/*
+ *  markbreak()
+ *
+ *  @desc:      Flags the page holding a breakpoint so the CPU takes its
+ *              slow path there; calls must be balanced
+ *  @param:     addr - Breakpoint address
+ *              on - true when adding a breakpoint, false when removing
+ *  @return:    None
+ * */
+void mem_6502::markbreak(word addr, bool on){
+    uint32_t page = addr >> 8;
+    if(on){
+        breakrefs[page]++;
+        pageflags[page] |= WATCH_BREAK;
+    } else if(breakrefs[page] > 0 && --breakrefs[page] == 0){
+        pageflags[page] &= ~WATCH_BREAK;
+    }
+}
+
+/*
+ *  markcode()
+ *
+ *  @desc:      Flags the page holding addr as the source of translated
+ *              code, so that any write through write() marks it dirty;
+ *              calls must be balanced
+ *  @param:     addr - Address in the page
+ *              on - true when adding a translation, false when removing
+ *  @return:    None
+ * */
+void mem_6502::markcode(word addr, bool on){
+    uint32_t page = addr >> 8;
+    if(on){
+        if(coderefs[page]++ == 0){
+            codedirty[page] = false;
+        }
+        pageflags[page] |= WATCH_CODE;
+    } else if(coderefs[page] > 0 && --coderefs[page] == 0){
+        pageflags[page] &= ~WATCH_CODE;
+    }
+}
+
+/*
+ *  cleardirty()
+ *
+ *  @desc:      Marks the page holding addr clean
+ *  @param:     addr - Address in the page
+ *  @return:    None
+ * */
+void mem_6502::cleardirty(word addr){
+    codedirty[addr >> 8] = false;
+}
+
+/*
+ *  marktrap()
+ *
+ *  @desc:      Flags the page holding a host call so the CPU takes its
+ *              slow path there; calls must be balanced
+ *  @param:     addr - Host call address
+ *              on - true when adding a host call, false when removing
+ *  @return:    None
+ * */
+void mem_6502::marktrap(word addr, bool on){
+    uint32_t page = addr >> 8;
+    if(on){
+        traprefs[page]++;
+        pageflags[page] |= WATCH_TRAP;
+    } else if(traprefs[page] > 0 && --traprefs[page] == 0){
+        pageflags[page] &= ~WATCH_TRAP;
+    }
+}
+
+/*
+ *  setwritelog()
+ *
+ *  @desc:      Appends every following CPU write to a log, taking the
+ *              slow write path on all pages while logging
+ *  @param:     log - Log to append to, or nullptr to stop logging
+ *  @return:    None
+ * */
+void mem_6502::setwritelog(std::vector<memwrite_6502>* log){
+    writelog = log;
+    updatepages();
+}
+
+/*
+ *  mapio()
+ *
+ *  @desc:      Maps a device over the inclusive range [lo, hi]
+ *  @param:     lo - First device address
+ *              hi - Last device address
+ *              read - Read callback
+ *              write - Write callback
+ *              ctx - Passed through to the callbacks
+ *  @return:    Mapping id
+ * */
+int mem_6502::mapio(word lo, word hi, ioread_6502 read, iowrite_6502 write, void* ctx){
+    devices.push_back({nextio, lo, hi, read, write, ctx});
+    updatepages();
+    return nextio++;
+}
+
+/*
+ *  unmapio()
+ *
+ *  @desc:      Removes a device mapping
+ *  @param:     id - Mapping id returned by mapio()
+ *  @return:    true if the mapping existed
+ * */
+bool mem_6502::unmapio(int id){
+    for(size_t i = 0; i < devices.size(); i++){
+        if(devices[i].id == id){
+            devices.erase(devices.begin() + i);
+            updatepages();
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  clearhit()
+ *
+ *  @desc:      Acknowledges a triggered watchpoint
+ *  @param:     None
+ *  @return:    None
+ * */
+void mem_6502::clearhit(){
+    hit = false;
+}
+
+/*
+ *  updatepages()
+ *
+ *  @desc:      Recomputes the per-page watch flags from the watch list
+ * */
+void mem_6502::updatepages(){
+    for(uint32_t page = 0; page < PAGES; page++){
+        pageflags[page] = (breakrefs[page] ? WATCH_BREAK : 0)
+                        | (coderefs[page] ? WATCH_CODE : 0)
+                        | (traprefs[page] ? WATCH_TRAP : 0)
+                        | (writelog != nullptr ? WATCH_LOG : 0);
+    }
+    watchkinds = 0;
+    for(const watch_6502& w : watches){
+        for(uint32_t page = w.lo >> 8; page <= (uint32_t)(w.hi >> 8); page++){
+            pageflags[page] |= w.kind;
+        }
+        watchkinds |= w.kind;
+    }
+    for(const io_6502& d : devices){
+        for(uint32_t page = d.lo >> 8; page <= (uint32_t)(d.hi >> 8); page++){
+            pageflags[page] |= WATCH_IO;
+        }
+    }
+}
+
+/*
+ *  checkwatch()
+ *
+ *  @desc:      Slow path for accesses to pages holding a watchpoint
+ *  @param:     addr - Accessed address
+ *              kind - Kind of access
+ *              value - Value read or written
+ *  @return:    true if a watchpoint triggered
+ * */
+bool mem_6502::checkwatch(word addr, byte kind, byte value){
+    for(const watch_6502& w : watches){
+        if((w.kind & kind) && addr >= w.lo && addr <= w.hi){
+            // report the first access of an instruction that hits
+            if(!hit){
+                hit = true;
+                lasthit = {w.id, addr, kind, value};
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*
+ *  readslow()
+ *
+ *  @desc:      Slow path for reads of watched or device pages
+ *  @param:     addr - Read address
+ *  @return:    Value read
+ * */
+byte mem_6502::readslow(word addr){
+    byte val = data[addr];
+    if(pageflags[addr >> 8] & WATCH_IO){
+        const io_6502* dev = finddevice(addr);
+        if(dev != nullptr){
+            val = dev->read(dev->ctx, addr);
+            iohits++;
+        }
+    }
+    if(pageflags[addr >> 8] & WATCH_READ){
+        checkwatch(addr, WATCH_READ, val);
+    }
+    return val;
+}
+
+/*
+ *  writeslow()
+ *
+ *  @desc:      Slow path for writes to watched, logged, device or code
+ *              pages
+ *  @param:     addr - Written address
+ *              val - Value written
+ *  @return:    None
+ * */
+void mem_6502::writeslow(word addr, byte val){
+    codedirty[addr >> 8] |= (pageflags[addr >> 8] & WATCH_CODE) != 0;
+    if(writelog != nullptr){
+        writelog->push_back({addr, val});
+    }
+    if(pageflags[addr >> 8] & WATCH_WRITE){
+        checkwatch(addr, WATCH_WRITE, val);
+    }
+    if(pageflags[addr >> 8] & WATCH_IO){
+        const io_6502* dev = finddevice(addr);
+        if(dev != nullptr){
+            dev->write(dev->ctx, addr, val);
+            iohits++;
+        }
+    }
+}
+
+/*
+ *  finddevice()
+ *
+ *  @desc:      Returns the device mapped at an address, nullptr if none
+ * */
+const mem_6502::io_6502* mem_6502::finddevice(word addr) const{
+    for(const io_6502& d : devices){
+        if(addr >= d.lo && addr <= d.hi){
+            return &d;
+        }
+    }
+    return nullptr;
+}
+
+// Access functions --------------------------------------------------------
+/*
+ *  lastwatch()
+ *
+ *  @desc:      Returns the access that last triggered a watchpoint
+ * */
+const mem_6502::watchhit_6502& mem_6502::lastwatch() const{
+    return lasthit;
+}
+
+/*
+ *  getwatches()
+ *
+ *  @desc:      Returns the list of active watchpoints
+ * */
+const std::vector<mem_6502::watch_6502>& mem_6502::getwatches() const{
+    return watches;
+}
+
 
 // Overloaded Operators ----------------------------------------------------
 /*
@@ -12,8 +12,83 @@
 #define INC_6502_MEM_6502_H
 
 #include "6502.h"
+#include <vector>
+
+/*
+ *  ioread_6502 / iowrite_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Register access callbacks of a memory mapped device
+ *  @param:     ctx - Pointer given to mapio()
+ *              addr - Accessed address
+ *              val - Value written
+ */
+typedef byte (*ioread_6502)(void* ctx, word addr);
+typedef void (*iowrite_6502)(void* ctx, word addr, byte val);
 
 class mem_6502 {
+public:
+    // watchpoint kinds, also used as per-page flags
+    static constexpr byte
+            WATCH_READ  = 0x01,
+            WATCH_WRITE = 0x02,
+            WATCH_EXEC  = 0x04,
+            WATCH_BREAK = 0x08,     // page holds a debugger breakpoint
+            WATCH_LOG   = 0x10,     // CPU writes are being logged
+            WATCH_IO    = 0x20,     // page holds a mapped device
+            WATCH_CODE  = 0x40,     // page holds translated code, see markcode()
+            WATCH_TRAP  = 0x80;     // page holds a host call, see marktrap()
+
+    /*
+     *  struct watch_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      A watchpoint over the inclusive address range [lo, hi]
+     */
+    struct watch_6502 {
+        int id;
+        word lo, hi;
+        byte kind;      // WATCH_READ | WATCH_WRITE | WATCH_EXEC
+    };
+
+    /*
+     *  struct watchhit_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      Describes the access that triggered a watchpoint
+     */
+    struct watchhit_6502 {
+        int id;         // watchpoint that triggered
+        word addr;      // accessed address
+        byte kind;      // kind of access
+        byte value;     // value read or written
+    };
+
+    /*
+     *  struct io_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      A device mapped over the inclusive address range [lo, hi]
+     */
+    struct io_6502 {
+        int id;
+        word lo, hi;
+        ioread_6502 read;
+        iowrite_6502 write;
+        void* ctx;
+    };
+
+    /*
+     *  struct memwrite_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      One logged CPU write
+     */
+    struct memwrite_6502 {
+        word addr;
+        byte value;
+
+        bool operator==(const memwrite_6502& o) const{
+            return addr == o.addr && value == o.value;
+        }
+    };
+
 private:
     /*
      *  struct Mem
@@ -25,8 +100,76 @@ private:
 
     // Memory Fields
     static constexpr uint32_t MAX_MEM = 1024 * 64;
+    static constexpr uint32_t PAGES = MAX_MEM >> 8;
     byte data[MAX_MEM];
 
+    // Watchpoint Fields
+    // A page only has a flag set while some watchpoint overlaps it, so the
+    // read/write fast path is a single flag test followed by an array index.
+    byte pageflags[PAGES];
+    uint32_t breakrefs[PAGES];  // breakpoints per page, see markbreak()
+    uint32_t coderefs[PAGES];   // translations per page, see markcode()
+    uint32_t traprefs[PAGES];   // host calls per page, see marktrap()
+    bool codedirty[PAGES];      // written since markcode()
+    std::vector<watch_6502> watches;
+    int nextwatch;
+    byte watchkinds;            // kinds of all watchpoints together
+
+    bool hit;                   // set when a watchpoint has triggered
+    watchhit_6502 lasthit;
+
+    std::vector<memwrite_6502>* writelog;   // see setwritelog()
+
+    // Device Fields
+    std::vector<io_6502> devices;
+    int nextio;
+    uint64_t iohits;            // device register accesses
+
+    /*
+     *  updatepages()
+     *
+     *  @desc:      Recomputes the per-page watch flags from the watch list
+     * */
+    void updatepages();
+
+    /*
+     *  checkwatch()
+     *
+     *  @desc:      Slow path for accesses to pages holding a watchpoint
+     *  @param:     addr - Accessed address
+     *              kind - Kind of access
+     *              value - Value read or written
+     *  @return:    true if a watchpoint triggered
+     * */
+    bool checkwatch(word addr, byte kind, byte value);
+
+    /*
+     *  readslow()
+     *
+     *  @desc:      Slow path for reads of watched or device pages
+     *  @param:     addr - Read address
+     *  @return:    Value read from the device or memory
+     * */
+    byte readslow(word addr);
+
+    /*
+     *  writeslow()
+     *
+     *  @desc:      Slow path for writes to watched, logged, device or code
+     *              pages
+     *  @param:     addr - Written address
+     *              val - Value written
+     *  @return:    None
+     * */
+    void writeslow(word addr, byte val);
+
+    /*
+     *  finddevice()
+     *
+     *  @desc:      Returns the device mapped at an address, nullptr if none
+     * */
+    const io_6502* finddevice(word addr) const;
+
 public:
     // Class Constructors & Destructors ----------------------------------------
 
@@ -36,6 +179,9 @@ public:
     // Copy constructor.
     mem_6502(const mem_6502& Mem);
 
+    // Copy assignment, used to snapshot and restore memory.
+    mem_6502& operator=(const mem_6502& Mem);
+
     // Manipulation procedures -------------------------------------------------
     /*
      *  init()
@@ -46,6 +192,246 @@ public:
      * */
     void init();
 
+    /*
+     *  loadfile()
+     *
+     *  @desc:      Copies a binary image file into memory
+     *  @param:     path - Image file
+     *              addr - Address to load the first byte at
+     *  @return:    true on success, false if the file cannot be read or
+     *              does not fit
+     * */
+    bool loadfile(const char* path, word addr);
+
+    /*
+     *  addwatch()
+     *
+     *  @desc:      Adds a watchpoint over the inclusive range [lo, hi]
+     *  @param:     lo - First watched address
+     *              hi - Last watched address
+     *              kind - WATCH_READ, WATCH_WRITE and/or WATCH_EXEC
+     *  @return:    Watchpoint id, used to remove it again
+     * */
+    int addwatch(word lo, word hi, byte kind);
+
+    /*
+     *  delwatch()
+     *
+     *  @desc:      Removes a watchpoint
+     *  @param:     id - Watchpoint id returned by addwatch()
+     *  @return:    true if the watchpoint existed
+     * */
+    bool delwatch(int id);
+
+    /*
+     *  clearwatches()
+     *
+     *  @desc:      Removes all watchpoints
+     *  @param:     None
+     *  @return:    None
+     * */
+    void clearwatches();
+
+    /*
+     *  markbreak()
+     *
+     *  @desc:      Flags the page holding a breakpoint so the CPU takes its
+     *              slow path there; calls must be balanced
+     *  @param:     addr - Breakpoint address
+     *              on - true when adding a breakpoint, false when removing
+     *  @return:    None
+     * */
+    void markbreak(word addr, bool on);
+
+    /*
+     *  markcode()
+     *
+     *  @desc:      Flags the page holding addr as the source of translated
+     *              code, so that any write through write() marks it dirty;
+     *              calls must be balanced
+     *  @param:     addr - Address in the page
+     *              on - true when adding a translation, false when removing
+     *  @return:    None
+     * */
+    void markcode(word addr, bool on);
+
+    /*
+     *  cleardirty()
+     *
+     *  @desc:      Marks the page holding addr clean once its translations
+     *              have been checked against what was written there
+     *  @param:     addr - Address in the page
+     *  @return:    None
+     * */
+    void cleardirty(word addr);
+
+    /*
+     *  marktrap()
+     *
+     *  @desc:      Flags the page holding a host call so the CPU takes its
+     *              slow path there; calls must be balanced
+     *  @param:     addr - Host call address
+     *              on - true when adding a host call, false when removing
+     *  @return:    None
+     * */
+    void marktrap(word addr, bool on);
+
+    /*
+     *  setwritelog()
+     *
+     *  @desc:      Appends every following CPU write to a log, taking the
+     *              slow write path on all pages while logging
+     *  @param:     log - Log to append to, or nullptr to stop logging
+     *  @return:    None
+     * */
+    void setwritelog(std::vector<memwrite_6502>* log);
+
+    /*
+     *  mapio()
+     *
+     *  @desc:      Maps a device over the inclusive range [lo, hi]. CPU reads
+     *              and writes there go to its callbacks; writes also land in
+     *              memory, so operator[] shows the last value written.
+     *  @param:     lo - First device address
+     *              hi - Last device address
+     *              read - Read callback
+     *              write - Write callback
+     *              ctx - Passed through to the callbacks
+     *  @return:    Mapping id, used to unmap it again
+     * */
+    int mapio(word lo, word hi, ioread_6502 read, iowrite_6502 write, void* ctx);
+
+    /*
+     *  unmapio()
+     *
+     *  @desc:      Removes a device mapping
+     *  @param:     id - Mapping id returned by mapio()
+     *  @return:    true if the mapping existed
+     * */
+    bool unmapio(int id);
+
+    /*
+     *  clearhit()
+     *
+     *  @desc:      Acknowledges a triggered watchpoint
+     *  @param:     None
+     *  @return:    None
+     * */
+    void clearhit();
+
+    /*
+     *  writeword()
+     *
+     *  @desc:      Writes a word to memory
+     *  @param:     cycles - Number of cycles to write based on instruction
+     *              writedata - 16bit data to write to memory
+     *              memory - 6502 memory
+     *  @return:    None
+     * */
+    void writeword(int32_t& cycles, word writedata, uint32_t addr);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  read()
+     *
+     *  @desc:      Reads 1 byte as the CPU does, honouring read watchpoints
+     *  @param:     addr - Address to read from
+     *  @return:    1 byte from memory block
+     * */
+    byte read(word addr);
+
+    /*
+     *  fetch()
+     *
+     *  @desc:      Reads an opcode or operand byte; code fetches are not
+     *              data reads and bypass read watchpoints
+     *  @param:     addr - Address to fetch from
+     *  @return:    1 byte from memory block
+     * */
+    byte fetch(word addr) const;
+
+    /*
+     *  write()
+     *
+     *  @desc:      Writes 1 byte as the CPU does, honouring write watchpoints
+     *  @param:     addr - Address to write to
+     *              val - Value to write
+     *  @return:    None
+     * */
+    void write(word addr, byte val);
+
+    /*
+     *  pageflag()
+     *
+     *  @desc:      Returns the watch flags of the page holding an address
+     *  @param:     addr - Address within the page
+     *  @return:    WATCH_* flags of the page
+     * */
+    byte pageflag(word addr) const;
+
+    /*
+     *  execwatch()
+     *
+     *  @desc:      Checks for an execute watchpoint before an opcode fetch
+     *  @param:     addr - Address of the opcode about to execute
+     *  @return:    true if a watchpoint triggered
+     * */
+    bool execwatch(word addr);
+
+    /*
+     *  watchhit()
+     *
+     *  @desc:      Returns true while a triggered watchpoint is unacknowledged
+     * */
+    bool watchhit() const;
+
+    /*
+     *  getdirty()
+     *
+     *  @desc:      Returns true if the page holding addr was written since
+     *              it was flagged with markcode()
+     * */
+    bool getdirty(word addr) const{ return codedirty[addr >> 8]; }
+
+    /*
+     *  getwatchkinds()
+     *
+     *  @desc:      Returns the WATCH_READ, WATCH_WRITE and WATCH_EXEC bits
+     *              of every watchpoint set, wherever it is
+     * */
+    byte getwatchkinds() const{ return watchkinds; }
+
+    /*
+     *  lastwatch()
+     *
+     *  @desc:      Returns the access that last triggered a watchpoint
+     * */
+    const watchhit_6502& lastwatch() const;
+
+    /*
+     *  getwatches()
+     *
+     *  @desc:      Returns the list of active watchpoints
+     * */
+    const std::vector<watch_6502>& getwatches() const;
+
+    /*
+     *  getiohits()
+     *
+     *  @desc:      Returns the number of reads and writes handled by mapped
+     *              devices
+     * */
+    uint64_t getiohits() const{ return iohits; }
+
+    /*
+     *  getdata()
+     *
+     *  @desc:      Returns the memory block for bulk host access; like
+     *              operator[], it bypasses watchpoints and devices
+     * */
+    byte* getdata(){ return data; }
+    const byte* getdata() const{ return data; }
+
     // Overloaded Operators ----------------------------------------------------
     /*
      *  operator[]
@@ -64,17 +450,40 @@ public:
      *  @return:    1 byte from memory block
      * */
     byte& operator[](uint32_t addr);
-
-    /*
-     *  writeword()
-     *
-     *  @desc:      Writes a word to memory
-     *  @param:     cycles - Number of cycles to write based on instruction
-     *              writedata - 16bit data to write to memory
-     *              memory - 6502 memory
-     *  @return:    None
-     * */
-    void writeword(uint32_t& cycles, word writedata, uint32_t addr);
 };
 
+// Inline Access functions -----------------------------------------------------
+// These sit on the CPU's hot path, so they are defined in the header.
+
+inline byte mem_6502::read(word addr){
+    if(pageflags[addr >> 8] & (WATCH_READ | WATCH_IO)){
+        return readslow(addr);
+    }
+    return data[addr];
+}
+
+inline byte mem_6502::fetch(word addr) const{
+    return data[addr];
+}
+
+inline void mem_6502::write(word addr, byte val){
+    data[addr] = val;
+    if(pageflags[addr >> 8] & (WATCH_WRITE | WATCH_LOG | WATCH_IO | WATCH_CODE)){
+        writeslow(addr, val);
+    }
+}
+
+inline byte mem_6502::pageflag(word addr) const{
+    return pageflags[addr >> 8];
+}
+
+inline bool mem_6502::execwatch(word addr){
+    return (pageflags[addr >> 8] & WATCH_EXEC)
+            && checkwatch(addr, WATCH_EXEC, data[addr]);
+}
+
+inline bool mem_6502::watchhit() const{
+    return hit;
+}
+
 #endif //INC_6502_MEM_6502_H
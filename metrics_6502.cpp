@@ -0,0 +1,281 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       metrics_6502.cpp
+ * @desc:       Source file for emulator counters exported to Prometheus
+ *****************************************************************************/
+
+#include "metrics_6502.h"
+#include "sock_6502.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// milliseconds a scrape may take to send its request
+static constexpr int REQUEST_TIMEOUT = 1000;
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates metrics with every counter at zero and nothing exported.
+metrics_6502::metrics_6502(){
+    instructions = cycles = skipped = iohits = slices = 0;
+    mhz = 0.0;
+    aot = false;
+    translated = interpreted = stale = 0;
+    windowstart = std::chrono::steady_clock::now();
+    windowcycles = 0;
+    server = -1;
+    period = DUMP_PERIOD;
+    wake[0] = wake[1] = -1;
+    quit = false;
+}
+
+// Stops the I/O thread, writing the file a last time.
+metrics_6502::~metrics_6502(){
+    quit = true;
+    if(wake[1] >= 0 && write(wake[1], "q", 1) < 0){
+        perror("ERROR: write");
+    }
+    if(io.joinable()){
+        io.join();
+    }
+    if(!path.empty()){
+        dump();
+    }
+    for(int fd : {wake[0], wake[1], server}){
+        if(fd >= 0){
+            close(fd);
+        }
+    }
+    if(!unixpath.empty()){
+        unlink(unixpath.c_str());
+    }
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  open()
+ *
+ *  @desc:      Starts exporting
+ *  @param:     spec - "PORT", "tcp:PORT", "unix:PATH" or nullptr
+ *              file - Dump file or nullptr
+ *              ms - Milliseconds between dumps
+ *  @return:    true on success
+ * */
+bool metrics_6502::open(const char* spec, const char* file, uint32_t ms){
+    if(io.joinable()){
+        fprintf(stderr, "ERROR: Metrics already open\n");
+        return false;
+    }
+    if(spec != nullptr){
+        server = openserver(spec, unixpath);
+        if(server < 0){
+            return false;
+        }
+    }
+    if(file != nullptr){
+        path = file;
+        period = ms > 0 ? ms : DUMP_PERIOD;
+        if(!dump()){
+            return false;
+        }
+    }
+    if(pipe(wake) < 0){
+        perror("ERROR: pipe");
+        return false;
+    }
+    io = std::thread(&metrics_6502::serve, this);
+    return true;
+}
+
+/*
+ *  publish()
+ *
+ *  @desc:      Copies the machine counters, called by the CPU thread
+ *              between execute() slices
+ *  @param:     cpu, mem - Machine
+ *  @return:    None
+ * */
+void metrics_6502::publish(const cpu_6502& cpu, const mem_6502& mem){
+    // the I/O thread only needs each value to be whole, not ordered with
+    // the others
+    uint64_t clock = cpu.getclock();
+    instructions.store(cpu.getretired(), std::memory_order_relaxed);
+    cycles.store(clock, std::memory_order_relaxed);
+    skipped.store(cpu.getskipped(), std::memory_order_relaxed);
+    iohits.store(mem.getiohits(), std::memory_order_relaxed);
+    slices.store(slices.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - windowstart).count();
+    if(elapsed >= 1.0){
+        mhz.store((double)(clock - windowcycles) / elapsed / 1e6, std::memory_order_relaxed);
+        windowstart = now;
+        windowcycles = clock;
+    }
+}
+
+/*
+ *  publish()
+ *
+ *  @desc:      Copies the counters of an ahead of time translation
+ *  @param:     rt - Translation runtime
+ *  @return:    None
+ * */
+void metrics_6502::publish(const aot_6502& rt){
+    translated.store(rt.gettranslated(), std::memory_order_relaxed);
+    interpreted.store(rt.getinterpreted(), std::memory_order_relaxed);
+    stale.store(rt.getstale(), std::memory_order_relaxed);
+    aot.store(true, std::memory_order_relaxed);
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  format()
+ *
+ *  @desc:      Returns the metrics in the Prometheus text format
+ * */
+std::string metrics_6502::format() const{
+    std::string out;
+    char line[256];
+    auto counter = [&](const char* name, const char* help, uint64_t val){
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                 name, help, name, name, (unsigned long long)val);
+        out += line;
+    };
+    auto gauge = [&](const char* name, const char* help, double val){
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s gauge\n%s %.6g\n",
+                 name, help, name, name, val);
+        out += line;
+    };
+
+    counter("emu6502_instructions_total", "Instructions retired.",
+            instructions.load(std::memory_order_relaxed));
+    counter("emu6502_cycles_total", "Emulated clock cycles.",
+            cycles.load(std::memory_order_relaxed));
+    gauge("emu6502_emulated_mhz", "Emulated clock rate over the last second.",
+          mhz.load(std::memory_order_relaxed));
+    counter("emu6502_idle_cycles_skipped_total", "Cycles fast-forwarded over idle loops.",
+            skipped.load(std::memory_order_relaxed));
+    counter("emu6502_io_accesses_total", "Reads and writes handled by mapped devices.",
+            iohits.load(std::memory_order_relaxed));
+    counter("emu6502_slices_total", "Execute slices run.",
+            slices.load(std::memory_order_relaxed));
+
+    if(aot.load(std::memory_order_relaxed)){
+        uint64_t hits = translated.load(std::memory_order_relaxed);
+        uint64_t misses = interpreted.load(std::memory_order_relaxed);
+        counter("emu6502_aot_translated_instructions_total",
+                "Instructions run by ahead of time translated code.", hits);
+        counter("emu6502_aot_interpreted_instructions_total",
+                "Instructions the translated code handed to the interpreter.", misses);
+        gauge("emu6502_aot_hit_ratio", "Share of instructions run by translated code.",
+              hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0);
+        counter("emu6502_aot_stale_total", "Translated blocks refused as overwritten.",
+                stale.load(std::memory_order_relaxed));
+    }
+    return out;
+}
+
+
+// I/O thread --------------------------------------------------------------
+/*
+ *  serve()
+ *
+ *  @desc:      I/O thread body: answers scrapes and dumps the file
+ * */
+void metrics_6502::serve(){
+    auto next = std::chrono::steady_clock::now() + std::chrono::milliseconds(period);
+    while(!quit){
+        pollfd fds[2];
+        nfds_t n = 0;
+        fds[n++] = {wake[0], POLLIN, 0};
+        if(server >= 0){
+            fds[n++] = {server, POLLIN, 0};
+        }
+        int timeout = -1;
+        if(!path.empty()){
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next - std::chrono::steady_clock::now()).count();
+            timeout = wait > 0 ? (int)wait : 0;
+        }
+        if(poll(fds, n, timeout) < 0 && errno != EINTR){
+            perror("ERROR: poll");
+            break;
+        }
+
+        if(fds[0].revents & POLLIN){
+            char drain[64];
+            if(read(wake[0], drain, sizeof(drain)) < 0){
+                perror("ERROR: read");
+            }
+        }
+        if(n > 1 && (fds[1].revents & POLLIN)){
+            int client = accept(server, nullptr, nullptr);
+            if(client >= 0){
+                respond(client);
+                close(client);
+            }
+        }
+        if(!path.empty() && std::chrono::steady_clock::now() >= next){
+            dump();
+            next += std::chrono::milliseconds(period);
+        }
+    }
+}
+
+void metrics_6502::respond(int client) const{
+    // the request itself does not matter, only that it has been sent
+    std::string request;
+    char buf[1024];
+    while(request.find("\r\n\r\n") == std::string::npos && request.size() < 8192){
+        pollfd fd = {client, POLLIN, 0};
+        if(poll(&fd, 1, REQUEST_TIMEOUT) <= 0){
+            return;
+        }
+        ssize_t len = read(client, buf, sizeof(buf));
+        if(len <= 0){
+            return;
+        }
+        request.append(buf, (size_t)len);
+    }
+
+    std::string body = format();
+    char header[160];
+    snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\n"
+             "Content-Type: text/plain; version=0.0.4\r\n"
+             "Content-Length: %zu\r\nConnection: close\r\n\r\n", body.size());
+    std::string reply = header + body;
+    for(size_t at = 0; at < reply.size();){
+        ssize_t len = send(client, reply.data() + at, reply.size() - at, MSG_NOSIGNAL);
+        if(len <= 0){
+            return;
+        }
+        at += (size_t)len;
+    }
+}
+
+bool metrics_6502::dump() const{
+    // written aside and renamed over, so readers never see half a file
+    std::string tmp = path + ".tmp";
+    FILE* file = fopen(tmp.c_str(), "w");
+    if(file == nullptr){
+        fprintf(stderr, "ERROR: Cannot open %s: %s\n", tmp.c_str(), strerror(errno));
+        return false;
+    }
+    std::string body = format();
+    bool ok = fwrite(body.data(), 1, body.size(), file) == body.size();
+    ok = fclose(file) == 0 && ok;
+    if(!ok || rename(tmp.c_str(), path.c_str()) < 0){
+        fprintf(stderr, "ERROR: Cannot write %s: %s\n", path.c_str(), strerror(errno));
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       metrics_6502.h
+ * @desc:       Header file for emulator counters exported to Prometheus
+ * @ref:        https://prometheus.io/docs/instrumenting/exposition_formats/
+ * @note:       The CPU thread publishes the counters once per execute()
+ *              slice with relaxed atomic stores, nothing is counted per
+ *              instruction. An I/O thread serves them in the text
+ *              exposition format over HTTP and rewrites a file with them
+ *              periodically, for the node exporter textfile collector.
+ *****************************************************************************/
+
+#ifndef INC_6502_METRICS_6502_H
+#define INC_6502_METRICS_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "aot_6502.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+class metrics_6502 {
+public:
+    // default interval between file dumps, in milliseconds
+    static constexpr uint32_t DUMP_PERIOD = 1000;
+
+private:
+    // Counter Fields, stored by the CPU thread and loaded by the I/O thread
+    std::atomic<uint64_t> instructions;
+    std::atomic<uint64_t> cycles;
+    std::atomic<uint64_t> skipped;      // cycles fast-forwarded over idle loops
+    std::atomic<uint64_t> iohits;       // device register accesses
+    std::atomic<uint64_t> slices;       // publish() calls
+    std::atomic<double> mhz;            // emulated clock over the last second
+    std::atomic<bool> aot;              // the translator counters are valid
+    std::atomic<uint64_t> translated;   // instructions run by translated code
+    std::atomic<uint64_t> interpreted;  // instructions handed to the interpreter
+    std::atomic<uint64_t> stale;        // translations refused as overwritten
+
+    // Rate Fields, CPU thread only
+    std::chrono::steady_clock::time_point windowstart;
+    uint64_t windowcycles;
+
+    // Host Fields
+    int server;             // listening socket, -1 if none
+    std::string unixpath;   // socket file to remove, if any
+    std::string path;       // dump file, empty if none
+    uint32_t period;        // milliseconds between dumps
+    int wake[2];            // pipe waking the I/O thread
+    std::atomic<bool> quit;
+    std::thread io;
+
+    /*
+     *  serve()
+     *
+     *  @desc:      I/O thread body: answers scrapes and dumps the file
+     * */
+    void serve();
+
+    /*
+     *  respond()
+     *
+     *  @desc:      Reads one HTTP request from client and answers it with
+     *              the metrics, whatever the path
+     * */
+    void respond(int client) const;
+
+    /*
+     *  dump()
+     *
+     *  @desc:      Replaces the dump file with the current metrics
+     *  @return:    false if it cannot be written
+     * */
+    bool dump() const;
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates metrics with every counter at zero and nothing exported.
+    metrics_6502();
+
+    // Stops the I/O thread, writing the file a last time.
+    ~metrics_6502();
+
+    metrics_6502(const metrics_6502&) = delete;
+    metrics_6502& operator=(const metrics_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  open()
+     *
+     *  @desc:      Starts exporting
+     *  @param:     spec - "PORT", "tcp:PORT" or "unix:PATH" to serve HTTP
+     *                     scrapes on, nullptr for none
+     *              file - Path of the file to dump, nullptr for none
+     *              ms - Milliseconds between dumps
+     *  @return:    true on success
+     * */
+    bool open(const char* spec, const char* file, uint32_t ms = DUMP_PERIOD);
+
+    /*
+     *  publish()
+     *
+     *  @desc:      Copies the machine counters, called by the CPU thread
+     *              between execute() slices
+     *  @param:     cpu, mem - Machine
+     *  @return:    None
+     * */
+    void publish(const cpu_6502& cpu, const mem_6502& mem);
+
+    /*
+     *  publish()
+     *
+     *  @desc:      Copies the counters of an ahead of time translation
+     *  @param:     rt - Translation runtime
+     *  @return:    None
+     * */
+    void publish(const aot_6502& rt);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  format()
+     *
+     *  @desc:      Returns the metrics in the Prometheus text format
+     * */
+    std::string format() const;
+};
+
+#endif //INC_6502_METRICS_6502_H
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       pace_6502.cpp
+ * @desc:       Source file for real time pacing of emulated cycles
+ *****************************************************************************/
+
+#include "pace_6502.h"
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// bounds of the spin before each deadline, ns
+static constexpr int64_t SPIN_MIN = 10000;
+static constexpr int64_t SPIN_MAX = 1000000;
+
+// step of the oversleep estimate, ns; it tracks the 95th percentile by
+// moving up 19 steps on a later wake and down one on an earlier one, which
+// a rare multi-millisecond stall cannot drag far
+static constexpr int64_t OVERSLEEP_STEP = 500;
+
+/*
+ *  monotonic()
+ *
+ *  @desc:      Returns the monotonic clock in ns
+ * */
+static int64_t monotonic(){
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a pacer for a CPU clocked at hz.
+pace_6502::pace_6502(uint64_t hz){
+    this->hz = hz ? hz : 1;
+    basecycle = 0;
+    basetime = monotonic();
+    oversleep = 50000;
+    spin = oversleep + SPIN_MIN;
+    slices = resyncs = 0;
+    jittersum = jittermax = 0;
+    memset(hist, 0, sizeof(hist));
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  start()
+ *
+ *  @desc:      Ties cycle to the current time
+ *  @param:     cycle - Current cpu clock
+ *  @return:    None
+ * */
+void pace_6502::start(uint64_t cycle){
+    basecycle = cycle;
+    basetime = monotonic();
+}
+
+/*
+ *  wait()
+ *
+ *  @desc:      Returns when the wall clock reaches cycle
+ *  @param:     cycle - Current cpu clock
+ *  @return:    None
+ * */
+void pace_6502::wait(uint64_t cycle){
+    int64_t target = deadline(cycle);
+    int64_t now = monotonic();
+
+    if(target - now > spin){
+        int64_t wake = target - spin;
+        timespec ts = {(time_t)(wake / 1000000000), (long)(wake % 1000000000)};
+        while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR){
+        }
+        now = monotonic();
+        oversleep += now - wake > oversleep ? 19 * OVERSLEEP_STEP : -OVERSLEEP_STEP;
+        spin = oversleep + SPIN_MIN;
+        spin = spin < SPIN_MIN ? SPIN_MIN : spin > SPIN_MAX ? SPIN_MAX : spin;
+    }
+    while(now < target){
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+        now = monotonic();
+    }
+
+    int64_t jitter = now - target;
+    slices++;
+    jittersum += jitter;
+    if(jitter > jittermax){
+        jittermax = jitter;
+    }
+    uint64_t us = (uint64_t)(jitter / 1000);
+    hist[us < HIST_BUCKETS ? us : HIST_BUCKETS]++;
+
+    if(jitter > RESYNC_NS){
+        resyncs++;
+        start(cycle);
+    }
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  percentile()
+ *
+ *  @desc:      Returns the p-th percentile of wake up jitter
+ *  @param:     p - Percentile, 0 to 100
+ *  @return:    Jitter in us, HIST_BUCKETS if beyond the histogram
+ * */
+uint32_t pace_6502::percentile(double p) const{
+    uint64_t rank = (uint64_t)((double)slices * p / 100.0);
+    uint64_t seen = 0;
+    for(uint32_t us = 0; us < HIST_BUCKETS; us++){
+        seen += hist[us];
+        if(seen > rank){
+            return us;
+        }
+    }
+    return HIST_BUCKETS;
+}
+
+/*
+ *  report()
+ *
+ *  @desc:      Prints jitter statistics
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void pace_6502::report(FILE* file) const{
+    fprintf(file, "pace: %llu slices at %llu Hz, jitter mean %.1f us, p50 %u us, p99 %u us, "
+                  "max %.1f us, %llu resyncs\n",
+            (unsigned long long)slices, (unsigned long long)hz, getjittermean() / 1000.0,
+            percentile(50), percentile(99), (double)jittermax / 1000.0,
+            (unsigned long long)resyncs);
+}
+
+
+// Private helpers ---------------------------------------------------------
+int64_t pace_6502::deadline(uint64_t cycle) const{
+    // split so that long runs cannot overflow cycles * 1e9
+    uint64_t cycles = cycle - basecycle;
+    return basetime + (int64_t)((cycles / hz) * 1000000000
+                                + (cycles % hz) * 1000000000 / hz);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       pace_6502.h
+ * @desc:       Header file for real time pacing of emulated cycles
+ * @note:       The CPU runs in slices as fast as it can; after each slice
+ *              wait() holds the host back until the wall clock catches up
+ *              with the emulated one. It sleeps on the monotonic clock until
+ *              shortly before the deadline and spins for the rest, and
+ *              learns how late the host wakes from sleep to keep that spin
+ *              as short as it can.
+ *****************************************************************************/
+
+#ifndef INC_6502_PACE_6502_H
+#define INC_6502_PACE_6502_H
+
+#include "6502.h"
+
+class pace_6502 {
+public:
+    // jitter histogram resolution and range, the last bucket takes the rest
+    static constexpr uint32_t HIST_BUCKETS = 1000;  // 1 us each
+
+    // a host stall longer than this restarts pacing instead of catching up
+    // with a burst of unpaced slices
+    static constexpr int64_t RESYNC_NS = 20000000;
+
+private:
+    // Pacing Fields
+    uint64_t hz;            // emulated cycles per second
+    uint64_t basecycle;     // cycle at basetime
+    int64_t basetime;       // monotonic ns
+    int64_t oversleep;      // 95th percentile lateness of a wake from sleep, ns
+    int64_t spin;           // ns before a deadline to stop sleeping
+
+    // Statistics Fields
+    uint64_t slices;
+    uint64_t resyncs;
+    int64_t jittersum;      // ns
+    int64_t jittermax;      // ns
+    uint64_t hist[HIST_BUCKETS + 1];
+
+    /*
+     *  deadline()
+     *
+     *  @desc:      Returns the monotonic time cycle is due at, in ns
+     * */
+    int64_t deadline(uint64_t cycle) const;
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a pacer for a CPU clocked at hz.
+    explicit pace_6502(uint64_t hz);
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  start()
+     *
+     *  @desc:      Ties cycle to the current time
+     *  @param:     cycle - Current cpu clock
+     *  @return:    None
+     * */
+    void start(uint64_t cycle);
+
+    /*
+     *  wait()
+     *
+     *  @desc:      Returns when the wall clock reaches cycle
+     *  @param:     cycle - Current cpu clock
+     *  @return:    None
+     * */
+    void wait(uint64_t cycle);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  percentile()
+     *
+     *  @desc:      Returns the p-th percentile of wake up jitter
+     *  @param:     p - Percentile, 0 to 100
+     *  @return:    Jitter in us, HIST_BUCKETS if beyond the histogram
+     * */
+    uint32_t percentile(double p) const;
+
+    /*
+     *  report()
+     *
+     *  @desc:      Prints jitter statistics
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void report(FILE* file) const;
+
+    uint64_t getslices() const{ return slices; }
+    uint64_t getresyncs() const{ return resyncs; }
+    int64_t getjittermax() const{ return jittermax; }
+    double getjittermean() const{ return slices ? (double)jittersum / (double)slices : 0.0; }
+};
+
+#endif //INC_6502_PACE_6502_H
@@ -0,0 +1,264 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       perf_6502.cpp
+ * @desc:       Source file for host performance counters read through
+ *              perf_event_open
+ *****************************************************************************/
+
+#include "perf_6502.h"
+#include "dis_6502.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// steps between two empty reads measuring what a read costs; spread over
+// the run so the estimate follows the host as it speeds up or slows down
+static constexpr uint32_t BASELINE_EVERY = 16;
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a profiler with no counters open.
+perf_6502::perf_6502(){
+    for(uint32_t e = 0; e < EVENTS; e++){
+        fds[e] = -1;
+        slot[e] = 0;
+        baseline[e] = 0;
+        last[e] = 0;
+    }
+    opened = 0;
+    leader = -1;
+    for(uint32_t op = 0; op < 0x100; op++){
+        groups[op] = (byte)opgroup((byte)op);
+    }
+    primed = false;
+    sincebase = 0;
+    basereads = 0;
+    for(uint32_t g = 0; g < GROUPS; g++){
+        steps[g] = 0;
+        for(uint32_t e = 0; e < EVENTS; e++){
+            totals[g][e] = 0;
+        }
+    }
+}
+
+// Closes the counters.
+perf_6502::~perf_6502(){
+    for(int fd : fds){
+        if(fd >= 0){
+            close(fd);
+        }
+    }
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  open()
+ *
+ *  @desc:      Opens every event the host supports, reporting the others
+ *              on stderr
+ *  @param:     None
+ *  @return:    false if no event could be opened
+ * */
+bool perf_6502::open(){
+    static const struct { uint32_t type; uint64_t config; } EVENTCONFIG[EVENTS] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1I
+                                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    };
+
+    for(uint32_t e = 0; e < EVENTS; e++){
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = EVENTCONFIG[e].type;
+        attr.config = EVENTCONFIG[e].config;
+        attr.disabled = leader < 0;     // the group starts with its leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+        if(fd < 0){
+            fprintf(stderr, "perf: %s unavailable: %s\n", eventname(e), strerror(errno));
+            continue;
+        }
+        fds[e] = fd;
+        slot[e] = opened++;
+        if(leader < 0){
+            leader = fd;
+        }
+    }
+    if(leader < 0){
+        return false;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+/*
+ *  sample()
+ *
+ *  @desc:      Reads the counters
+ *  @param:     values - Receives EVENTS counts, 0 for events not open
+ *  @return:    false if they cannot be read
+ * */
+bool perf_6502::sample(uint64_t* values) const{
+    uint64_t buf[1 + EVENTS];
+    ssize_t len = leader >= 0 ? read(leader, buf, sizeof(buf)) : -1;
+    if(len < (ssize_t)(sizeof(uint64_t) * (1 + opened))){
+        for(uint32_t e = 0; e < EVENTS; e++){
+            values[e] = 0;
+        }
+        return false;
+    }
+    for(uint32_t e = 0; e < EVENTS; e++){
+        values[e] = fds[e] >= 0 ? buf[1 + slot[e]] : 0;
+    }
+    return true;
+}
+
+/*
+ *  step()
+ *
+ *  @desc:      Runs one instruction and charges the counters it moved
+ *              to its opcode group
+ *  @param:     cpu, mem - Machine
+ *  @return:    None
+ * */
+void perf_6502::step(cpu_6502& cpu, mem_6502& mem){
+    if(!primed){
+        primed = sample(last);
+    }
+    // a budget of one cycle runs exactly one instruction and never fuses
+    uint64_t retired = cpu.getretired();
+    byte op = mem[cpu.getregs().PC];
+    cpu.execute(1, mem);
+    uint64_t now[EVENTS];
+    if(!sample(now)){
+        return;
+    }
+    uint32_t g = cpu.getretired() != retired ? groups[op] : GROUP_INTERRUPT;
+    steps[g]++;
+    for(uint32_t e = 0; e < EVENTS; e++){
+        totals[g][e] += now[e] - last[e];
+        last[e] = now[e];
+    }
+
+    if(++sincebase == BASELINE_EVERY){
+        sincebase = 0;
+        if(sample(now)){
+            basereads++;
+            for(uint32_t e = 0; e < EVENTS; e++){
+                baseline[e] += now[e] - last[e];
+                last[e] = now[e];
+            }
+        }
+    }
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  report()
+ *
+ *  @desc:      Prints the counters per instruction of each opcode group
+ *              step() ran
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void perf_6502::report(FILE* file) const{
+    uint64_t total = 0;
+    for(uint32_t g = 0; g < GROUPS; g++){
+        total += steps[g];
+    }
+    fprintf(file, "perf: %llu instructions stepped, per instruction of each group\n",
+            (unsigned long long)total);
+    fprintf(file, "%-10s %12s %7s", "group", "steps", "share");
+    for(uint32_t e = 0; e < EVENTS; e++){
+        if(available(e)){
+            fprintf(file, " %14s", eventname(e));
+        }
+    }
+    fprintf(file, "\n");
+    for(uint32_t g = 0; g < GROUPS; g++){
+        if(steps[g] == 0){
+            continue;
+        }
+        fprintf(file, "%-10s %12llu %6.2f%%", groupname(g), (unsigned long long)steps[g],
+                100.0 * (double)steps[g] / (double)total);
+        for(uint32_t e = 0; e < EVENTS; e++){
+            if(available(e)){
+                // single steps are noisy, an average can fall below the
+                // cost of the reads themselves
+                double read = basereads > 0 ? (double)baseline[e] / (double)basereads : 0.0;
+                double mean = (double)totals[g][e] / (double)steps[g] - read;
+                fprintf(file, " %14.2f", mean > 0.0 ? mean : 0.0);
+            }
+        }
+        fprintf(file, "\n");
+    }
+}
+
+/*
+ *  eventname()
+ *
+ *  @desc:      Returns the perf name of an event
+ * */
+const char* perf_6502::eventname(uint32_t event){
+    static const char* const NAMES[EVENTS] = {
+            "cycles", "instructions", "branch-misses", "L1-icache-misses", "task-clock"};
+    return event < EVENTS ? NAMES[event] : "?";
+}
+
+/*
+ *  groupname()
+ *
+ *  @desc:      Returns the name of an opcode group
+ * */
+const char* perf_6502::groupname(uint32_t group){
+    static const char* const NAMES[GROUPS] = {
+            "load", "store", "arith", "logic", "shift", "incdec", "compare",
+            "branch", "jump", "stack", "transfer", "flag", "other", "interrupt"};
+    return group < GROUPS ? NAMES[group] : "?";
+}
+
+/*
+ *  opgroup()
+ *
+ *  @desc:      Returns the GROUP_* of an opcode
+ * */
+uint32_t perf_6502::opgroup(byte opcode){
+    // undocumented opcodes are listed under the operation they end with
+    static const struct { const char* names; uint32_t group; } GROUPNAMES[] = {
+            {"LDA LDX LDY LAX LAS LXA", GROUP_LOAD},
+            {"STA STX STY SAX SHA SHX SHY TAS", GROUP_STORE},
+            {"ADC SBC RRA ISC SBX", GROUP_ARITH},
+            {"AND ORA EOR BIT SLO RLA SRE ANC ANE", GROUP_LOGIC},
+            {"ASL LSR ROL ROR ALR ARR", GROUP_SHIFT},
+            {"INC DEC INX INY DEX DEY", GROUP_INCDEC},
+            {"CMP CPX CPY DCP", GROUP_COMPARE},
+            {"JMP JSR RTS RTI BRK", GROUP_JUMP},
+            {"PHA PHP PLA PLP", GROUP_STACK},
+            {"TAX TAY TXA TYA TSX TXS", GROUP_TRANSFER},
+            {"CLC SEC CLI SEI CLD SED CLV", GROUP_FLAG},
+    };
+    const dis_6502::opinfo_6502& info = dis_6502::info(opcode);
+    if(info.flow == dis_6502::FLOW_BRANCH){
+        return GROUP_BRANCH;
+    }
+    for(const auto& entry : GROUPNAMES){
+        if(strstr(entry.names, info.name) != nullptr){
+            return entry.group;
+        }
+    }
+    return GROUP_OTHER;
+}
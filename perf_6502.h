@@ -0,0 +1,161 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       perf_6502.h
+ * @desc:       Header file for host performance counters read through
+ *              perf_event_open
+ * @note:       The counters are opened as one group on the calling thread,
+ *              user space only, and read with a single read() each time.
+ *              sample() reads them around a whole run; step() runs one
+ *              emulated instruction between two reads and charges the
+ *              difference to the group of its opcode, less the mean of
+ *              empty reads taken every few steps. Stepping makes every instruction
+ *              a separate execute() call plus a system call, so its
+ *              numbers compare opcode groups with one another rather than
+ *              showing the absolute cost of an instruction in a long slice.
+ *              Events the host does not support (no PMU, virtual machines,
+ *              perf_event_paranoid) are reported and left out; the task
+ *              clock is software and nearly always available.
+ *****************************************************************************/
+
+#ifndef INC_6502_PERF_6502_H
+#define INC_6502_PERF_6502_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+
+class perf_6502 {
+public:
+    // events, in the order they are tried as group leader
+    static constexpr uint32_t
+            EVENT_CYCLES        = 0,
+            EVENT_INSTRUCTIONS  = 1,
+            EVENT_BRANCH_MISSES = 2,
+            EVENT_L1I_MISSES    = 3,
+            EVENT_TASK_CLOCK    = 4,    // ns
+            EVENTS              = 5;
+
+    // opcode groups step() attributes to; an undocumented opcode goes with
+    // the operation it ends with, SLO with ORA, DCP with CMP and so on
+    static constexpr uint32_t
+            GROUP_LOAD      = 0,    // LDA LDX LDY LAX LAS LXA
+            GROUP_STORE     = 1,    // STA STX STY SAX SHA SHX SHY TAS
+            GROUP_ARITH     = 2,    // ADC SBC
+            GROUP_LOGIC     = 3,    // AND ORA EOR BIT
+            GROUP_SHIFT     = 4,    // ASL LSR ROL ROR
+            GROUP_INCDEC    = 5,    // INC DEC INX INY DEX DEY
+            GROUP_COMPARE   = 6,    // CMP CPX CPY
+            GROUP_BRANCH    = 7,    // conditional branches
+            GROUP_JUMP      = 8,    // JMP JSR RTS RTI BRK
+            GROUP_STACK     = 9,    // PHA PHP PLA PLP
+            GROUP_TRANSFER  = 10,   // register transfers
+            GROUP_FLAG      = 11,   // flag sets and clears
+            GROUP_OTHER     = 12,   // NOPs and JAM
+            GROUP_INTERRUPT = 13,   // steps that ran no instruction: interrupt
+                                    // entries, a jammed CPU
+            GROUPS          = 14;
+
+private:
+    // Counter Fields
+    int fds[EVENTS];            // -1 if not open
+    uint32_t slot[EVENTS];      // position in the group read
+    uint32_t opened;
+    int leader;
+
+    // Attribution Fields
+    byte groups[0x100];         // GROUP_* of each opcode
+    uint64_t last[EVENTS];      // counts at the end of the last step
+    bool primed;
+    uint32_t sincebase;         // steps since the last empty read
+    uint64_t basereads;         // empty reads taken
+    uint64_t baseline[EVENTS];  // counts moved by them
+    uint64_t steps[GROUPS];
+    uint64_t totals[GROUPS][EVENTS];    // reads included
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a profiler with no counters open.
+    perf_6502();
+
+    // Closes the counters.
+    ~perf_6502();
+
+    perf_6502(const perf_6502&) = delete;
+    perf_6502& operator=(const perf_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  open()
+     *
+     *  @desc:      Opens every event the host supports, reporting the others
+     *              on stderr
+     *  @param:     None
+     *  @return:    false if no event could be opened
+     * */
+    bool open();
+
+    /*
+     *  sample()
+     *
+     *  @desc:      Reads the counters
+     *  @param:     values - Receives EVENTS counts, 0 for events not open
+     *  @return:    false if they cannot be read
+     * */
+    bool sample(uint64_t* values) const;
+
+    /*
+     *  step()
+     *
+     *  @desc:      Runs one instruction and charges the counters it moved
+     *              to its opcode group
+     *  @param:     cpu, mem - Machine
+     *  @return:    None
+     * */
+    void step(cpu_6502& cpu, mem_6502& mem);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  available()
+     *
+     *  @desc:      Returns whether event was opened
+     * */
+    bool available(uint32_t event) const{ return event < EVENTS && fds[event] >= 0; }
+
+    /*
+     *  report()
+     *
+     *  @desc:      Prints the counters per instruction of each opcode group
+     *              step() ran
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void report(FILE* file) const;
+
+    /*
+     *  eventname()
+     *
+     *  @desc:      Returns the perf name of an event
+     * */
+    static const char* eventname(uint32_t event);
+
+    /*
+     *  groupname()
+     *
+     *  @desc:      Returns the name of an opcode group
+     * */
+    static const char* groupname(uint32_t group);
+
+    /*
+     *  opgroup()
+     *
+     *  @desc:      Returns the GROUP_* of an opcode
+     * */
+    static uint32_t opgroup(byte opcode);
+};
+
+#endif //INC_6502_PERF_6502_H
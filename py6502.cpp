@@ -0,0 +1,591 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       py6502.cpp
+ * @desc:       Python bindings over the C interface in lib6502.h
+ * @note:       py6502.Machine supports the buffer protocol over the 64 KiB
+ *              memory block, so memoryview(m), m.memory and
+ *              numpy.frombuffer(m, numpy.uint8) share memory with the
+ *              emulator without copying. run() releases the GIL while the
+ *              CPU runs, so machines on separate threads run in parallel;
+ *              Python callbacks take the GIL back only while they run. An
+ *              exception raised by a callback is held until run() returns
+ *              and raised there. A machine cannot be reconfigured while it
+ *              runs, and only its own callbacks may drive its interrupt
+ *              lines then.
+ *****************************************************************************/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "lib6502.h"
+#include <memory>
+#include <unordered_map>
+
+static constexpr Py_ssize_t MEMORY_SIZE = 0x10000;
+
+struct pymachine_6502;
+
+/*
+ *  struct pyhook_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Python callables registered as a device or a host call, the
+ *              context of their trampolines
+ */
+struct pyhook_6502 {
+    pymachine_6502* self;
+    PyObject* read;     // device read, or the host call
+    PyObject* write;    // device write, nullptr for a host call
+};
+
+/*
+ *  struct pymachine_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      py6502.Machine instance
+ */
+struct pymachine_6502 {
+    PyObject_HEAD
+    lib6502_machine* m;
+    bool running;
+    unsigned long runner;   // thread in run()
+    PyObject* errtype;  // first exception raised by a callback in run()
+    PyObject* errvalue;
+    PyObject* errtrace;
+    std::unordered_map<int, std::unique_ptr<pyhook_6502>>* devices;    // by mapping id
+    std::unordered_map<uint16_t, std::unique_ptr<pyhook_6502>>* traps; // by address
+};
+
+
+// Private helpers -------------------------------------------------------------
+// Holds the exception a callback raised until run() returns.
+static void keeperror(pymachine_6502* self){
+    if(self->errtype == nullptr){
+        PyErr_Fetch(&self->errtype, &self->errvalue, &self->errtrace);
+    } else {
+        PyErr_Clear();
+    }
+}
+
+// Raises RuntimeError if the machine is in run(), whose callbacks must not
+// change what it is running.
+static bool idle(pymachine_6502* self){
+    if(self->running){
+        PyErr_SetString(PyExc_RuntimeError, "machine is running");
+        return false;
+    }
+    return true;
+}
+
+// As idle(), but lets the callbacks of run() through: they run on its
+// thread between instructions, where a device drives the lines.
+static bool lineowner(pymachine_6502* self){
+    if(self->running && self->runner != PyThread_get_thread_ident()){
+        PyErr_SetString(PyExc_RuntimeError, "machine is running on another thread");
+        return false;
+    }
+    return true;
+}
+
+static uint8_t ioread(void* ctx, uint16_t addr){
+    pyhook_6502* hook = static_cast<pyhook_6502*>(ctx);
+    PyGILState_STATE gil = PyGILState_Ensure();
+    uint8_t val = 0xFF;
+    PyObject* ret = hook->read != nullptr ? PyObject_CallFunction(hook->read, "H", addr)
+                                          : nullptr;
+    if(ret != nullptr){
+        val = (uint8_t)PyLong_AsUnsignedLongMask(ret);
+        Py_DECREF(ret);
+    }
+    if(PyErr_Occurred()){
+        keeperror(hook->self);
+    }
+    PyGILState_Release(gil);
+    return val;
+}
+
+static void iowrite(void* ctx, uint16_t addr, uint8_t val){
+    pyhook_6502* hook = static_cast<pyhook_6502*>(ctx);
+    PyGILState_STATE gil = PyGILState_Ensure();
+    PyObject* ret = hook->write != nullptr
+                  ? PyObject_CallFunction(hook->write, "HB", addr, val) : nullptr;
+    Py_XDECREF(ret);
+    if(PyErr_Occurred()){
+        keeperror(hook->self);
+    }
+    PyGILState_Release(gil);
+}
+
+static int hostcall(void* ctx, lib6502_regs* regs, lib6502_machine* m){
+    static const char* const NAMES[] = {"a", "x", "y", "sp", "p"};
+    pyhook_6502* hook = static_cast<pyhook_6502*>(ctx);
+    PyGILState_STATE gil = PyGILState_Ensure();
+    uint8_t* fields[] = {&regs->a, &regs->x, &regs->y, &regs->sp, &regs->p};
+    int handled = 0;
+    PyObject* dict = Py_BuildValue("{sBsBsBsBsB}", NAMES[0], *fields[0], NAMES[1], *fields[1],
+                                   NAMES[2], *fields[2], NAMES[3], *fields[3],
+                                   NAMES[4], *fields[4]);
+    PyObject* ret = dict != nullptr && hook->read != nullptr
+                  ? PyObject_CallOneArg(hook->read, dict) : nullptr;
+    if(ret != nullptr){
+        handled = PyObject_IsTrue(ret) > 0;
+        Py_DECREF(ret);
+        for(size_t i = 0; handled && i < sizeof(fields) / sizeof(fields[0]); i++){
+            PyObject* val = PyDict_GetItemString(dict, NAMES[i]);
+            if(val != nullptr){
+                *fields[i] = (uint8_t)PyLong_AsUnsignedLongMask(val);
+            }
+        }
+    }
+    Py_XDECREF(dict);
+    if(PyErr_Occurred()){
+        keeperror(hook->self);
+    }
+    PyGILState_Release(gil);
+    (void)m;
+    return handled;
+}
+
+
+// Machine ---------------------------------------------------------------------
+static PyObject* machine_new(PyTypeObject* type, PyObject* args, PyObject* kwds){
+    if(!PyArg_ParseTuple(args, ":Machine") || (kwds != nullptr && PyDict_Size(kwds) > 0)){
+        PyErr_SetString(PyExc_TypeError, "Machine() takes no arguments");
+        return nullptr;
+    }
+    pymachine_6502* self = (pymachine_6502*)type->tp_alloc(type, 0);
+    if(self == nullptr){
+        return nullptr;
+    }
+    self->m = lib6502_create();
+    self->devices = new(std::nothrow) std::unordered_map<int, std::unique_ptr<pyhook_6502>>;
+    self->traps = new(std::nothrow) std::unordered_map<uint16_t, std::unique_ptr<pyhook_6502>>;
+    if(self->m == nullptr || self->devices == nullptr || self->traps == nullptr){
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+static int machine_traverse(pymachine_6502* self, visitproc visit, void* arg){
+    Py_VISIT(Py_TYPE(self));
+    Py_VISIT(self->errtype);
+    Py_VISIT(self->errvalue);
+    Py_VISIT(self->errtrace);
+    if(self->devices != nullptr){
+        for(const auto& d : *self->devices){
+            Py_VISIT(d.second->read);
+            Py_VISIT(d.second->write);
+        }
+    }
+    if(self->traps != nullptr){
+        for(const auto& t : *self->traps){
+            Py_VISIT(t.second->read);
+        }
+    }
+    return 0;
+}
+
+static int machine_clear(pymachine_6502* self){
+    // drops the references only; a memoryview in the same cycle may still
+    // point at the memory, which goes in machine_dealloc()
+    if(self->devices != nullptr){
+        for(const auto& d : *self->devices){
+            Py_CLEAR(d.second->read);
+            Py_CLEAR(d.second->write);
+        }
+    }
+    if(self->traps != nullptr){
+        for(const auto& t : *self->traps){
+            Py_CLEAR(t.second->read);
+        }
+    }
+    Py_CLEAR(self->errtype);
+    Py_CLEAR(self->errvalue);
+    Py_CLEAR(self->errtrace);
+    return 0;
+}
+
+static void machine_dealloc(pymachine_6502* self){
+    PyObject_GC_UnTrack(self);
+    machine_clear(self);
+    // the emulator keeps pointers to the hooks, so it goes first
+    lib6502_destroy(self->m);
+    delete self->devices;
+    delete self->traps;
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static int machine_getbuffer(pymachine_6502* self, Py_buffer* view, int flags){
+    return PyBuffer_FillInfo(view, (PyObject*)self, lib6502_memory(self->m), MEMORY_SIZE, 0,
+                             flags);
+}
+
+PyDoc_STRVAR(reset_doc, "reset()\n--\n\n"
+        "Resets the CPU and clears memory; devices and host calls stay.");
+
+static PyObject* machine_reset(pymachine_6502* self, PyObject* unused){
+    if(!idle(self)){
+        return nullptr;
+    }
+    lib6502_reset(self->m);
+    (void)unused;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(load_doc, "load(path, addr)\n--\n\n"
+        "Copies a binary image file into memory at addr.");
+
+static PyObject* machine_load(pymachine_6502* self, PyObject* args){
+    const char* path;
+    unsigned short addr;
+    if(!PyArg_ParseTuple(args, "sH:load", &path, &addr) || !idle(self)){
+        return nullptr;
+    }
+    if(!lib6502_load(self->m, path, addr)){
+        PyErr_Format(PyExc_OSError, "cannot load %s at $%04X", path, addr);
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(run_doc, "run(cycles)\n--\n\n"
+        "Runs until the clock has advanced by at least cycles or a watchpoint\n"
+        "or JAM stops it, without holding the GIL. Returns the STOP_* reason.");
+
+static PyObject* machine_run(pymachine_6502* self, PyObject* args){
+    unsigned long long cycles;
+    if(!PyArg_ParseTuple(args, "K:run", &cycles) || !idle(self)){
+        return nullptr;
+    }
+    self->running = true;
+    self->runner = PyThread_get_thread_ident();
+    int stop;
+    Py_BEGIN_ALLOW_THREADS
+    stop = lib6502_run(self->m, cycles);
+    Py_END_ALLOW_THREADS
+    self->running = false;
+    if(self->errtype != nullptr){
+        PyErr_Restore(self->errtype, self->errvalue, self->errtrace);
+        self->errtype = self->errvalue = self->errtrace = nullptr;
+        return nullptr;
+    }
+    return PyLong_FromLong(stop);
+}
+
+PyDoc_STRVAR(set_irq_doc, "set_irq(lines, on)\n--\n\n"
+        "Raises or releases the IRQ lines given as bits. While the machine\n"
+        "runs, only its callbacks may call this.");
+
+static PyObject* machine_set_irq(pymachine_6502* self, PyObject* args){
+    unsigned int lines;
+    int on;
+    if(!PyArg_ParseTuple(args, "Ip:set_irq", &lines, &on) || !lineowner(self)){
+        return nullptr;
+    }
+    lib6502_setirq(self->m, lines, on);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(set_nmi_doc, "set_nmi(on)\n--\n\n"
+        "Drives the NMI line, taken on its rising edge. While the machine\n"
+        "runs, only its callbacks may call this.");
+
+static PyObject* machine_set_nmi(pymachine_6502* self, PyObject* args){
+    int on;
+    if(!PyArg_ParseTuple(args, "p:set_nmi", &on) || !lineowner(self)){
+        return nullptr;
+    }
+    lib6502_setnmi(self->m, on);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(set_jam_doc, "set_jam(policy)\n--\n\n"
+        "Sets what JAM opcodes do: JAM_EMULATE locks the CPU up as the chip\n"
+        "does, JAM_TRAP stops run() on the opcode each time and JAM_HALT\n"
+        "locks up and stops.");
+
+static PyObject* machine_set_jam(pymachine_6502* self, PyObject* args){
+    int policy;
+    if(!PyArg_ParseTuple(args, "i:set_jam", &policy) || !idle(self)){
+        return nullptr;
+    }
+    if(policy != LIB6502_JAM_EMULATE && policy != LIB6502_JAM_TRAP
+            && policy != LIB6502_JAM_HALT){
+        PyErr_Format(PyExc_ValueError, "unknown JAM policy %d", policy);
+        return nullptr;
+    }
+    lib6502_setjam(self->m, policy);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(add_watch_doc, "add_watch(lo, hi, kind)\n--\n\n"
+        "Stops run() on accesses of kind, WATCH_* bits, to [lo, hi].\n"
+        "Returns the watchpoint id.");
+
+static PyObject* machine_add_watch(pymachine_6502* self, PyObject* args){
+    unsigned short lo, hi;
+    int kind;
+    if(!PyArg_ParseTuple(args, "HHi:add_watch", &lo, &hi, &kind) || !idle(self)){
+        return nullptr;
+    }
+    int id = lib6502_addwatch(self->m, lo, hi, kind);
+    return id < 0 ? PyErr_NoMemory() : PyLong_FromLong(id);
+}
+
+PyDoc_STRVAR(del_watch_doc, "del_watch(id)\n--\n\n"
+        "Removes a watchpoint. Returns False if there was none.");
+
+static PyObject* machine_del_watch(pymachine_6502* self, PyObject* args){
+    int id;
+    if(!PyArg_ParseTuple(args, "i:del_watch", &id) || !idle(self)){
+        return nullptr;
+    }
+    return PyBool_FromLong(lib6502_delwatch(self->m, id));
+}
+
+PyDoc_STRVAR(map_io_doc, "map_io(lo, hi, read, write)\n--\n\n"
+        "Maps a device over [lo, hi]: read(addr) returns the byte read and\n"
+        "write(addr, value) takes each byte written. Returns the mapping id.");
+
+static PyObject* machine_map_io(pymachine_6502* self, PyObject* args){
+    unsigned short lo, hi;
+    PyObject* read;
+    PyObject* write;
+    if(!PyArg_ParseTuple(args, "HHOO:map_io", &lo, &hi, &read, &write)
+            || !idle(self)){
+        return nullptr;
+    }
+    if(!PyCallable_Check(read) || !PyCallable_Check(write)){
+        PyErr_SetString(PyExc_TypeError, "read and write must be callable");
+        return nullptr;
+    }
+    std::unique_ptr<pyhook_6502> hook(new(std::nothrow) pyhook_6502{self, read, write});
+    if(hook == nullptr){
+        return PyErr_NoMemory();
+    }
+    int id = lib6502_mapio(self->m, lo, hi, ioread, iowrite, hook.get());
+    if(id < 0){
+        return PyErr_NoMemory();
+    }
+    Py_INCREF(read);
+    Py_INCREF(write);
+    (*self->devices)[id] = std::move(hook);
+    return PyLong_FromLong(id);
+}
+
+PyDoc_STRVAR(unmap_io_doc, "unmap_io(id)\n--\n\n"
+        "Removes a device mapping. Returns False if there was none.");
+
+static PyObject* machine_unmap_io(pymachine_6502* self, PyObject* args){
+    int id;
+    if(!PyArg_ParseTuple(args, "i:unmap_io", &id) || !idle(self)){
+        return nullptr;
+    }
+    auto it = self->devices->find(id);
+    if(it == self->devices->end() || !lib6502_unmapio(self->m, id)){
+        Py_RETURN_FALSE;
+    }
+    Py_XDECREF(it->second->read);
+    Py_XDECREF(it->second->write);
+    self->devices->erase(it);
+    Py_RETURN_TRUE;
+}
+
+PyDoc_STRVAR(add_trap_doc, "add_trap(addr, fn, cycles)\n--\n\n"
+        "Runs fn(regs) instead of the subroutine at addr. regs is a dict of\n"
+        "a, x, y, sp and p to update in place; a true return value returns\n"
+        "as RTS would, charging cycles, a false one runs the 6502 code.");
+
+static PyObject* machine_add_trap(pymachine_6502* self, PyObject* args){
+    unsigned short addr;
+    PyObject* fn;
+    unsigned int cycles;
+    if(!PyArg_ParseTuple(args, "HOI:add_trap", &addr, &fn, &cycles)
+            || !idle(self)){
+        return nullptr;
+    }
+    if(!PyCallable_Check(fn)){
+        PyErr_SetString(PyExc_TypeError, "fn must be callable");
+        return nullptr;
+    }
+    std::unique_ptr<pyhook_6502> hook(new(std::nothrow) pyhook_6502{self, fn, nullptr});
+    if(hook == nullptr || !lib6502_addtrap(self->m, addr, hostcall, hook.get(), cycles)){
+        return PyErr_NoMemory();
+    }
+    Py_INCREF(fn);
+    auto it = self->traps->find(addr);
+    if(it != self->traps->end()){
+        Py_XDECREF(it->second->read);
+        it->second = std::move(hook);
+    } else {
+        (*self->traps)[addr] = std::move(hook);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(del_trap_doc, "del_trap(addr)\n--\n\n"
+        "Removes the host call at addr. Returns False if there was none.");
+
+static PyObject* machine_del_trap(pymachine_6502* self, PyObject* args){
+    unsigned short addr;
+    if(!PyArg_ParseTuple(args, "H:del_trap", &addr) || !idle(self)){
+        return nullptr;
+    }
+    auto it = self->traps->find(addr);
+    if(it == self->traps->end() || !lib6502_deltrap(self->m, addr)){
+        Py_RETURN_FALSE;
+    }
+    Py_XDECREF(it->second->read);
+    self->traps->erase(it);
+    Py_RETURN_TRUE;
+}
+
+// register getters and setters, the closure naming the register
+static PyObject* machine_getreg(pymachine_6502* self, void* closure){
+    if(!idle(self)){
+        return nullptr;
+    }
+    lib6502_regs regs;
+    lib6502_getregs(self->m, &regs);
+    switch((char)(intptr_t)closure){
+        case 'c': return PyLong_FromLong(regs.pc);
+        case 's': return PyLong_FromLong(regs.sp);
+        case 'a': return PyLong_FromLong(regs.a);
+        case 'x': return PyLong_FromLong(regs.x);
+        case 'y': return PyLong_FromLong(regs.y);
+        default:  return PyLong_FromLong(regs.p);
+    }
+}
+
+static int machine_setreg(pymachine_6502* self, PyObject* value, void* closure){
+    if(!idle(self)){
+        return -1;
+    }
+    if(value == nullptr){
+        PyErr_SetString(PyExc_AttributeError, "registers cannot be deleted");
+        return -1;
+    }
+    char reg = (char)(intptr_t)closure;
+    long val = PyLong_AsLong(value);
+    if(val == -1 && PyErr_Occurred()){
+        return -1;
+    }
+    if(val < 0 || val > (reg == 'c' ? 0xFFFF : 0xFF)){
+        PyErr_SetString(PyExc_OverflowError, "register value out of range");
+        return -1;
+    }
+    lib6502_regs regs;
+    lib6502_getregs(self->m, &regs);
+    switch(reg){
+        case 'c': regs.pc = (uint16_t)val; break;
+        case 's': regs.sp = (uint8_t)val; break;
+        case 'a': regs.a = (uint8_t)val; break;
+        case 'x': regs.x = (uint8_t)val; break;
+        case 'y': regs.y = (uint8_t)val; break;
+        default:  regs.p = (uint8_t)val; break;
+    }
+    lib6502_setregs(self->m, &regs);
+    return 0;
+}
+
+static PyObject* machine_getclock(pymachine_6502* self, void* unused){
+    (void)unused;
+    return PyLong_FromUnsignedLongLong(lib6502_clock(self->m));
+}
+
+static PyObject* machine_getretired(pymachine_6502* self, void* unused){
+    (void)unused;
+    return PyLong_FromUnsignedLongLong(lib6502_retired(self->m));
+}
+
+static PyObject* machine_getmemory(pymachine_6502* self, void* unused){
+    (void)unused;
+    return PyMemoryView_FromObject((PyObject*)self);
+}
+
+
+// Module ----------------------------------------------------------------------
+static PyMethodDef MACHINE_METHODS[] = {
+    {"reset", (PyCFunction)machine_reset, METH_NOARGS, reset_doc},
+    {"load", (PyCFunction)machine_load, METH_VARARGS, load_doc},
+    {"run", (PyCFunction)machine_run, METH_VARARGS, run_doc},
+    {"set_irq", (PyCFunction)machine_set_irq, METH_VARARGS, set_irq_doc},
+    {"set_nmi", (PyCFunction)machine_set_nmi, METH_VARARGS, set_nmi_doc},
+    {"set_jam", (PyCFunction)machine_set_jam, METH_VARARGS, set_jam_doc},
+    {"add_watch", (PyCFunction)machine_add_watch, METH_VARARGS, add_watch_doc},
+    {"del_watch", (PyCFunction)machine_del_watch, METH_VARARGS, del_watch_doc},
+    {"map_io", (PyCFunction)machine_map_io, METH_VARARGS, map_io_doc},
+    {"unmap_io", (PyCFunction)machine_unmap_io, METH_VARARGS, unmap_io_doc},
+    {"add_trap", (PyCFunction)machine_add_trap, METH_VARARGS, add_trap_doc},
+    {"del_trap", (PyCFunction)machine_del_trap, METH_VARARGS, del_trap_doc},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static PyGetSetDef MACHINE_GETSET[] = {
+    {"pc", (getter)machine_getreg, (setter)machine_setreg, "Program counter", (void*)'c'},
+    {"sp", (getter)machine_getreg, (setter)machine_setreg, "Stack pointer", (void*)'s'},
+    {"a", (getter)machine_getreg, (setter)machine_setreg, "Accumulator", (void*)'a'},
+    {"x", (getter)machine_getreg, (setter)machine_setreg, "X register", (void*)'x'},
+    {"y", (getter)machine_getreg, (setter)machine_setreg, "Y register", (void*)'y'},
+    {"p", (getter)machine_getreg, (setter)machine_setreg, "Status, packed NV1BDIZC", (void*)'p'},
+    {"clock", (getter)machine_getclock, nullptr, "Cycles run", nullptr},
+    {"retired", (getter)machine_getretired, nullptr, "Instructions run", nullptr},
+    {"memory", (getter)machine_getmemory, nullptr, "Writable memoryview of the 64 KiB memory",
+     nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+static PyType_Slot MACHINE_SLOTS[] = {
+    {Py_tp_new, (void*)machine_new},
+    {Py_tp_dealloc, (void*)machine_dealloc},
+    {Py_tp_traverse, (void*)machine_traverse},
+    {Py_tp_clear, (void*)machine_clear},
+    {Py_tp_methods, MACHINE_METHODS},
+    {Py_tp_getset, MACHINE_GETSET},
+    {Py_bf_getbuffer, (void*)machine_getbuffer},
+    {Py_tp_doc, (void*)"Machine()\n--\n\nA 6502 with 64 KiB of memory, PC at $FFFC."},
+    {0, nullptr},
+};
+
+static PyType_Spec MACHINE_SPEC = {
+    "py6502.Machine", sizeof(pymachine_6502), 0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, MACHINE_SLOTS,
+};
+
+static struct PyModuleDef MODULE = {
+    PyModuleDef_HEAD_INIT, "py6502", "6502 emulator bindings over lib6502.", -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr,
+};
+
+PyMODINIT_FUNC PyInit_py6502(void){
+    PyObject* module = PyModule_Create(&MODULE);
+    if(module == nullptr){
+        return nullptr;
+    }
+    PyObject* type = PyType_FromSpec(&MACHINE_SPEC);
+    if(type == nullptr || PyModule_AddObject(module, "Machine", type) < 0){
+        Py_XDECREF(type);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    static const struct { const char* name; int value; } CONSTANTS[] = {
+        {"STOP_NONE", LIB6502_STOP_NONE}, {"STOP_WATCH", LIB6502_STOP_WATCH},
+        {"STOP_JAM", LIB6502_STOP_JAM}, {"WATCH_READ", LIB6502_WATCH_READ},
+        {"WATCH_WRITE", LIB6502_WATCH_WRITE}, {"WATCH_EXEC", LIB6502_WATCH_EXEC},
+        {"JAM_EMULATE", LIB6502_JAM_EMULATE}, {"JAM_TRAP", LIB6502_JAM_TRAP},
+        {"JAM_HALT", LIB6502_JAM_HALT},
+    };
+    for(const auto& c : CONSTANTS){
+        if(PyModule_AddIntConstant(module, c.name, c.value) < 0){
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }
+    return module;
+}
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       ring_6502.h
+ * @desc:       Lock-free single producer, single consumer byte ring
+ * @note:       Used to hand bytes between the CPU thread and host I/O
+ *              threads without either side ever blocking on the other.
+ *****************************************************************************/
+
+#ifndef INC_6502_RING_6502_H
+#define INC_6502_RING_6502_H
+
+#include "6502.h"
+#include <atomic>
+
+/*
+ *  class ring_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Ring of SIZE - 1 bytes. push() may only be called from one
+ *              thread and pop() from one other thread.
+ */
+template<uint32_t SIZE>
+class ring_6502 {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+private:
+    // each index is written by one side only; keep them on separate cache
+    // lines so the two threads do not contend for one
+    alignas(64) std::atomic<uint32_t> head;     // next slot to write
+    alignas(64) std::atomic<uint32_t> tail;     // next slot to read
+    alignas(64) byte buf[SIZE];
+
+public:
+    ring_6502() : head(0), tail(0){}
+
+    ring_6502(const ring_6502&) = delete;
+    ring_6502& operator=(const ring_6502&) = delete;
+
+    // Producer: appends val, false if the ring is full.
+    bool push(byte val){
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t next = (h + 1) & (SIZE - 1);
+        if(next == tail.load(std::memory_order_acquire)){
+            return false;
+        }
+        buf[h] = val;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: removes the oldest byte into val, false if the ring is empty.
+    bool pop(byte& val){
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if(t == head.load(std::memory_order_acquire)){
+            return false;
+        }
+        val = buf[t];
+        tail.store((t + 1) & (SIZE - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Either side: true if nothing is queued.
+    bool empty() const{
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    // Either side: true if push() would fail.
+    bool full() const{
+        return ((head.load(std::memory_order_acquire) + 1) & (SIZE - 1))
+                == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif //INC_6502_RING_6502_H
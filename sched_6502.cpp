@@ -0,0 +1,125 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       sched_6502.cpp
+ * @desc:       Source file for the cycle timestamped device event scheduler
+ *****************************************************************************/
+
+#include "sched_6502.h"
+#include <algorithm>
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates an empty scheduler.
+sched_6502::sched_6502(){
+    due = NEVER;
+    seq = 0;
+    nextid = 1;
+    wrapped = false;
+}
+
+bool sched_6502::later(const entry_6502& a, const entry_6502& b){
+    return a.when != b.when ? a.when > b.when : a.seq > b.seq;
+}
+
+// Returns an unused id, never 0, which devices keep for no event.
+uint32_t sched_6502::takeid(){
+    for(;;){
+        uint32_t id = nextid;
+        if(nextid == LASTID){
+            nextid = 1;
+            wrapped = true;
+        } else {
+            nextid++;
+        }
+        // once the ids have wrapped a long pending event may hold one
+        if(!wrapped || std::none_of(heap.begin(), heap.end(),
+                                    [id](const entry_6502& e){ return e.id == id; })){
+            return id;
+        }
+    }
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  schedule()
+ *
+ *  @desc:      Schedules fn to be called at cycle when
+ *  @param:     when - Absolute cpu cycle
+ *              fn - Callback
+ *              ctx - Passed through to fn
+ *  @return:    Event id for cancel()
+ * */
+uint32_t sched_6502::schedule(uint64_t when, event_6502 fn, void* ctx){
+    uint32_t id = takeid();
+    heap.push_back({when, seq++, id, fn, ctx});
+    std::push_heap(heap.begin(), heap.end(), later);
+    due = heap.front().when;
+    return id;
+}
+
+/*
+ *  cancel()
+ *
+ *  @desc:      Removes a pending event
+ *  @param:     id - Event id returned by schedule()
+ *  @return:    true if the event was still pending
+ * */
+bool sched_6502::cancel(uint32_t id){
+    for(size_t i = 0; i < heap.size(); i++){
+        if(heap[i].id == id){
+            // devices only keep a handful of events pending, so rebuilding
+            // the heap is cheaper than maintaining positions
+            heap[i] = heap.back();
+            heap.pop_back();
+            std::make_heap(heap.begin(), heap.end(), later);
+            due = heap.empty() ? NEVER : heap.front().when;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  clear()
+ *
+ *  @desc:      Removes all pending events
+ *  @param:     None
+ *  @return:    None
+ * */
+void sched_6502::clear(){
+    heap.clear();
+    due = NEVER;
+}
+
+/*
+ *  run()
+ *
+ *  @desc:      Fires every event due at or before now, earliest first
+ *  @param:     now - Current cpu cycle
+ *  @return:    None
+ * */
+void sched_6502::run(uint64_t now){
+    while(!heap.empty() && heap.front().when <= now){
+        std::pop_heap(heap.begin(), heap.end(), later);
+        entry_6502 ev = heap.back();
+        heap.pop_back();
+        due = heap.empty() ? NEVER : heap.front().when;
+        ev.fn(ev.ctx, ev.when, now);
+    }
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  pending()
+ *
+ *  @desc:      Returns the number of pending events
+ * */
+size_t sched_6502::pending() const{
+    return heap.size();
+}
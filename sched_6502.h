@@ -0,0 +1,137 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       sched_6502.h
+ * @desc:       Header file for the cycle timestamped device event scheduler
+ * @note:       Devices schedule a callback at the clock cycle something
+ *              happens to them instead of being ticked every cycle. The cpu
+ *              compares its clock with the earliest deadline once per
+ *              instruction and only calls in here when it has been reached.
+ *****************************************************************************/
+
+#ifndef INC_6502_SCHED_6502_H
+#define INC_6502_SCHED_6502_H
+
+#include "6502.h"
+#include <vector>
+
+/*
+ *  event_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called when an event comes due
+ *  @param:     ctx - Pointer given to schedule()
+ *              when - Cycle the event was scheduled for
+ *              now - Cycle of the instruction boundary it fired on, at or
+ *                    after when
+ */
+typedef void (*event_6502)(void* ctx, uint64_t when, uint64_t now);
+
+class sched_6502 {
+public:
+    static constexpr uint64_t NEVER = UINT64_MAX;
+    // ids run from 1 to here and wrap, staying positive as C ints
+    static constexpr uint32_t LASTID = INT32_MAX;
+
+private:
+    /*
+     *  struct entry_6502
+     *  @date:      19 Oct, 2026
+     *  @desc:      A pending event. seq keeps events due on the same cycle
+     *              in the order they were scheduled.
+     */
+    struct entry_6502 {
+        uint64_t when;
+        uint64_t seq;
+        uint32_t id;
+        event_6502 fn;
+        void* ctx;
+    };
+
+    // Scheduler Fields
+    std::vector<entry_6502> heap;   // min-heap on (when, seq)
+    uint64_t due;                   // deadline of heap.front(), NEVER if empty
+    uint64_t seq;
+    uint32_t nextid;
+    bool wrapped;                   // ids may belong to pending events
+
+    // Orders the heap so the earliest event is at the front.
+    static bool later(const entry_6502& a, const entry_6502& b);
+
+    // Returns an unused id, never 0, which devices keep for no event.
+    uint32_t takeid();
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates an empty scheduler.
+    sched_6502();
+
+    sched_6502(const sched_6502&) = delete;
+    sched_6502& operator=(const sched_6502&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  schedule()
+     *
+     *  @desc:      Schedules fn to be called at cycle when
+     *  @param:     when - Absolute cpu cycle, see cpu_6502::getclock()
+     *              fn - Callback
+     *              ctx - Passed through to fn
+     *  @return:    Event id for cancel()
+     *  @note:      Events fire at the first instruction boundary at or after
+     *              their deadline. Periodic devices reschedule themselves from
+     *              the callback relative to when, so they do not drift.
+     * */
+    uint32_t schedule(uint64_t when, event_6502 fn, void* ctx);
+
+    /*
+     *  cancel()
+     *
+     *  @desc:      Removes a pending event
+     *  @param:     id - Event id returned by schedule()
+     *  @return:    true if the event was still pending
+     * */
+    bool cancel(uint32_t id);
+
+    /*
+     *  clear()
+     *
+     *  @desc:      Removes all pending events
+     *  @param:     None
+     *  @return:    None
+     * */
+    void clear();
+
+    /*
+     *  run()
+     *
+     *  @desc:      Fires every event due at or before now, earliest first,
+     *              including ones the callbacks schedule
+     *  @param:     now - Current cpu cycle
+     *  @return:    None
+     * */
+    void run(uint64_t now);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  deadline()
+     *
+     *  @desc:      Returns the cycle of the earliest event, NEVER if none.
+     *              The cpu keeps a pointer to it, so it has to stay valid
+     *              while the scheduler is attached.
+     * */
+    const uint64_t& deadline() const{ return due; }
+
+    /*
+     *  pending()
+     *
+     *  @desc:      Returns the number of pending events
+     * */
+    size_t pending() const;
+};
+
+#endif //INC_6502_SCHED_6502_H
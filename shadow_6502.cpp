@@ -0,0 +1,248 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       shadow_6502.cpp
+ * @desc:       Source file for the shadow call stack
+ *****************************************************************************/
+
+#include "shadow_6502.h"
+#include <algorithm>
+
+// subroutines and frames listed by report()
+static constexpr size_t REPORT_TOP = 20;
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates an empty shadow stack.
+shadow_6502::shadow_6502(){
+    maxdepth = 0;
+    overflows = underflows = unmatched = abandoned = 0;
+    onfault = nullptr;
+    faultctx = nullptr;
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  call()
+ *
+ *  @desc:      Pushes a frame
+ *  @param:     caller - JSR address, or the PC an interrupt came at
+ *              target - Subroutine or handler
+ *              sp - SP before the push
+ *              now - Current clock
+ *              root - ROOT_IRQ or ROOT_NMI for an interrupt, 0 for JSR
+ *  @return:    None
+ * */
+void shadow_6502::call(word caller, word target, byte sp, uint64_t now, word root){
+    // the stack grows down, so frames at or below sp were left without
+    // returning and their slots are about to be reused
+    while(!frames.empty() && frames.back().sp <= sp){
+        frames.pop_back();
+        abandoned++;
+    }
+    word parent = root != 0 ? root : frames.empty() ? ROOT_RESET : frames.back().target;
+    frames.push_back({caller, target, parent, sp, root != 0, now});
+    uint32_t depth = (uint32_t)frames.size();
+    maxdepth = std::max(maxdepth, depth);
+
+    callstats_6502& st = edges[(uint32_t)parent << 16 | target];
+    st.calls++;
+    st.maxdepth = std::max(st.maxdepth, depth);
+}
+
+/*
+ *  ret()
+ *
+ *  @desc:      Pops the frame an RTS or RTI returned from
+ *  @param:     sp - SP after the pull
+ *              now - Current clock
+ *  @return:    None
+ * */
+void shadow_6502::ret(byte sp, uint64_t now){
+    unwind(sp);
+    if(frames.empty() || frames.back().sp != sp){
+        // an address pushed by hand, used as a jump
+        unmatched++;
+        return;
+    }
+    const frame_6502& f = frames.back();
+    callstats_6502& st = edges[(uint32_t)f.parent << 16 | f.target];
+    st.returns++;
+    st.cycles += now - f.entry;
+    frames.pop_back();
+}
+
+/*
+ *  fault()
+ *
+ *  @desc:      Records a stack wrap and calls the fault function
+ *  @param:     kind - FAULT_* kind
+ *              pc - Instruction that pushed or pulled
+ *              sp - SP before the access
+ *  @return:    None
+ * */
+void shadow_6502::fault(byte kind, word pc, byte sp){
+    if(kind == FAULT_OVERFLOW){
+        overflows++;
+    } else {
+        underflows++;
+    }
+    if(onfault != nullptr){
+        onfault(faultctx, kind, pc, sp);
+    }
+}
+
+/*
+ *  setfault()
+ *
+ *  @desc:      Installs a function called on every stack fault
+ *  @param:     hook - Function to call, nullptr to remove
+ *              ctx - Passed through to hook
+ *  @return:    None
+ * */
+void shadow_6502::setfault(stackfault_6502 hook, void* ctx){
+    onfault = hook;
+    faultctx = ctx;
+}
+
+/*
+ *  clear()
+ *
+ *  @desc:      Drops the frames, as on reset; statistics are kept
+ * */
+void shadow_6502::clear(){
+    frames.clear();
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  getstats()
+ *
+ *  @desc:      Returns the totals of one call graph edge
+ *  @param:     parent, target - Edge
+ *  @return:    Totals, all zero if never taken
+ * */
+callstats_6502 shadow_6502::getstats(word parent, word target) const{
+    auto it = edges.find((uint32_t)parent << 16 | target);
+    return it != edges.end() ? it->second : callstats_6502{0, 0, 0, 0};
+}
+
+/*
+ *  getstats()
+ *
+ *  @desc:      Returns the totals of a subroutine over every edge to it
+ *  @param:     target - Subroutine
+ *  @return:    Totals, all zero if never called
+ * */
+callstats_6502 shadow_6502::getstats(word target) const{
+    callstats_6502 st{0, 0, 0, 0};
+    for(const auto& e : edges){
+        if((word)(e.first & 0xFFFF) == target){
+            add(st, e.second);
+        }
+    }
+    return st;
+}
+
+/*
+ *  report()
+ *
+ *  @desc:      Prints the subroutines by inclusive cycles, the faults and
+ *              the current frames
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void shadow_6502::report(FILE* file) const{
+    std::vector<std::pair<word, callstats_6502>> sorted = subroutines();
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b){
+        return a.second.cycles != b.second.cycles ? a.second.cycles > b.second.cycles
+                                                  : a.first < b.first;
+    });
+
+    fprintf(file, "calls: depth %u, max %u, %llu overflows, %llu underflows, "
+                  "%llu unmatched returns, %llu abandoned frames\n",
+            getdepth(), maxdepth, (unsigned long long)overflows,
+            (unsigned long long)underflows, (unsigned long long)unmatched,
+            (unsigned long long)abandoned);
+    fprintf(file, "%-6s %12s %16s %12s %6s\n", "sub", "calls", "cycles", "cycles/call", "depth");
+    for(size_t i = 0; i < sorted.size() && i < REPORT_TOP; i++){
+        const callstats_6502& st = sorted[i].second;
+        fprintf(file, "$%04X  %12llu %16llu %12.1f %6u\n", sorted[i].first,
+                (unsigned long long)st.calls, (unsigned long long)st.cycles,
+                st.returns > 0 ? (double)st.cycles / (double)st.returns : 0.0, st.maxdepth);
+    }
+    // innermost first, as a debugger shows a backtrace
+    for(size_t i = 0; i < frames.size() && i < REPORT_TOP; i++){
+        const frame_6502& f = frames[frames.size() - 1 - i];
+        fprintf(file, "  #%zu $%04X from $%04X%s\n", i, f.target, f.caller,
+                f.interrupt ? " (interrupt)" : "");
+    }
+    if(frames.size() > REPORT_TOP){
+        fprintf(file, "  ... %zu more frames\n", frames.size() - REPORT_TOP);
+    }
+}
+
+/*
+ *  writedot()
+ *
+ *  @desc:      Prints the call graph in Graphviz DOT, edges labelled
+ *              with their calls and subroutines with their cycles
+ *  @param:     file - Output stream
+ *  @return:    None
+ * */
+void shadow_6502::writedot(FILE* file) const{
+    fprintf(file, "digraph calls {\n");
+    fprintf(file, "    node [shape=box, fontname=\"monospace\"];\n");
+    fprintf(file, "    v%04X [label=\"NMI\", shape=ellipse];\n", ROOT_NMI);
+    fprintf(file, "    v%04X [label=\"RESET\", shape=ellipse];\n", ROOT_RESET);
+    fprintf(file, "    v%04X [label=\"IRQ\", shape=ellipse];\n", ROOT_IRQ);
+    std::vector<std::pair<word, callstats_6502>> subs = subroutines();
+    std::sort(subs.begin(), subs.end(), [](const auto& a, const auto& b){
+        return a.first < b.first;
+    });
+    for(const auto& sub : subs){
+        fprintf(file, "    s%04X [label=\"$%04X\\n%llu cycles\"];\n", sub.first, sub.first,
+                (unsigned long long)sub.second.cycles);
+    }
+    std::vector<std::pair<uint32_t, callstats_6502>> sorted(edges.begin(), edges.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b){
+        return a.first < b.first;
+    });
+    for(const auto& e : sorted){
+        word parent = (word)(e.first >> 16);
+        // the vectors hold addresses, not code, so no subroutine starts there
+        bool root = parent == ROOT_NMI || parent == ROOT_RESET || parent == ROOT_IRQ;
+        fprintf(file, "    %c%04X -> s%04X [label=\"%llu\"];\n", root ? 'v' : 's', parent,
+                (word)(e.first & 0xFFFF), (unsigned long long)e.second.calls);
+    }
+    fprintf(file, "}\n");
+}
+
+
+// Private helpers ---------------------------------------------------------
+void shadow_6502::add(callstats_6502& st, const callstats_6502& edge){
+    st.calls += edge.calls;
+    st.returns += edge.returns;
+    st.cycles += edge.cycles;
+    st.maxdepth = std::max(st.maxdepth, edge.maxdepth);
+}
+
+std::vector<std::pair<word, callstats_6502>> shadow_6502::subroutines() const{
+    std::unordered_map<word, callstats_6502> subs;
+    for(const auto& e : edges){
+        add(subs[(word)(e.first & 0xFFFF)], e.second);
+    }
+    return {subs.begin(), subs.end()};
+}
+
+void shadow_6502::unwind(byte sp){
+    while(!frames.empty() && frames.back().sp < sp){
+        frames.pop_back();
+        abandoned++;
+    }
+}
@@ -0,0 +1,227 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       shadow_6502.h
+ * @desc:       Header file for the shadow call stack
+ * @note:       Built into cpu_6502 only when SHADOW_STACK_6502 is defined.
+ *              JSR, BRK, IRQ and NMI push a frame and RTS and RTI pop it,
+ *              matched by the stack pointer rather than by count, so code
+ *              that drops a return address (PLA PLA, TXS) abandons its
+ *              frames instead of confusing the ones above, and an RTS to
+ *              an address pushed by hand is counted as unmatched. Cycles
+ *              are inclusive: a subroutine is charged everything between
+ *              its call and its return, recursive calls counted again.
+ *              Call graph edges run from the subroutine a call was made
+ *              in to the one called; calls made outside any subroutine
+ *              and interrupts come from the vector they started at.
+ *****************************************************************************/
+
+#ifndef INC_6502_SHADOW_6502_H
+#define INC_6502_SHADOW_6502_H
+
+#include "6502.h"
+#include <unordered_map>
+#include <vector>
+
+/*
+ *  struct frame_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      A call in progress
+ */
+struct frame_6502 {
+    word caller;        // JSR, or the instruction an interrupt came before
+    word target;        // subroutine or handler
+    word parent;        // subroutine or vector the edge comes from
+    byte sp;            // SP before the return address was pushed
+    bool interrupt;     // returns with RTI
+    uint64_t entry;     // clock at the call
+};
+
+/*
+ *  struct callstats_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Totals of one call graph edge, or of a subroutine
+ */
+struct callstats_6502 {
+    uint64_t calls;
+    uint64_t returns;   // calls that returned, the ones cycles covers
+    uint64_t cycles;    // inclusive
+    uint32_t maxdepth;  // deepest frame the edge was taken at
+};
+
+/*
+ *  stackfault_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Called when the hardware stack wraps
+ *  @param:     ctx - Pointer given to setfault()
+ *              kind - shadow_6502::FAULT_* kind
+ *              pc - Instruction that pushed or pulled
+ *              sp - SP before the access
+ */
+typedef void (*stackfault_6502)(void* ctx, byte kind, word pc, byte sp);
+
+class shadow_6502 {
+public:
+    // stack faults
+    static constexpr byte
+            FAULT_OVERFLOW  = 0x01, // push with SP at $00, wraps to $01FF
+            FAULT_UNDERFLOW = 0x02; // pull with SP at $FF, wraps to $0100
+
+    // parents of the edges that start a call chain
+    static constexpr word
+            ROOT_NMI   = 0xFFFA,
+            ROOT_RESET = 0xFFFC,    // calls made outside any subroutine
+            ROOT_IRQ   = 0xFFFE;    // IRQ and BRK
+
+private:
+    // Stack Fields
+    std::vector<frame_6502> frames;
+    uint32_t maxdepth;
+
+    // Statistics Fields
+    std::unordered_map<uint32_t, callstats_6502> edges;    // parent << 16 | target
+    uint64_t overflows;
+    uint64_t underflows;
+    uint64_t unmatched;     // returns with no frame at their SP
+    uint64_t abandoned;     // frames dropped without a return
+
+    // Fault Fields
+    stackfault_6502 onfault;
+    void* faultctx;
+
+    /*
+     *  add()
+     *
+     *  @desc:      Adds the totals of an edge into st
+     * */
+    static void add(callstats_6502& st, const callstats_6502& edge);
+
+    /*
+     *  subroutines()
+     *
+     *  @desc:      Returns the totals of every subroutine called
+     * */
+    std::vector<std::pair<word, callstats_6502>> subroutines() const;
+
+    /*
+     *  unwind()
+     *
+     *  @desc:      Drops the frames below sp, whose return addresses the
+     *              stack no longer holds
+     * */
+    void unwind(byte sp);
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates an empty shadow stack.
+    shadow_6502();
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  call()
+     *
+     *  @desc:      Pushes a frame
+     *  @param:     caller - JSR address, or the PC an interrupt came at
+     *              target - Subroutine or handler
+     *              sp - SP before the push
+     *              now - Current clock
+     *              root - ROOT_IRQ or ROOT_NMI for an interrupt, 0 for
+     *                     JSR
+     *  @return:    None
+     * */
+    void call(word caller, word target, byte sp, uint64_t now, word root);
+
+    /*
+     *  ret()
+     *
+     *  @desc:      Pops the frame an RTS or RTI returned from
+     *  @param:     sp - SP after the pull
+     *              now - Current clock
+     *  @return:    None
+     * */
+    void ret(byte sp, uint64_t now);
+
+    /*
+     *  fault()
+     *
+     *  @desc:      Records a stack wrap and calls the fault function
+     *  @param:     kind - FAULT_* kind
+     *              pc - Instruction that pushed or pulled
+     *              sp - SP before the access
+     *  @return:    None
+     * */
+    void fault(byte kind, word pc, byte sp);
+
+    /*
+     *  setfault()
+     *
+     *  @desc:      Installs a function called on every stack fault
+     *  @param:     hook - Function to call, nullptr to remove
+     *              ctx - Passed through to hook
+     *  @return:    None
+     * */
+    void setfault(stackfault_6502 hook, void* ctx);
+
+    /*
+     *  clear()
+     *
+     *  @desc:      Drops the frames, as on reset; statistics are kept
+     * */
+    void clear();
+
+    // Access functions --------------------------------------------------------
+    const std::vector<frame_6502>& getframes() const{ return frames; }
+    uint32_t getdepth() const{ return (uint32_t)frames.size(); }
+    uint32_t getmaxdepth() const{ return maxdepth; }
+    uint64_t getoverflows() const{ return overflows; }
+    uint64_t getunderflows() const{ return underflows; }
+    uint64_t getunmatched() const{ return unmatched; }
+    uint64_t getabandoned() const{ return abandoned; }
+
+    /*
+     *  getstats()
+     *
+     *  @desc:      Returns the totals of one call graph edge
+     *  @param:     parent, target - Edge
+     *  @return:    Totals, all zero if never taken
+     * */
+    callstats_6502 getstats(word parent, word target) const;
+
+    /*
+     *  getstats()
+     *
+     *  @desc:      Returns the totals of a subroutine over every edge to it
+     *  @param:     target - Subroutine
+     *  @return:    Totals, all zero if never called
+     * */
+    callstats_6502 getstats(word target) const;
+
+    /*
+     *  report()
+     *
+     *  @desc:      Prints the subroutines by inclusive cycles, the faults and
+     *              the current frames
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void report(FILE* file) const;
+
+    /*
+     *  writedot()
+     *
+     *  @desc:      Prints the call graph in Graphviz DOT, edges labelled
+     *              with their calls and subroutines with their cycles
+     *  @param:     file - Output stream
+     *  @return:    None
+     * */
+    void writedot(FILE* file) const;
+};
+
+#endif //INC_6502_SHADOW_6502_H
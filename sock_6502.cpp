@@ -0,0 +1,73 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       sock_6502.cpp
+ * @desc:       Source file for the listening sockets of host side services
+ *****************************************************************************/
+
+#include "sock_6502.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+ *  openserver()
+ *
+ *  @desc:      Opens a listening stream socket
+ *  @param:     spec - "PORT", "tcp:PORT" or "unix:PATH"
+ *              unixpath - Receives the socket file to remove when done
+ *  @return:    Socket, or -1 on failure
+ * */
+int openserver(const char* spec, std::string& unixpath){
+    int fd;
+    if(strncmp(spec, "unix:", 5) == 0){
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if(strlen(spec + 5) >= sizeof(addr.sun_path)){
+            fprintf(stderr, "ERROR: Socket path too long: %s\n", spec + 5);
+            return -1;
+        }
+        strcpy(addr.sun_path, spec + 5);
+        unlink(addr.sun_path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0){
+            fprintf(stderr, "ERROR: Cannot bind %s: ", spec);
+            perror("");
+            if(fd >= 0){
+                close(fd);
+            }
+            return -1;
+        }
+        unixpath = addr.sun_path;
+    } else {
+        const char* port = strncmp(spec, "tcp:", 4) == 0 ? spec + 4 : spec;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons((uint16_t)atoi(port));
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        if(fd >= 0){
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        }
+        if(fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0){
+            fprintf(stderr, "ERROR: Cannot bind %s: ", spec);
+            perror("");
+            if(fd >= 0){
+                close(fd);
+            }
+            return -1;
+        }
+    }
+    if(::listen(fd, 1) < 0){
+        perror("ERROR: listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
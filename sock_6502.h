@@ -0,0 +1,30 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       sock_6502.h
+ * @desc:       Header file for the listening sockets of host side services
+ *****************************************************************************/
+
+#ifndef INC_6502_SOCK_6502_H
+#define INC_6502_SOCK_6502_H
+
+#include "6502.h"
+#include <string>
+
+/*
+ *  openserver()
+ *
+ *  @desc:      Opens a listening stream socket, printing the reason on
+ *              failure
+ *  @param:     spec - "PORT" or "tcp:PORT" for TCP on 127.0.0.1,
+ *                     "unix:PATH" for a Unix domain socket
+ *              unixpath - Receives the socket file to remove when done,
+ *                         left empty for TCP
+ *  @return:    Socket, or -1 on failure
+ * */
+int openserver(const char* spec, std::string& unixpath);
+
+#endif //INC_6502_SOCK_6502_H
@@ -0,0 +1,1399 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       test_6502.cpp
+ * @desc:       Conformance test runner for the 6502 emulator
+ * @ref:        https://github.com/Klaus2m5/6502_65C02_functional_tests
+ *              https://github.com/SingleStepTests/ProcessorTests
+ * @note:       Runs Klaus Dormann's functional test, Bruce Clark's decimal
+ *              test and the per-opcode single step JSON vectors. The vector
+ *              files are spread over all cores, each worker owning its own
+ *              machine. --program writes a built-in image for the tests
+ *              that run whole programs through the emulator, --via checks
+ *              the VIA timers cycle by cycle, --interrupts the IRQ and
+ *              NMI sequences and --idleskip that skipping idle loops
+ *              leaves the same state as running them.
+ *****************************************************************************/
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "sched_6502.h"
+#include "via_6522.h"
+#ifdef AOT_TEST_6502
+#include "aot_6502.h"
+#include "metrics_6502.h"
+#endif
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// status bits compared against the vectors; B and the unused bit only exist
+// on the stack copy of the status register
+static constexpr byte STATUS_MASK = 0xCF;
+
+// gives up on a ROM test after this many cycles
+static constexpr uint64_t ROM_CYCLE_LIMIT = 1ULL << 32;
+
+#ifdef AOT_TEST_6502
+// PROGRAM translated by add_aot_6502() into test_aot_6502
+extern const aotimage_6502 aot_program;
+
+// cycles both machines of the translation test run between comparisons
+static constexpr int32_t AOT_SLICE = 1000;
+#endif
+
+// load and start address of PROGRAM
+static constexpr word PROGRAM_ADDR = 0x0400;
+
+// device tests: where the VIA sits, the instruction the rig steps with and
+// the IRQ handler
+static constexpr word VIA_BASE = 0xD000;
+static constexpr word IDLE_ADDR = 0x0300;
+static constexpr word HANDLER_ADDR = 0x0380;
+
+// interrupt tests: where their code and the NMI handler sit
+static constexpr word CODE_ADDR = 0x0200;
+static constexpr word NMI_ADDR = 0x03A0;
+
+// idle skip test: device acknowledging the IRQ, run length and slice
+static constexpr word ACK_ADDR = 0xD000;
+static constexpr uint64_t IDLE_CYCLES = 200000;
+static constexpr int32_t IDLE_SLICE = 9973;
+
+// Waits for a flag at $10 set by an event or $12 set by the IRQ handler,
+// then counts the wake up at $11 and clears both.
+static const byte IDLE_PROGRAM[] = {
+    0x58,               // 0200  CLI
+    0xA5, 0x10,         // 0201  LDA $10
+    0x05, 0x12,         // 0203  ORA $12
+    0xF0, 0xFA,         // 0205  BEQ $0201
+    0xE6, 0x11,         // 0207  INC $11
+    0xA9, 0x00,         // 0209  LDA #$00
+    0x85, 0x10,         // 020B  STA $10
+    0x85, 0x12,         // 020D  STA $12
+    0x4C, 0x01, 0x02,   // 020F  JMP $0201
+};
+
+// IRQ handler at HANDLER_ADDR: sets $12 and acknowledges the device.
+static const byte IDLE_HANDLER[] = {
+    0xE6, 0x12,         // 0380  INC $12
+    0x8D, 0x00, 0xD0,   // 0382  STA $D000
+    0x40,               // 0385  RTI
+};
+
+// Prime sieve over 0..255 with flags at $0200, then a 4 KiB copy from
+// $1000 to $2000, forever. Written by --program; every superinstruction
+// pair appears in it.
+static const byte PROGRAM[] = {
+    0xA2, 0x00,             // 0400  LDX #0
+    0xA9, 0x00,             // 0402  LDA #0
+    0x9D, 0x00, 0x02,       // 0404  STA $0200,X    clear flags
+    0xE8,                   // 0407  INX
+    0xD0, 0xFA,             // 0408  BNE $0404
+    0xA2, 0x02,             // 040A  LDX #2
+    0xBD, 0x00, 0x02,       // 040C  LDA $0200,X    outer loop
+    0xD0, 0x12,             // 040F  BNE $0423      composite
+    0x86, 0x10,             // 0411  STX $10
+    0x8A,                   // 0413  TXA
+    0x18,                   // 0414  CLC
+    0x65, 0x10,             // 0415  ADC $10        inner loop: j += i
+    0xB0, 0x0A,             // 0417  BCS $0423
+    0xA8,                   // 0419  TAY
+    0xA9, 0x01,             // 041A  LDA #1
+    0x99, 0x00, 0x02,       // 041C  STA $0200,Y    mark composite
+    0x98,                   // 041F  TYA
+    0x18,                   // 0420  CLC
+    0x90, 0xF2,             // 0421  BCC $0415
+    0xE8,                   // 0423  INX
+    0xE0, 0x10,             // 0424  CPX #16
+    0xD0, 0xE4,             // 0426  BNE $040C
+    0xA0, 0x00,             // 0428  LDY #0
+    0xA2, 0x02,             // 042A  LDX #2
+    0xBD, 0x00, 0x02,       // 042C  LDA $0200,X    count primes
+    0xD0, 0x01,             // 042F  BNE $0432
+    0xC8,                   // 0431  INY
+    0xE8,                   // 0432  INX
+    0xD0, 0xF7,             // 0433  BNE $042C
+    0x84, 0x11,             // 0435  STY $11
+    0x38,                   // 0437  SEC
+    0xE5, 0x11,             // 0438  SBC $11        A = 1 - primes
+    0x85, 0x12,             // 043A  STA $12
+    0xA9, 0x00,             // 043C  LDA #$00       copy $1000 to $2000
+    0x85, 0x00,             // 043E  STA $00
+    0x85, 0x02,             // 0440  STA $02
+    0xA9, 0x10,             // 0442  LDA #$10
+    0x85, 0x01,             // 0444  STA $01
+    0xA9, 0x20,             // 0446  LDA #$20
+    0x85, 0x03,             // 0448  STA $03
+    0xA2, 0x10,             // 044A  LDX #16        pages
+    0xA0, 0x00,             // 044C  LDY #0
+    0xB1, 0x00,             // 044E  LDA ($00),Y
+    0x91, 0x02,             // 0450  STA ($02),Y
+    0xC8,                   // 0452  INY
+    0xD0, 0xF9,             // 0453  BNE $044E
+    0xE6, 0x01,             // 0455  INC $01
+    0xE6, 0x03,             // 0457  INC $03
+    0xC6, 0x13,             // 0459  DEC $13
+    0xD0, 0x00,             // 045B  BNE $045D
+    0xCA,                   // 045D  DEX
+    0xD0, 0xEE,             // 045E  BNE $044E
+    0x88,                   // 0460  DEY
+    0xF0, 0x00,             // 0461  BEQ $0463
+    0xC0, 0x00,             // 0463  CPY #0
+    0xF0, 0x00,             // 0465  BEQ $0467
+    0xE6, 0x14,             // 0467  INC $14
+    0xD0, 0x00,             // 0469  BNE $046B
+    0xC8,                   // 046B  INY
+    0xF0, 0x00,             // 046C  BEQ $046E
+    0x4C, 0x00, 0x04,       // 046E  JMP $0400
+};
+
+/*
+ *  struct state_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Machine state of one side of a single step vector
+ */
+struct state_6502 {
+    word pc;
+    byte s, a, x, y, p;
+    std::vector<std::pair<word, byte>> ram;
+};
+
+/*
+ *  struct cycle_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      One bus cycle of a single step vector
+ */
+struct cycle_6502 {
+    word addr;
+    byte val;
+    bool write;
+};
+
+/*
+ *  struct vector_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      One single step test: state before, state after and the
+ *              bus cycles the instruction takes
+ */
+struct vector_6502 {
+    std::string name;
+    state_6502 initial, final;
+    std::vector<cycle_6502> cycles;
+};
+
+/*
+ *  class jsonreader
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Minimal pull parser for the vector files. It only reads the
+ *              shapes the vectors use and skips anything else.
+ */
+class jsonreader {
+private:
+    const char* pos;
+    const char* end;
+    bool failed;
+
+public:
+    jsonreader(const std::string& text) : pos(text.data()), end(text.data() + text.size()), failed(false){}
+
+    bool ok() const{ return !failed; }
+
+    void skipspace(){
+        while(pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')){
+            pos++;
+        }
+    }
+
+    // Consumes c if it is the next character.
+    bool accept(char c){
+        skipspace();
+        if(pos < end && *pos == c){
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c){
+        if(!accept(c)){
+            failed = true;
+            pos = end;
+        }
+    }
+
+    int64_t number(){
+        skipspace();
+        char* stop;
+        int64_t val = strtoll(pos, &stop, 10);
+        if(stop == pos){
+            failed = true;
+            pos = end;
+        } else {
+            pos = stop;
+        }
+        return val;
+    }
+
+    std::string string(){
+        expect('"');
+        const char* start = pos;
+        while(pos < end && *pos != '"'){
+            pos += *pos == '\\' ? 2 : 1;
+        }
+        std::string val(start, pos < end ? pos : end);
+        expect('"');
+        return val;
+    }
+
+    // Skips one value of any type.
+    void skip(){
+        skipspace();
+        if(pos >= end){
+            failed = true;
+        } else if(*pos == '"'){
+            string();
+        } else if(*pos == '[' || *pos == '{'){
+            char close = *pos == '[' ? ']' : '}';
+            pos++;
+            if(accept(close)){
+                return;
+            }
+            do {
+                if(close == '}'){
+                    string();
+                    expect(':');
+                }
+                skip();
+            } while(accept(','));
+            expect(close);
+        } else {
+            while(pos < end && *pos != ',' && *pos != ']' && *pos != '}'){
+                pos++;
+            }
+        }
+    }
+};
+
+/******************************************************************************
+ *  readstate()
+ *
+ *  @desc:      Parses an "initial" or "final" object
+ *****************************************************************************/
+static void readstate(jsonreader& in, state_6502& st){
+    in.expect('{');
+    do {
+        std::string key = in.string();
+        in.expect(':');
+        if(key == "pc"){
+            st.pc = (word)in.number();
+        } else if(key == "s"){
+            st.s = (byte)in.number();
+        } else if(key == "a"){
+            st.a = (byte)in.number();
+        } else if(key == "x"){
+            st.x = (byte)in.number();
+        } else if(key == "y"){
+            st.y = (byte)in.number();
+        } else if(key == "p"){
+            st.p = (byte)in.number();
+        } else if(key == "ram"){
+            in.expect('[');
+            if(!in.accept(']')){
+                do {
+                    in.expect('[');
+                    word addr = (word)in.number();
+                    in.expect(',');
+                    byte val = (byte)in.number();
+                    in.expect(']');
+                    st.ram.emplace_back(addr, val);
+                } while(in.accept(','));
+                in.expect(']');
+            }
+        } else {
+            in.skip();
+        }
+    } while(in.accept(','));
+    in.expect('}');
+}
+
+/******************************************************************************
+ *  readvectors()
+ *
+ *  @desc:      Parses a vector file
+ *  @param:     path - File holding a JSON array of vectors
+ *              out - Receives the vectors
+ *  @return:    false if the file is missing or malformed
+ *****************************************************************************/
+static bool readvectors(const std::string& path, std::vector<vector_6502>& out){
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == nullptr){
+        return false;
+    }
+    std::string text;
+    char buf[1 << 16];
+    size_t len;
+    while((len = fread(buf, 1, sizeof(buf), file)) > 0){
+        text.append(buf, len);
+    }
+    fclose(file);
+
+    jsonreader in(text);
+    in.expect('[');
+    if(in.accept(']')){
+        return in.ok();
+    }
+    do {
+        vector_6502 v{};
+        in.expect('{');
+        do {
+            std::string key = in.string();
+            in.expect(':');
+            if(key == "name"){
+                v.name = in.string();
+            } else if(key == "initial"){
+                readstate(in, v.initial);
+            } else if(key == "final"){
+                readstate(in, v.final);
+            } else if(key == "cycles"){
+                // [[addr, value, "read" | "write"], ...]
+                in.expect('[');
+                if(!in.accept(']')){
+                    do {
+                        cycle_6502 c;
+                        in.expect('[');
+                        c.addr = (word)in.number();
+                        in.expect(',');
+                        c.val = (byte)in.number();
+                        in.expect(',');
+                        c.write = in.string() == "write";
+                        in.expect(']');
+                        v.cycles.push_back(c);
+                    } while(in.accept(','));
+                    in.expect(']');
+                }
+            } else {
+                in.skip();
+            }
+        } while(in.accept(','));
+        in.expect('}');
+        out.push_back(std::move(v));
+    } while(in.ok() && in.accept(','));
+    in.expect(']');
+    return in.ok();
+}
+
+#ifdef CYCLE_EXACT_6502
+/******************************************************************************
+ *  recordbus()
+ *
+ *  @desc:      Bus hook appending every cycle of the instruction under test
+ *****************************************************************************/
+static void recordbus(void* ctx, uint64_t cycle, word addr, byte val, byte kind){
+    (void)cycle;
+    bool write = kind == cpu_6502::BUS_WRITE || kind == cpu_6502::BUS_DUMMY_WRITE;
+    static_cast<std::vector<cycle_6502>*>(ctx)->push_back({addr, val, write});
+}
+#endif
+
+/******************************************************************************
+ *  runvector()
+ *
+ *  @desc:      Runs one vector and compares the outcome
+ *  @param:     cpu, mem - Worker machine; mem must be all zero on entry and
+ *                         is left all zero
+ *              v - Vector
+ *              why - Receives a description of the first mismatch
+ *  @return:    true if registers, memory and cycle count match, and in
+ *              cycle exact builds every bus cycle
+ *****************************************************************************/
+static bool runvector(cpu_6502& cpu, mem_6502& mem, const vector_6502& v, std::string& why){
+    for(const auto& cell : v.initial.ram){
+        mem[cell.first] = cell.second;
+    }
+    // a JAM vector earlier on this worker leaves the CPU locked up
+    cpu.unjam();
+    cpu.setregs({v.initial.pc, v.initial.s, v.initial.a, v.initial.x, v.initial.y, v.initial.p});
+
+#ifdef CYCLE_EXACT_6502
+    std::vector<cycle_6502> bus;
+    cpu.setbushook(recordbus, &bus);
+#endif
+    uint64_t before = cpu.getclock();
+    cpu.execute(1, mem);
+    uint32_t cycles = (uint32_t)(cpu.getclock() - before);
+
+    regs_6502 r = cpu.getregs();
+    char buf[160];
+    why.clear();
+    if(r.PC != v.final.pc || r.SP != v.final.s || r.A != v.final.a || r.X != v.final.x
+            || r.Y != v.final.y || (r.P & STATUS_MASK) != (v.final.p & STATUS_MASK)){
+        snprintf(buf, sizeof(buf),
+                 "regs pc=%04X s=%02X a=%02X x=%02X y=%02X p=%02X, "
+                 "want pc=%04X s=%02X a=%02X x=%02X y=%02X p=%02X",
+                 r.PC, r.SP, r.A, r.X, r.Y, r.P, v.final.pc, v.final.s, v.final.a,
+                 v.final.x, v.final.y, v.final.p);
+        why = buf;
+    }
+    for(const auto& cell : v.final.ram){
+        if(why.empty() && mem[cell.first] != cell.second){
+            snprintf(buf, sizeof(buf), "ram[%04X]=%02X, want %02X",
+                     cell.first, mem[cell.first], cell.second);
+            why = buf;
+        }
+    }
+    if(why.empty() && cycles != v.cycles.size()){
+        snprintf(buf, sizeof(buf), "took %u cycles, want %u", cycles, (uint32_t)v.cycles.size());
+        why = buf;
+    }
+#ifdef CYCLE_EXACT_6502
+    cpu.setbushook(nullptr, nullptr);
+    for(size_t i = 0; why.empty() && i < bus.size() && i < v.cycles.size(); i++){
+        const cycle_6502& got = bus[i];
+        const cycle_6502& want = v.cycles[i];
+        if(got.addr != want.addr || got.val != want.val || got.write != want.write){
+            snprintf(buf, sizeof(buf), "cycle %u %s %04X=%02X, want %s %04X=%02X", (uint32_t)i,
+                     got.write ? "write" : "read", got.addr, got.val,
+                     want.write ? "write" : "read", want.addr, want.val);
+            why = buf;
+        }
+    }
+#endif
+
+    // leave memory clean for the next vector without clearing all 64 KiB
+    for(const auto& cell : v.initial.ram){
+        mem[cell.first] = 0;
+    }
+    for(const auto& cell : v.final.ram){
+        mem[cell.first] = 0;
+    }
+    return why.empty();
+}
+
+/******************************************************************************
+ *  runvectors()
+ *
+ *  @desc:      Runs the vector file of every selected opcode in parallel
+ *  @param:     dir - Directory holding "xx.json" per opcode
+ *              opcodes - Opcodes to run
+ *              threads - Worker count
+ *  @return:    true if every vector passed
+ *****************************************************************************/
+static bool runvectors(const std::string& dir, const std::vector<int>& opcodes, unsigned threads){
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> passed{0}, failed{0};
+    std::mutex outlock;
+
+    auto worker = [&](){
+        mem_6502 mem;
+        cpu_6502 cpu;
+        std::vector<vector_6502> vectors;
+        std::string why;
+        for(size_t i; (i = next++) < opcodes.size();){
+            char name[8];
+            snprintf(name, sizeof(name), "%02x.json", opcodes[i]);
+            vectors.clear();
+            if(!readvectors(dir + "/" + name, vectors)){
+                std::lock_guard<std::mutex> guard(outlock);
+                printf("%02X  missing or malformed %s\n", opcodes[i], name);
+                failed++;
+                continue;
+            }
+            uint64_t bad = 0;
+            std::string first;
+            for(const vector_6502& v : vectors){
+                if(!runvector(cpu, mem, v, why)){
+                    if(bad++ == 0){
+                        first = "\"" + v.name + "\": " + why;
+                    }
+                }
+            }
+            passed += vectors.size() - bad;
+            failed += bad;
+            if(bad > 0){
+                std::lock_guard<std::mutex> guard(outlock);
+                printf("%02X  %llu/%zu failed, first %s\n", opcodes[i],
+                       (unsigned long long)bad, vectors.size(), first.c_str());
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned t = 0; t < threads; t++){
+        pool.emplace_back(worker);
+    }
+    for(std::thread& t : pool){
+        t.join();
+    }
+    printf("single step: %llu passed, %llu failed\n",
+           (unsigned long long)passed.load(), (unsigned long long)failed.load());
+    return failed == 0;
+}
+
+/******************************************************************************
+ *  runrom()
+ *
+ *  @desc:      Runs a test ROM until it traps in a jump or branch to itself
+ *  @param:     path - Image loaded at $0000
+ *              start - Start address
+ *              trap - Receives the address it trapped at
+ *  @return:    Cycles executed, or 0 if it never trapped
+ *****************************************************************************/
+static uint64_t runrom(const char* path, word start, mem_6502& mem, word& trap){
+    cpu_6502 cpu;
+    cpu.reset(mem);
+    if(!mem.loadfile(path, 0x0000)){
+        exit(EXIT_FAILURE);
+    }
+    regs_6502 regs = cpu.getregs();
+    regs.PC = start;
+    cpu.setregs(regs);
+
+    word last;
+    do {
+        last = cpu.getregs().PC;
+        cpu.execute(1, mem);
+        if(cpu.getclock() > ROM_CYCLE_LIMIT){
+            return 0;
+        }
+    } while(cpu.getregs().PC != last);
+    trap = last;
+    return cpu.getclock();
+}
+
+/******************************************************************************
+ *  writeprogram()
+ *
+ *  @desc:      Writes PROGRAM as a binary image for PROGRAM_ADDR
+ *  @param:     path - Image file
+ *  @return:    true if it was written
+ *****************************************************************************/
+static bool writeprogram(const char* path){
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr){
+        fprintf(stderr, "ERROR: Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    bool ok = fwrite(PROGRAM, 1, sizeof(PROGRAM), file) == sizeof(PROGRAM);
+    return fclose(file) == 0 && ok;
+}
+
+/******************************************************************************
+ *  statediffers()
+ *
+ *  @desc:      Compares two machines that ran the same code
+ *  @param:     cpua, mema - First machine
+ *              cpub, memb - Second machine
+ *  @return:    What differs, or nullptr if they agree
+ *****************************************************************************/
+static const char* statediffers(const cpu_6502& cpua, const mem_6502& mema,
+                                const cpu_6502& cpub, const mem_6502& memb){
+    regs_6502 a = cpua.getregs(), b = cpub.getregs();
+    if(a.PC != b.PC || a.SP != b.SP || a.A != b.A || a.X != b.X || a.Y != b.Y || a.P != b.P){
+        return "registers differ";
+    }
+    if(cpua.getclock() != cpub.getclock() || cpua.getretired() != cpub.getretired()){
+        return "clock or retired count differs";
+    }
+    if(cpua.getstop() != cpub.getstop()){
+        return "stop reason differs";
+    }
+    if(memcmp(mema.getdata(), memb.getdata(), 0x10000) != 0){
+        return "memory differs";
+    }
+    return nullptr;
+}
+
+#ifdef AOT_TEST_6502
+/******************************************************************************
+ *  loadprogram()
+ *
+ *  @desc:      Resets a machine and starts PROGRAM on it
+ *  @param:     cpu, mem - Machine
+ *  @return:    None
+ *****************************************************************************/
+static void loadprogram(cpu_6502& cpu, mem_6502& mem){
+    cpu.reset(mem);
+    for(size_t i = 0; i < sizeof(PROGRAM); i++){
+        mem[PROGRAM_ADDR + i] = PROGRAM[i];
+    }
+    regs_6502 regs = cpu.getregs();
+    regs.PC = PROGRAM_ADDR;
+    cpu.setregs(regs);
+}
+
+/******************************************************************************
+ *  runaot()
+ *
+ *  @desc:      Runs PROGRAM interpreted and translated side by side and
+ *              compares them after every slice. A third of the way in the
+ *              code page is rewritten with the same bytes, which must not
+ *              keep the translation from running; two thirds in CPX #16
+ *              becomes CPX #12, which must send its block to the
+ *              interpreter. The translated side is published to metrics
+ *              after every slice, and the exported translation counters
+ *              must match the runtime's at the end.
+ *  @param:     cycles - Cycles to run
+ *              metrics - Counters of the translated side
+ *  @return:    true if both sides agreed throughout
+ *****************************************************************************/
+static bool runaot(uint64_t cycles, metrics_6502& metrics){
+    static mem_6502 mema, memb;
+    cpu_6502 cpua, cpub;
+    loadprogram(cpua, mema);
+    loadprogram(cpub, memb);
+    aot_6502 rt(cpub, memb, aot_program);
+
+    const word cpx = PROGRAM_ADDR + 0x25;   // operand of CPX #16
+    uint64_t rewritten = 0;
+    const char* why = nullptr;
+    while(why == nullptr && cpua.getclock() < cycles){
+        if(cpua.getclock() >= cycles / 3 && rewritten == 0){
+            memb.write(cpx, memb[cpx]);
+            rewritten = rt.gettranslated();
+        }
+        if(cpua.getclock() >= cycles / 3 * 2 && memb[cpx] == 0x10){
+            mema.write(cpx, 0x0C);
+            memb.write(cpx, 0x0C);
+        }
+        cpua.execute(AOT_SLICE, mema);
+        rt.execute(AOT_SLICE);
+        metrics.publish(cpub, memb);
+        metrics.publish(rt);
+        why = statediffers(cpua, mema, cpub, memb);
+    }
+    if(why == nullptr){
+        char line[128];
+        snprintf(line, sizeof(line), "\nemu6502_aot_translated_instructions_total %llu\n",
+                 (unsigned long long)rt.gettranslated());
+        std::string text = metrics.format();
+        if(text.find(line) == std::string::npos){
+            why = "metrics do not report the translated instructions";
+        }
+        snprintf(line, sizeof(line), "\nemu6502_aot_interpreted_instructions_total %llu\n",
+                 (unsigned long long)rt.getinterpreted());
+        if(why == nullptr && text.find(line) == std::string::npos){
+            why = "metrics do not report the interpreted instructions";
+        }
+    }
+#if !defined(CYCLE_EXACT_6502) && !defined(SHADOW_STACK_6502)
+    // cycle exact and shadow stack builds only interpret, with no translation
+    // to check
+    if(why == nullptr && (rewritten == 0 || rt.gettranslated() == rewritten)){
+        why = "translation stopped running after an unchanged rewrite";
+    } else if(why == nullptr && rt.getstale() == 0){
+        why = "changed block still ran translated";
+    } else if(why == nullptr && memb.getdirty(PROGRAM_ADDR)){
+        why = "code page left dirty once checked";
+    }
+#endif
+    bool ok = why == nullptr;
+    printf("aot: %s%s after %llu cycles, %llu translated, %llu interpreted, %llu stale\n",
+           ok ? "passed" : "FAILED, ", ok ? "" : why, (unsigned long long)cpua.getclock(),
+           (unsigned long long)rt.gettranslated(), (unsigned long long)rt.getinterpreted(),
+           (unsigned long long)rt.getstale());
+    return ok;
+}
+
+/******************************************************************************
+ *  runaotwatch()
+ *
+ *  @desc:      Runs PROGRAM interpreted and translated side by side under a
+ *              write watchpoint on the sieve flags, which must stop both
+ *              right after the same instruction every time, then without
+ *              it, when translation must take over again
+ *  @param:     stops - Watchpoint stops to compare
+ *  @return:    true if both sides agreed throughout
+ *****************************************************************************/
+static bool runaotwatch(uint32_t stops){
+    static mem_6502 mema, memb;
+    cpu_6502 cpua, cpub;
+    loadprogram(cpua, mema);
+    loadprogram(cpub, memb);
+    aot_6502 rt(cpub, memb, aot_program);
+    int wa = mema.addwatch(0x0200, 0x02FF, mem_6502::WATCH_WRITE);
+    int wb = memb.addwatch(0x0200, 0x02FF, mem_6502::WATCH_WRITE);
+
+    const char* why = nullptr;
+    uint32_t seen = 0;
+    while(why == nullptr && seen < stops && cpua.getclock() < ROM_CYCLE_LIMIT){
+        cpua.execute(AOT_SLICE, mema);
+        rt.execute(AOT_SLICE);
+        why = statediffers(cpua, mema, cpub, memb);
+        if(why == nullptr && cpua.getstop() == cpu_6502::STOP_WATCH){
+            if(mema.lastwatch().addr != memb.lastwatch().addr){
+                why = "watchpoint hit reported at different addresses";
+            }
+            seen++;
+        }
+    }
+
+    mema.delwatch(wa);
+    memb.delwatch(wb);
+    uint64_t before = rt.gettranslated();
+    for(int i = 0; why == nullptr && i < 100; i++){
+        cpua.execute(AOT_SLICE, mema);
+        rt.execute(AOT_SLICE);
+        why = statediffers(cpua, mema, cpub, memb);
+    }
+#if !defined(CYCLE_EXACT_6502) && !defined(SHADOW_STACK_6502)
+    if(why == nullptr && rt.gettranslated() == before){
+        why = "translation did not resume once the watchpoint was removed";
+    }
+#else
+    (void)before;
+#endif
+    bool ok = why == nullptr;
+    printf("aot watch: %s%s after %u stops\n", ok ? "passed" : "FAILED, ", ok ? "" : why, seen);
+    return ok;
+}
+#endif
+
+/******************************************************************************
+ *  struct rig_6502
+ *
+ *  @desc:      Machine stepped to exact cycles for the device tests. Each
+ *              step runs a NOP at IDLE_ADDR, or LDA zp when 3 cycles are
+ *              left, so any cycle at least 2 ahead can be reached.
+ *****************************************************************************/
+struct rig_6502 {
+    mem_6502 mem;
+    cpu_6502 cpu;
+    sched_6502 events;
+
+    // Resets the machine with IRQs masked, the vector at HANDLER_ADDR and
+    // PC at IDLE_ADDR.
+    rig_6502(){
+        cpu.reset(mem);
+        cpu.attach(&events);
+        mem[cpu_6502::IRQ_VECTOR] = HANDLER_ADDR & 0xFF;
+        mem[cpu_6502::IRQ_VECTOR + 1] = HANDLER_ADDR >> 8;
+        mem[HANDLER_ADDR] = NOP;
+        regs_6502 regs = cpu.getregs();
+        regs.PC = IDLE_ADDR;
+        regs.P |= cpu_6502::FLAG_I;
+        cpu.setregs(regs);
+    }
+
+    // Steps to cycle when and fires the events due there, as the next
+    // instruction boundary would. false if when is 1 cycle ahead or past.
+    bool at(uint64_t when){
+        while(cpu.getclock() < when){
+            uint64_t left = when - cpu.getclock();
+            if(left == 1){
+                return false;
+            }
+            regs_6502 regs = cpu.getregs();
+            regs.PC = IDLE_ADDR;
+            cpu.setregs(regs);
+            mem[IDLE_ADDR] = left == 3 ? LDA_ZP : NOP;
+            cpu.execute(1, mem);
+        }
+        events.run(cpu.getclock());
+        return cpu.getclock() == when;
+    }
+};
+
+/******************************************************************************
+ *  viacheck()
+ *
+ *  @desc:      Reports a VIA value that differs from the expected one
+ *  @param:     what - Value checked
+ *              k - Cycles since the timer started
+ *              got, want - Value read and expected
+ *  @return:    true if they match
+ *****************************************************************************/
+static bool viacheck(const char* what, uint64_t k, unsigned got, unsigned want){
+    if(got != want){
+        printf("via: FAILED, %s at b+%llu is %04X, expected %04X\n",
+               what, (unsigned long long)k, got, want);
+    }
+    return got == want;
+}
+
+/******************************************************************************
+ *  viaload()
+ *
+ *  @desc:      Sets ACR and loads a timer through its high byte
+ *  @param:     via - VIA on a fresh rig
+ *              reg - REG_T1CL or REG_T2CL
+ *              acr - Auxiliary control register
+ *              n - Count
+ *  @return:    Cycle b the timer starts counting on
+ *****************************************************************************/
+static uint64_t viaload(via_6522& via, const rig_6502& rig, byte reg, byte acr, word n){
+    via.writereg(via_6522::REG_ACR, acr);
+    via.writereg(reg, n & 0xFF);
+    via.writereg(reg + 1, n >> 8);
+    return rig.cpu.getclock() + 1;
+}
+
+/******************************************************************************
+ *  viacounter()
+ *
+ *  @desc:      Reads a timer as the CPU would, high byte first
+ *  @param:     reg - REG_T1CL or REG_T2CL
+ *  @return:    Counter value; reading the low byte clears the flag
+ *****************************************************************************/
+static word viacounter(via_6522& via, byte reg){
+    byte hi = via.readreg(reg + 1);
+    return (word)((hi << 8) | via.readreg(reg));
+}
+
+/******************************************************************************
+ *  runvia()
+ *
+ *  @desc:      Loads the VIA timers on fresh machines and checks counter
+ *              reads, IFR and the IRQ against the cycles via_6522.cpp
+ *              documents: loaded with N on cycle b a counter reads N - k on
+ *              b + k and FFFF on b + N + 1, when its flag sets, and T1
+ *              reloads from the latch on b + N + 2, underflowing every
+ *              latch + 2 cycles after that
+ *  @return:    true if every check passed
+ *****************************************************************************/
+static bool runvia(){
+    const uint64_t n = 0x20;
+    const uint64_t period = n + 2;
+    uint32_t checks = 0;
+    bool ok = true;
+    auto check = [&](const char* what, uint64_t k, unsigned got, unsigned want){
+        checks++;
+        ok &= viacheck(what, k, got, want);
+    };
+    // every cycle stepped to is at least 2 ahead, which at() can reach
+    auto reach = [&](rig_6502& rig, uint64_t b, uint64_t k){
+        check("clock", k, (unsigned)(rig.at(b + k) ? k : rig.cpu.getclock() - b), (unsigned)k);
+    };
+
+    // counts of both timers around their underflow, and when the flag sets
+    const uint64_t ks[] = {1, 2, 3, n - 1, n, n + 1, n + 2, n + 3};
+    for(uint64_t k : ks){
+        for(byte reg : {via_6522::REG_T1CL, via_6522::REG_T2CL}){
+            std::unique_ptr<rig_6502> rig(new rig_6502());
+            via_6522 via(rig->cpu, rig->events, rig->mem, VIA_BASE, 1);
+            uint64_t b = viaload(via, *rig, reg, 0x00, (word)n);
+            reach(*rig, b, k);
+            byte flag = reg == via_6522::REG_T1CL ? via_6522::IRQ_T1 : via_6522::IRQ_T2;
+            bool t1 = reg == via_6522::REG_T1CL;
+            check(t1 ? "T1 flag" : "T2 flag", k, via.readreg(via_6522::REG_IFR) & flag,
+                  k >= n + 1 ? flag : 0);
+            word want = k <= n ? (word)(n - k) : k == n + 1 ? 0xFFFF
+                      : t1 ? (word)(n - (k - n - 2)) : (word)(n - k);
+            check(t1 ? "T1" : "T2", k, viacounter(via, reg), want);
+        }
+    }
+
+    // one-shot T1 and T2 interrupt once; free running T1 every period
+    for(byte acr : {(byte)0x00, (byte)0x40}){
+        for(byte reg : {via_6522::REG_T1CL, via_6522::REG_T2CL}){
+            if(acr != 0 && reg == via_6522::REG_T2CL){
+                continue;
+            }
+            std::unique_ptr<rig_6502> rig(new rig_6502());
+            via_6522 via(rig->cpu, rig->events, rig->mem, VIA_BASE, 1);
+            uint64_t b = viaload(via, *rig, reg, acr, (word)n);
+            byte flag = reg == via_6522::REG_T1CL ? via_6522::IRQ_T1 : via_6522::IRQ_T2;
+            const char* what = reg == via_6522::REG_T2CL ? "T2 flag" : acr ? "free running T1 flag"
+                             : "one-shot T1 flag";
+            reach(*rig, b, n + 1);
+            viacounter(via, reg);
+            reach(*rig, b, n + period - 1);
+            check(what, n + period - 1, via.readreg(via_6522::REG_IFR) & flag, 0);
+            // T2 keeps counting down and passes FFFF again 64K cycles on
+            uint64_t next = reg == via_6522::REG_T2CL ? n + 1 + 0x10000 : n + 1 + period;
+            reach(*rig, b, next);
+            check(what, next, via.readreg(via_6522::REG_IFR) & flag, acr ? flag : 0);
+        }
+    }
+
+    // the IRQ is taken at the first instruction boundary at b + N + 1
+    for(uint64_t k : {n, n + 1}){
+        std::unique_ptr<rig_6502> rig(new rig_6502());
+        via_6522 via(rig->cpu, rig->events, rig->mem, VIA_BASE, 1);
+        via.writereg(via_6522::REG_IER, via_6522::IRQ_ANY | via_6522::IRQ_T1);
+        uint64_t b = viaload(via, *rig, via_6522::REG_T1CL, 0x00, (word)n);
+        reach(*rig, b, k);
+        regs_6502 regs = rig->cpu.getregs();
+        regs.PC = IDLE_ADDR;
+        regs.P &= ~cpu_6502::FLAG_I;
+        rig->cpu.setregs(regs);
+        rig->mem[IDLE_ADDR] = NOP;
+        rig->cpu.execute(1, rig->mem);
+        check("PC after the next instruction", k, rig->cpu.getregs().PC,
+              k == n ? IDLE_ADDR + 1 : HANDLER_ADDR);
+    }
+
+    // switching a spent one-shot T1 to free running schedules its next
+    // underflow after the switch, not at one already past
+    {
+        std::unique_ptr<rig_6502> rig(new rig_6502());
+        via_6522 via(rig->cpu, rig->events, rig->mem, VIA_BASE, 1);
+        uint64_t b = viaload(via, *rig, via_6522::REG_T1CL, 0x00, (word)n);
+        reach(*rig, b, n + 1);
+        viacounter(via, via_6522::REG_T1CL);
+        uint64_t sw = n + 1 + 2 * period + 5;
+        reach(*rig, b, sw);
+        via.writereg(via_6522::REG_ACR, 0x40);
+        uint64_t next = n + 1 + 3 * period;
+        reach(*rig, b, next - 2);
+        check("T1 flag after switching to free running", next - 2,
+              via.readreg(via_6522::REG_IFR) & via_6522::IRQ_T1, 0);
+        reach(*rig, b, next);
+        check("T1 flag after switching to free running", next,
+              via.readreg(via_6522::REG_IFR) & via_6522::IRQ_T1, via_6522::IRQ_T1);
+        check("T1 after switching to free running", next, viacounter(via, via_6522::REG_T1CL), 0xFFFF);
+    }
+
+    if(ok){
+        printf("via: passed %u checks\n", checks);
+    }
+    return ok;
+}
+
+/******************************************************************************
+ *  irqon() / nmion() / nmioff()
+ *
+ *  @desc:      Scheduled events driving the interrupt lines of a cpu_6502
+ *****************************************************************************/
+static void irqon(void* ctx, uint64_t when, uint64_t now){
+    (void)when;
+    (void)now;
+    static_cast<cpu_6502*>(ctx)->setirq(1, true);
+}
+
+static void nmion(void* ctx, uint64_t when, uint64_t now){
+    (void)when;
+    (void)now;
+    static_cast<cpu_6502*>(ctx)->setnmi(true);
+}
+
+static void nmioff(void* ctx, uint64_t when, uint64_t now){
+    (void)when;
+    (void)now;
+    static_cast<cpu_6502*>(ctx)->setnmi(false);
+}
+
+/*
+ *  struct stackdev_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Device over the stack page asserting NMI on the first push,
+ *              in the middle of an interrupt entry
+ */
+struct stackdev_6502 {
+    rig_6502* rig;
+    bool armed;
+};
+
+static byte stackread(void* ctx, word addr){
+    return static_cast<stackdev_6502*>(ctx)->rig->mem[addr];
+}
+
+static void stackwrite(void* ctx, word addr, byte val){
+    stackdev_6502* dev = static_cast<stackdev_6502*>(ctx);
+    dev->rig->mem[addr] = val;
+    if(dev->armed){
+        dev->rig->cpu.setnmi(true);
+        dev->armed = false;
+    }
+}
+
+/******************************************************************************
+ *  runto()
+ *
+ *  @desc:      Runs single instructions until PC reaches addr
+ *  @param:     rig - Machine
+ *              addr - Address to stop at
+ *              limit - Clock to give up at
+ *  @return:    true if PC reached addr
+ *****************************************************************************/
+static bool runto(rig_6502& rig, word addr, uint64_t limit){
+    while(rig.cpu.getregs().PC != addr && rig.cpu.getclock() < limit){
+        rig.cpu.execute(1, rig.mem);
+    }
+    return rig.cpu.getregs().PC == addr;
+}
+
+/******************************************************************************
+ *  runinterrupts()
+ *
+ *  @desc:      Raises IRQ and NMI through scheduled events at chosen cycles
+ *              and checks each entry: the clock when the handler starts,
+ *              7 cycles after the instruction boundary it was taken on,
+ *              and the PC and P pushed. Covers the one instruction delay
+ *              after CLI, SEI and PLP, NMI being taken once per edge and
+ *              an NMI during a BRK or IRQ entry taking its vector.
+ *  @return:    true if every check passed
+ *****************************************************************************/
+static bool runinterrupts(){
+    uint32_t checks = 0;
+    bool ok = true;
+    const char* test = nullptr;
+    auto check = [&](const char* what, unsigned got, unsigned want){
+        checks++;
+        if(got != want){
+            printf("interrupts: FAILED, %s: %s is %04X, expected %04X\n", test, what, got, want);
+            ok = false;
+        }
+    };
+    // a fresh machine running code at CODE_ADDR with I as given
+    auto start = [](std::initializer_list<byte> code, bool masked){
+        std::unique_ptr<rig_6502> rig(new rig_6502());
+        word addr = CODE_ADDR;
+        for(byte op : code){
+            rig->mem[addr++] = op;
+        }
+        for(word i = 0; i < 0x20; i++){
+            rig->mem[CODE_ADDR + (word)code.size() + i] = NOP;
+            rig->mem[NMI_ADDR + i] = NOP;
+        }
+        rig->mem[cpu_6502::NMI_VECTOR] = NMI_ADDR & 0xFF;
+        rig->mem[cpu_6502::NMI_VECTOR + 1] = NMI_ADDR >> 8;
+        regs_6502 regs = rig->cpu.getregs();
+        regs.PC = CODE_ADDR;
+        regs.P = masked ? regs.P | cpu_6502::FLAG_I : regs.P & ~cpu_6502::FLAG_I;
+        rig->cpu.setregs(regs);
+        return rig;
+    };
+    // an entry to handler done at clock, with pc and the B and I bits of p
+    // pushed, and I set
+    auto entered = [&](rig_6502& rig, byte sp, word handler, uint64_t clock, word pc, byte p){
+        check("handler reached", runto(rig, handler, clock + 16), 1);
+        check("clock", (unsigned)rig.cpu.getclock(), (unsigned)clock);
+        regs_6502 regs = rig.cpu.getregs();
+        check("SP", regs.SP, (byte)(sp - 3));
+        check("stacked PC", rig.mem[0x0100 | sp] << 8 | rig.mem[0x0100 | (byte)(sp - 1)], pc);
+        check("stacked B and I", rig.mem[0x0100 | (byte)(sp - 2)] & (cpu_6502::FLAG_B | cpu_6502::FLAG_I),
+              p & (cpu_6502::FLAG_B | cpu_6502::FLAG_I));
+        check("I", regs.P & cpu_6502::FLAG_I, cpu_6502::FLAG_I);
+    };
+    const byte B = cpu_6502::FLAG_B, I = cpu_6502::FLAG_I;
+
+    // an IRQ raised during the fifth NOP is taken at the boundary after it
+    test = "IRQ at cycle 9";
+    {
+        auto rig = start({}, false);
+        rig->events.schedule(9, irqon, &rig->cpu);
+        entered(*rig, 0xFF, HANDLER_ADDR, 10 + 7, CODE_ADDR + 5, 0);
+    }
+
+    // CLI and PLP unmask one instruction late, SEI masks one late
+    test = "CLI";
+    {
+        auto rig = start({CLI}, true);
+        rig->events.schedule(0, irqon, &rig->cpu);
+        entered(*rig, 0xFF, HANDLER_ADDR, 2 + 2 + 7, CODE_ADDR + 2, 0);
+    }
+    test = "SEI";
+    {
+        auto rig = start({SEI}, false);
+        rig->events.schedule(1, irqon, &rig->cpu);
+        entered(*rig, 0xFF, HANDLER_ADDR, 2 + 7, CODE_ADDR + 1, I);
+    }
+    test = "PLP";
+    {
+        auto rig = start({PLP}, true);
+        regs_6502 regs = rig->cpu.getregs();
+        regs.SP = 0xFE;
+        rig->cpu.setregs(regs);
+        rig->mem[0x01FF] = cpu_6502::FLAG_U;
+        rig->events.schedule(0, irqon, &rig->cpu);
+        entered(*rig, 0xFF, HANDLER_ADDR, 4 + 2 + 7, CODE_ADDR + 2, 0);
+    }
+
+    // NMI ignores I and is taken once per falling edge
+    test = "NMI edge";
+    {
+        auto rig = start({}, true);
+        rig->events.schedule(3, nmion, &rig->cpu);
+        rig->events.schedule(20, nmioff, &rig->cpu);
+        rig->events.schedule(25, nmion, &rig->cpu);
+        entered(*rig, 0xFF, NMI_ADDR, 4 + 7, CODE_ADDR + 2, I);
+        while(rig->cpu.getclock() < 24){
+            rig->cpu.execute(1, rig->mem);
+        }
+        check("SP while NMI stays asserted", rig->cpu.getregs().SP, 0xFC);
+        entered(*rig, 0xFC, NMI_ADDR, 25 + 7, NMI_ADDR + 7, I);
+    }
+
+    // an NMI arriving while BRK or an IRQ pushes takes over the vector
+    test = "BRK hijacked by NMI";
+    {
+        auto rig = start({BRK, 0x00}, false);
+        stackdev_6502 dev = {rig.get(), true};
+        rig->mem.mapio(0x0100, 0x01FF, stackread, stackwrite, &dev);
+        entered(*rig, 0xFF, NMI_ADDR, 7, CODE_ADDR + 2, B);
+        rig->cpu.execute(1, rig->mem);
+        check("PC after the hijacked entry", rig->cpu.getregs().PC, NMI_ADDR + 1);
+    }
+    test = "IRQ hijacked by NMI";
+    {
+        auto rig = start({}, false);
+        stackdev_6502 dev = {rig.get(), true};
+        rig->mem.mapio(0x0100, 0x01FF, stackread, stackwrite, &dev);
+        rig->events.schedule(0, irqon, &rig->cpu);
+        entered(*rig, 0xFF, NMI_ADDR, 7, CODE_ADDR, 0);
+        rig->cpu.execute(1, rig->mem);
+        check("PC after the hijacked entry", rig->cpu.getregs().PC, NMI_ADDR + 1);
+    }
+
+    if(ok){
+        printf("interrupts: passed %u checks\n", checks);
+    }
+    return ok;
+}
+
+/******************************************************************************
+ *  idletick()
+ *
+ *  @desc:      Scheduled event waking the idle loop, alternately through
+ *              the flag at $10 and through an IRQ, then rescheduling
+ *              itself after a varying interval. Counts its ticks at $20.
+ *****************************************************************************/
+static void idletick(void* ctx, uint64_t when, uint64_t now){
+    (void)now;
+    rig_6502* rig = static_cast<rig_6502*>(ctx);
+    byte tick = rig->mem[0x20]++;
+    if(tick & 1){
+        rig->cpu.setirq(1, true);
+    } else {
+        rig->mem[0x10] = 1;
+    }
+    rig->events.schedule(when + 500 + 37 * (tick % 8), idletick, rig);
+}
+
+static byte ackread(void* ctx, word addr){
+    (void)ctx;
+    (void)addr;
+    return 0x00;
+}
+
+static void ackwrite(void* ctx, word addr, byte val){
+    (void)addr;
+    (void)val;
+    static_cast<cpu_6502*>(ctx)->setirq(1, false);
+}
+
+/******************************************************************************
+ *  runidleskip()
+ *
+ *  @desc:      Runs a loop waiting on events and IRQs twice, once with idle
+ *              loops skipped, and compares the machines after every slice
+ *  @return:    true if they agreed throughout
+ *****************************************************************************/
+static bool runidleskip(){
+    std::unique_ptr<rig_6502> rigs[2] = {
+        std::unique_ptr<rig_6502>(new rig_6502()),
+        std::unique_ptr<rig_6502>(new rig_6502())
+    };
+    for(int i = 0; i < 2; i++){
+        rig_6502& rig = *rigs[i];
+        for(word j = 0; j < sizeof(IDLE_PROGRAM); j++){
+            rig.mem[CODE_ADDR + j] = IDLE_PROGRAM[j];
+        }
+        for(word j = 0; j < sizeof(IDLE_HANDLER); j++){
+            rig.mem[HANDLER_ADDR + j] = IDLE_HANDLER[j];
+        }
+        rig.mem.mapio(ACK_ADDR, ACK_ADDR, ackread, ackwrite, &rig.cpu);
+        regs_6502 regs = rig.cpu.getregs();
+        regs.PC = CODE_ADDR;
+        rig.cpu.setregs(regs);
+        rig.cpu.setidleskip(i == 1);
+        rig.events.schedule(700, idletick, &rig);
+    }
+
+    cpu_6502& plain = rigs[0]->cpu;
+    cpu_6502& skip = rigs[1]->cpu;
+    while(plain.getclock() < IDLE_CYCLES){
+        plain.execute(IDLE_SLICE, rigs[0]->mem);
+        skip.execute(IDLE_SLICE, rigs[1]->mem);
+        const char* why = statediffers(plain, rigs[0]->mem, skip, rigs[1]->mem);
+        if(why != nullptr){
+            printf("idleskip: FAILED at clock %llu: %s\n",
+                   (unsigned long long)plain.getclock(), why);
+            return false;
+        }
+    }
+    if(rigs[0]->mem[0x11] == 0 || rigs[0]->mem[0x20] < 2){
+        printf("idleskip: FAILED, the loop never woke up\n");
+        return false;
+    }
+#ifndef CYCLE_EXACT_6502
+    // cycle exact builds run every iteration either way
+    if(skip.getskipped() == 0){
+        printf("idleskip: FAILED, no cycles were skipped\n");
+        return false;
+    }
+#endif
+    printf("idleskip: passed, %llu of %llu cycles skipped\n",
+           (unsigned long long)skip.getskipped(), (unsigned long long)skip.getclock());
+    return true;
+}
+
+/******************************************************************************
+ *  usage()
+ *****************************************************************************/
+static void usage(const char* prog){
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --functional IMAGE    Klaus Dormann's 6502_functional_test.bin\n"
+            "  --success ADDR        its success trap (hex, default 3469)\n"
+            "  --decimal IMAGE       Bruce Clark's decimal test, assembled for $0200\n"
+            "  --error ADDR          its ERROR byte (hex, default 000B)\n"
+            "  --vectors DIR         single step vectors, one xx.json per opcode\n"
+            "  --opcodes LIST        comma separated hex opcodes to run (default all)\n"
+            "  --threads N           worker threads (default all cores)\n"
+            "  --program PATH        write the built-in test program, for $0400\n"
+            "  --via                 check the VIA timers cycle by cycle\n"
+            "  --interrupts          check IRQ and NMI entry sequences\n"
+            "  --idleskip            check idle skipping against a plain run\n"
+#ifdef AOT_TEST_6502
+            "  --aot CYCLES          run it translated against the interpreter\n"
+            "  --metrics SPEC        serve its metrics over HTTP, as 6502 does\n"
+            "  --metrics-file PATH   rewrite PATH with its metrics every second\n"
+#endif
+            ,prog);
+}
+
+/******************************************************************************
+ *  main()
+ *
+ *  @desc:      Runs the requested conformance tests
+ *  @return:    EXIT_SUCCESS if all of them pass
+ *****************************************************************************/
+int main(int argc, char** argv){
+    const char* functional = nullptr;
+    const char* decimal = nullptr;
+    const char* vectors = nullptr;
+    const char* program = nullptr;
+    uint64_t aotcycles = 0;
+    const char* metricsspec = nullptr;
+    const char* metricsfile = nullptr;
+    bool via = false;
+    bool interrupts = false;
+    bool idleskip = false;
+    word success = 0x3469;
+    word erroraddr = 0x000B;
+    std::vector<int> opcodes;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        bool hasval = i + 1 < argc;
+        if(arg == "--functional" && hasval){
+            functional = argv[++i];
+        } else if(arg == "--success" && hasval){
+            success = (word)strtoul(argv[++i], nullptr, 16);
+        } else if(arg == "--decimal" && hasval){
+            decimal = argv[++i];
+        } else if(arg == "--error" && hasval){
+            erroraddr = (word)strtoul(argv[++i], nullptr, 16);
+        } else if(arg == "--vectors" && hasval){
+            vectors = argv[++i];
+        } else if(arg == "--opcodes" && hasval){
+            for(char* tok = strtok(argv[++i], ","); tok; tok = strtok(nullptr, ",")){
+                opcodes.push_back((int)strtoul(tok, nullptr, 16) & 0xFF);
+            }
+        } else if(arg == "--threads" && hasval){
+            threads = (unsigned)atoi(argv[++i]);
+        } else if(arg == "--program" && hasval){
+            program = argv[++i];
+        } else if(arg == "--via"){
+            via = true;
+        } else if(arg == "--interrupts"){
+            interrupts = true;
+        } else if(arg == "--idleskip"){
+            idleskip = true;
+#ifdef AOT_TEST_6502
+        } else if(arg == "--aot" && hasval){
+            aotcycles = strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--metrics" && hasval){
+            metricsspec = argv[++i];
+        } else if(arg == "--metrics-file" && hasval){
+            metricsfile = argv[++i];
+#endif
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(functional == nullptr && decimal == nullptr && vectors == nullptr && program == nullptr
+            && aotcycles == 0 && !via && !interrupts && !idleskip){
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(threads == 0){
+        threads = 1;
+    }
+
+    bool ok = true;
+    static mem_6502 mem;
+
+    if(program != nullptr){
+        ok &= writeprogram(program);
+    }
+
+    if(via){
+        ok &= runvia();
+    }
+
+    if(interrupts){
+        ok &= runinterrupts();
+    }
+
+    if(idleskip){
+        ok &= runidleskip();
+    }
+
+#ifdef AOT_TEST_6502
+    if(aotcycles > 0){
+        metrics_6502 metrics;
+        if((metricsspec != nullptr || metricsfile != nullptr)
+                && !metrics.open(metricsspec, metricsfile)){
+            return EXIT_FAILURE;
+        }
+        ok &= runaot(aotcycles, metrics);
+        ok &= runaotwatch(1000);
+    }
+#endif
+
+    if(functional != nullptr){
+        word trap = 0;
+        uint64_t cycles = runrom(functional, 0x0400, mem, trap);
+        bool pass = cycles > 0 && trap == success;
+        printf("functional: %s, trapped at $%04X after %llu cycles\n",
+               pass ? "passed" : "FAILED", trap, (unsigned long long)cycles);
+        ok &= pass;
+    }
+
+    if(decimal != nullptr){
+        word trap = 0;
+        uint64_t cycles = runrom(decimal, 0x0200, mem, trap);
+        bool pass = cycles > 0 && mem[erroraddr] == 0;
+        printf("decimal: %s, trapped at $%04X after %llu cycles, ERROR=%02X\n",
+               pass ? "passed" : "FAILED", trap, (unsigned long long)cycles, mem[erroraddr]);
+        ok &= pass;
+    }
+
+    if(vectors != nullptr){
+        if(opcodes.empty()){
+            for(int op = 0; op < 0x100; op++){
+                opcodes.push_back(op);
+            }
+        }
+        ok &= runvectors(vectors, opcodes, threads);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
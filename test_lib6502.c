@@ -0,0 +1,150 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       test_lib6502.c
+ * @desc:       Test of the C interface, linked against lib6502.a
+ * @note:       Runs the image written by test_6502 --program, then a
+ *              small program poked into memory that calls a host call,
+ *              writes and reads a mapped device and stops on a watchpoint
+ *              and a JAM opcode.
+ *****************************************************************************/
+
+#include "lib6502.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// cycles the sieve in the test program needs to count its primes
+#define SIEVE_CYCLES 200000
+
+// primes below 256, stored to $11 by the test program
+#define SIEVE_PRIMES 54
+
+// entry of the subroutine replaced by doubletrap(); a JAM if it ever runs
+#define DOUBLE_ADDR 0x0300
+
+// device mapped over $D000-$D001
+#define DEVICE_ADDR 0xD000
+#define DEVICE_READ 0x5A
+
+static int failures = 0;
+
+/*
+ *  struct device_6502
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Last access seen by the test device
+ */
+typedef struct device_6502 {
+    uint16_t addr;
+    uint8_t val;
+    int writes;
+} device_6502;
+
+// Prints and counts a failed expectation.
+static void check(int ok, const char* what){
+    if(!ok){
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static uint8_t deviceread(void* ctx, uint16_t addr){
+    (void)ctx;
+    return addr == DEVICE_ADDR + 1 ? DEVICE_READ : 0x00;
+}
+
+static void devicewrite(void* ctx, uint16_t addr, uint8_t val){
+    device_6502* dev = (device_6502*)ctx;
+    dev->addr = addr;
+    dev->val = val;
+    dev->writes++;
+}
+
+// Host call doubling A in place of the subroutine at DOUBLE_ADDR.
+static int doubletrap(void* ctx, lib6502_regs* regs, lib6502_machine* m){
+    (*(int*)ctx)++;
+    (void)m;
+    regs->a = (uint8_t)(regs->a << 1);
+    return 1;
+}
+
+// Points PC at addr.
+static void jump(lib6502_machine* m, uint16_t addr){
+    lib6502_regs regs;
+    lib6502_getregs(m, &regs);
+    regs.pc = addr;
+    lib6502_setregs(m, &regs);
+}
+
+/******************************************************************************
+ *  main()
+ *
+ *  @desc:      Runs the checks
+ *  @param:     argv[1] - Image written by test_6502 --program
+ *  @return:    EXIT_SUCCESS if all of them pass
+ *****************************************************************************/
+int main(int argc, char** argv){
+    if(argc != 2){
+        fprintf(stderr, "usage: %s PROGRAM\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    check(lib6502_abi() == LIB6502_ABI, "lib6502_abi() matches the header");
+    lib6502_machine* m = lib6502_create();
+    if(m == NULL){
+        printf("FAILED: lib6502_create()\n");
+        return EXIT_FAILURE;
+    }
+
+    // a whole image through load and run
+    check(lib6502_load(m, argv[1], 0x0400) == 1, "lib6502_load() reads the program");
+    jump(m, 0x0400);
+    check(lib6502_run(m, SIEVE_CYCLES) == LIB6502_STOP_NONE, "the program runs without stopping");
+    check(lib6502_clock(m) >= SIEVE_CYCLES, "lib6502_run() runs the cycles asked for");
+    check(lib6502_retired(m) > 0, "instructions are counted");
+    check(lib6502_peek(m, 0x11) == SIEVE_PRIMES, "the program counts the primes below 256");
+
+    // a host call and a device, poked in after a reset clears memory
+    static const uint8_t CALLER[] = {
+        0xA9, 0x15,             // 0200  LDA #$15
+        0x20, 0x00, 0x03,       // 0202  JSR $0300      doubled by the host
+        0x8D, 0x00, 0xD0,       // 0205  STA $D000
+        0xAD, 0x01, 0xD0,       // 0208  LDA $D001
+        0x85, 0x10,             // 020B  STA $10        watched
+        0x4C, 0x0D, 0x02,       // 020D  JMP $020D
+    };
+    device_6502 dev = {0, 0, 0};
+    int calls = 0;
+    lib6502_reset(m);
+    lib6502_writeblock(m, 0x0200, CALLER, sizeof(CALLER));
+    lib6502_poke(m, DOUBLE_ADDR, 0x02);
+    lib6502_setjam(m, LIB6502_JAM_TRAP);
+    check(lib6502_mapio(m, DEVICE_ADDR, DEVICE_ADDR + 1, deviceread, devicewrite, &dev) >= 0,
+          "lib6502_mapio() maps the device");
+    check(lib6502_addtrap(m, DOUBLE_ADDR, doubletrap, &calls, 12) == 1,
+          "lib6502_addtrap() installs the host call");
+    int watch = lib6502_addwatch(m, 0x10, 0x10, LIB6502_WATCH_WRITE);
+    check(watch >= 0, "lib6502_addwatch() adds the watchpoint");
+
+    jump(m, 0x0200);
+    check(lib6502_run(m, 1000) == LIB6502_STOP_WATCH, "the write to $10 stops the run");
+    check(calls == 1, "the host call runs once");
+    check(dev.writes == 1 && dev.addr == DEVICE_ADDR && dev.val == 0x2A,
+          "the device sees the doubled value");
+    check(lib6502_peek(m, 0x10) == DEVICE_READ, "the device read lands in memory");
+    check(lib6502_delwatch(m, watch) == 1, "lib6502_delwatch() removes the watchpoint");
+
+    // without the host call the JAM behind it is reached
+    check(lib6502_deltrap(m, DOUBLE_ADDR) == 1, "lib6502_deltrap() removes the host call");
+    jump(m, 0x0200);
+    check(lib6502_run(m, 1000) == LIB6502_STOP_JAM, "the JAM opcode stops the run");
+    lib6502_regs regs;
+    lib6502_getregs(m, &regs);
+    check(regs.pc == DOUBLE_ADDR, "the run stops on the JAM opcode");
+
+    lib6502_destroy(m);
+    printf("lib6502: %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
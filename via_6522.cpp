@@ -0,0 +1,367 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       via_6522.cpp
+ * @desc:       Source file for the 6522 Versatile Interface Adapter
+ * @note:       A counter loaded with N on cycle b reads N - k on cycle b + k,
+ *              reads FFFF on b + N + 1, which is when the interrupt flag
+ *              sets, and T1 takes the latch again on b + N + 2.
+ *****************************************************************************/
+
+#include "via_6522.h"
+
+// Class Constructors & Destructors ----------------------------------------
+
+// Creates a VIA mapped at base..base+15 of memory, timed by events and
+// driving the lines bits of the cpu IRQ line.
+via_6522::via_6522(cpu_6502& cpu, sched_6502& events, mem_6502& memory, word base, uint32_t lines)
+        : cpu(cpu), events(events), mem(memory){
+    irqline = lines;
+    t1latch = t1load = 0;
+    t1base = 0;
+    t1event = 0;
+    t2latch = 0;
+    t2load = 0;
+    t2base = 0;
+    t2event = 0;
+    sr = 0;
+    inputa = inputb = 0xFF;
+    ca1 = cb1 = true;
+    portin = nullptr;
+    portout = nullptr;
+    portctx = nullptr;
+    reset();
+    mapping = mem.mapio(base, base + 0x0F, ioread, iowrite, this);
+}
+
+// Unmaps the VIA, cancels its events and releases its IRQ line.
+via_6522::~via_6522(){
+    mem.unmapio(mapping);
+    if(t1event != 0){
+        events.cancel(t1event);
+    }
+    if(t2event != 0){
+        events.cancel(t2event);
+    }
+    cpu.setirq(irqline, false);
+}
+
+
+// Manipulation procedures -------------------------------------------------
+/*
+ *  reset()
+ *
+ *  @desc:      Clears the port, control and interrupt registers as the RES
+ *              pin does. The counters and latches keep their values but no
+ *              longer interrupt.
+ *  @param:     None
+ *  @return:    None
+ * */
+void via_6522::reset(){
+    orb = ora = ddrb = ddra = 0;
+    acr = pcr = 0;
+    ifr = ier = 0;
+    t1running = t1armed = t2armed = false;
+    if(t1event != 0){
+        events.cancel(t1event);
+        t1event = 0;
+    }
+    if(t2event != 0){
+        events.cancel(t2event);
+        t2event = 0;
+    }
+    cpu.setirq(irqline, false);
+}
+
+/*
+ *  writereg()
+ *
+ *  @desc:      Writes a register as the CPU does
+ *  @param:     reg - REG_* register number
+ *              val - Value written
+ *  @return:    None
+ * */
+void via_6522::writereg(byte reg, byte val){
+    uint64_t now = cpu.getclock();
+    switch(reg & 0x0F){
+        case REG_ORB:
+            orb = val;
+            clearflags(IRQ_CB1 | IRQ_CB2);
+            if(portout != nullptr){
+                portout(portctx, PORT_B, orb, ddrb);
+            }
+            break;
+        case REG_ORA:
+        case REG_ORA_NH:
+            ora = val;
+            if((reg & 0x0F) == REG_ORA){
+                clearflags(IRQ_CA1 | IRQ_CA2);
+            }
+            if(portout != nullptr){
+                portout(portctx, PORT_A, ora, ddra);
+            }
+            break;
+        case REG_DDRB:
+            ddrb = val;
+            if(portout != nullptr){
+                portout(portctx, PORT_B, orb, ddrb);
+            }
+            break;
+        case REG_DDRA:
+            ddra = val;
+            if(portout != nullptr){
+                portout(portctx, PORT_A, ora, ddra);
+            }
+            break;
+
+        case REG_T1CL:
+        case REG_T1LL:
+            t1latch = (t1latch & 0xFF00) | val;
+            break;
+        case REG_T1CH:
+            // loads the counter from the latch and starts T1
+            t1latch = (word)((val << 8) | (t1latch & 0xFF));
+            t1load = t1latch;
+            t1base = now + 1;
+            t1running = t1armed = true;
+            clearflags(IRQ_T1);
+            t1schedule(now);
+            break;
+        case REG_T1LH:
+            t1latch = (word)((val << 8) | (t1latch & 0xFF));
+            clearflags(IRQ_T1);
+            break;
+
+        case REG_T2CL:
+            t2latch = val;
+            break;
+        case REG_T2CH:
+            t2load = (word)((val << 8) | t2latch);
+            t2base = now + 1;
+            t2armed = true;
+            clearflags(IRQ_T2);
+            if(t2event != 0){
+                events.cancel(t2event);
+            }
+            t2event = events.schedule(t2base + t2load + 1, t2expired, this);
+            break;
+
+        case REG_SR:
+            sr = val;
+            break;
+        case REG_ACR:
+            acr = val;
+            t1schedule(now);
+            break;
+        case REG_PCR:
+            pcr = val;
+            break;
+        case REG_IFR:
+            clearflags(val & 0x7F);
+            break;
+        case REG_IER:
+            ier = val & IRQ_ANY ? ier | (val & 0x7F) : ier & ~val;
+            clearflags(0);
+            break;
+    }
+}
+
+/*
+ *  setports()
+ *
+ *  @desc:      Installs the host port callbacks
+ *  @param:     in - Pin level callback, or nullptr
+ *              out - Output change callback, or nullptr
+ *              ctx - Passed through to the callbacks
+ *  @return:    None
+ * */
+void via_6522::setports(portin_6522 in, portout_6522 out, void* ctx){
+    portin = in;
+    portout = out;
+    portctx = ctx;
+}
+
+/*
+ *  setinput()
+ *
+ *  @desc:      Sets the pin levels read when no input callback is set
+ *  @param:     port - PORT_A or PORT_B
+ *              val - Pin levels
+ *  @return:    None
+ * */
+void via_6522::setinput(byte port, byte val){
+    if(port == PORT_A){
+        inputa = val;
+    } else {
+        inputb = val;
+    }
+}
+
+/*
+ *  setca1() / setcb1()
+ *
+ *  @desc:      Drives the CA1 or CB1 control input
+ *  @param:     level - New input level
+ *  @return:    None
+ * */
+void via_6522::setca1(bool level){
+    if(level != ca1 && level == ((pcr & PCR_CA1_RISE) != 0)){
+        setflags(IRQ_CA1);
+    }
+    ca1 = level;
+}
+
+void via_6522::setcb1(bool level){
+    if(level != cb1 && level == ((pcr & PCR_CB1_RISE) != 0)){
+        setflags(IRQ_CB1);
+    }
+    cb1 = level;
+}
+
+
+// Access functions --------------------------------------------------------
+/*
+ *  readreg()
+ *
+ *  @desc:      Reads a register as the CPU does, with its side effects
+ *  @param:     reg - REG_* register number
+ *  @return:    Register value
+ * */
+byte via_6522::readreg(byte reg){
+    uint64_t now = cpu.getclock();
+    switch(reg & 0x0F){
+        case REG_ORB:
+            clearflags(IRQ_CB1 | IRQ_CB2);
+            return readport(PORT_B);
+        case REG_ORA:
+            clearflags(IRQ_CA1 | IRQ_CA2);
+            return readport(PORT_A);
+        case REG_ORA_NH:
+            return readport(PORT_A);
+        case REG_DDRB:
+            return ddrb;
+        case REG_DDRA:
+            return ddra;
+        case REG_T1CL:
+            clearflags(IRQ_T1);
+            return t1counter(now) & 0xFF;
+        case REG_T1CH:
+            return t1counter(now) >> 8;
+        case REG_T1LL:
+            return t1latch & 0xFF;
+        case REG_T1LH:
+            return t1latch >> 8;
+        case REG_T2CL:
+            clearflags(IRQ_T2);
+            return t2counter(now) & 0xFF;
+        case REG_T2CH:
+            return t2counter(now) >> 8;
+        case REG_SR:
+            return sr;
+        case REG_ACR:
+            return acr;
+        case REG_PCR:
+            return pcr;
+        case REG_IFR:
+            return ifr | ((ifr & ier) ? IRQ_ANY : 0);
+        default:    // REG_IER
+            return ier | IRQ_ANY;
+    }
+}
+
+
+// Private helpers ---------------------------------------------------------
+byte via_6522::ioread(void* ctx, word addr){
+    return static_cast<via_6522*>(ctx)->readreg(addr & 0x0F);
+}
+
+void via_6522::iowrite(void* ctx, word addr, byte val){
+    static_cast<via_6522*>(ctx)->writereg(addr & 0x0F, val);
+}
+
+void via_6522::t1expired(void* ctx, uint64_t when, uint64_t now){
+    via_6522* via = static_cast<via_6522*>(ctx);
+    (void)now;
+    via->t1event = 0;
+    if((via->acr & ACR_T1_FREE) || via->t1armed){
+        via->setflags(IRQ_T1);
+    }
+    via->t1armed = false;
+    via->t1base = when + 1;
+    via->t1load = via->t1latch;
+    via->t1schedule(when);
+}
+
+void via_6522::t2expired(void* ctx, uint64_t when, uint64_t now){
+    via_6522* via = static_cast<via_6522*>(ctx);
+    (void)when;
+    (void)now;
+    via->t2event = 0;
+    if(via->t2armed){
+        via->setflags(IRQ_T2);
+        via->t2armed = false;
+    }
+}
+
+word via_6522::t1counter(uint64_t now) const{
+    if(now < t1base){
+        // the cycle before the base is the underflow, which reads FFFF
+        // while the latch is reloaded, or the write loading the counter,
+        // where the CPU cannot read
+        return now + 1 == t1base ? 0xFFFF : t1load;
+    }
+    uint64_t k = now - t1base;
+    if(k <= t1load){
+        return (word)(t1load - k);
+    }
+    if(k == (uint64_t)t1load + 1){
+        return 0xFFFF;
+    }
+    // later periods count down from the latch
+    k = (k - t1load - 2) % ((uint64_t)t1latch + 2);
+    return k <= t1latch ? (word)(t1latch - k) : 0xFFFF;
+}
+
+word via_6522::t2counter(uint64_t now) const{
+    if(now < t2base){
+        return t2load;
+    }
+    return (word)(t2load - (now - t2base));
+}
+
+void via_6522::t1schedule(uint64_t now){
+    if(t1event != 0){
+        events.cancel(t1event);
+        t1event = 0;
+    }
+    if(!t1running || (!(acr & ACR_T1_FREE) && !t1armed)){
+        return;
+    }
+    uint64_t next = t1base + t1load + 1;
+    if(next <= now){
+        uint64_t period = (uint64_t)t1latch + 2;
+        next += ((now - next) / period + 1) * period;
+    }
+    t1event = events.schedule(next, t1expired, this);
+}
+
+void via_6522::setflags(byte bits){
+    ifr |= bits & 0x7F;
+    cpu.setirq(irqline, (ifr & ier) != 0);
+}
+
+void via_6522::clearflags(byte bits){
+    ifr &= ~bits;
+    cpu.setirq(irqline, (ifr & ier) != 0);
+}
+
+byte via_6522::readport(byte port){
+    byte out = port == PORT_A ? ora : orb;
+    byte ddr = port == PORT_A ? ddra : ddrb;
+    byte pins = portin != nullptr ? portin(portctx, port)
+              : port == PORT_A ? inputa : inputb;
+    return (out & ddr) | (pins & ~ddr);
+}
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * @author:     Rian Borah
+ * @date:       19 Oct, 2026
+ ******************************************************************************/
+
+/******************************************************************************
+ * @file:       via_6522.h
+ * @desc:       Header file for the 6522 Versatile Interface Adapter
+ * @ref:        http://archive.6502.org/datasheets/mos_6522_preliminary_nov_1977.pdf
+ * @note:       The timers are never ticked. Their counters are computed from
+ *              the cycle they were loaded on when read, and expiries are
+ *              events in the scheduler, so an idle VIA costs nothing.
+ *              Not modelled: the shift register (SR only stores a byte),
+ *              T2 pulse counting, PB7 output, input latching and the CA2/CB2
+ *              handshake modes.
+ *****************************************************************************/
+
+#ifndef INC_6502_VIA_6522_H
+#define INC_6502_VIA_6522_H
+
+#include "6502.h"
+#include "cpu_6502.h"
+#include "mem_6502.h"
+#include "sched_6502.h"
+
+/*
+ *  portin_6522 / portout_6522
+ *
+ *  @date:      19 Oct, 2026
+ *  @desc:      Host side of the I/O ports
+ *  @param:     ctx - Pointer given to setports()
+ *              port - via_6522::PORT_A or PORT_B
+ *              val - Output register
+ *              ddr - Data direction register, 1 bits are outputs
+ *  @return:    portin_6522 returns the levels of the port pins
+ */
+typedef byte (*portin_6522)(void* ctx, byte port);
+typedef void (*portout_6522)(void* ctx, byte port, byte val, byte ddr);
+
+class via_6522 {
+public:
+    static constexpr byte
+            PORT_A = 0,
+            PORT_B = 1;
+
+    // registers, offsets from the base address
+    static constexpr byte
+            REG_ORB  = 0x0,
+            REG_ORA  = 0x1,
+            REG_DDRB = 0x2,
+            REG_DDRA = 0x3,
+            REG_T1CL = 0x4,
+            REG_T1CH = 0x5,
+            REG_T1LL = 0x6,
+            REG_T1LH = 0x7,
+            REG_T2CL = 0x8,
+            REG_T2CH = 0x9,
+            REG_SR   = 0xA,
+            REG_ACR  = 0xB,
+            REG_PCR  = 0xC,
+            REG_IFR  = 0xD,
+            REG_IER  = 0xE,
+            REG_ORA_NH = 0xF;   // port A without handshake
+
+    // IFR and IER bits
+    static constexpr byte
+            IRQ_CA2 = 0x01,
+            IRQ_CA1 = 0x02,
+            IRQ_SR  = 0x04,
+            IRQ_CB2 = 0x08,
+            IRQ_CB1 = 0x10,
+            IRQ_T2  = 0x20,
+            IRQ_T1  = 0x40,
+            IRQ_ANY = 0x80;
+
+private:
+    static constexpr byte ACR_T1_FREE = 0x40;   // T1 continuous interrupts
+    static constexpr byte PCR_CA1_RISE = 0x01;  // CA1 active on a rising edge
+    static constexpr byte PCR_CB1_RISE = 0x10;
+
+    // Device Fields
+    cpu_6502& cpu;
+    sched_6502& events;
+    mem_6502& mem;
+    int mapping;            // mapio() id
+    uint32_t irqline;       // bit of the cpu IRQ line this VIA drives
+
+    byte orb, ora, ddrb, ddra;
+    byte sr, acr, pcr, ifr, ier;
+    byte inputa, inputb;    // pin levels when no input callback is set
+    bool ca1, cb1;
+
+    // T1 holds t1load on cycle t1base and counts down from there
+    word t1latch, t1load;
+    uint64_t t1base;
+    bool t1running;         // started by a T1C-H write since reset
+    bool t1armed;           // one-shot interrupt not yet delivered
+    uint32_t t1event;       // scheduler id, 0 if none
+
+    // T2 only has a latch for its low byte and never reloads
+    byte t2latch;
+    word t2load;
+    uint64_t t2base;
+    bool t2armed;
+    uint32_t t2event;
+
+    portin_6522 portin;
+    portout_6522 portout;
+    void* portctx;
+
+    // mem_6502 and sched_6502 callbacks
+    static byte ioread(void* ctx, word addr);
+    static void iowrite(void* ctx, word addr, byte val);
+    static void t1expired(void* ctx, uint64_t when, uint64_t now);
+    static void t2expired(void* ctx, uint64_t when, uint64_t now);
+
+    /*
+     *  t1counter() / t2counter()
+     *
+     *  @desc:      Computes the counter value at a cycle
+     * */
+    word t1counter(uint64_t now) const;
+    word t2counter(uint64_t now) const;
+
+    /*
+     *  t1schedule()
+     *
+     *  @desc:      Replaces the T1 event with one at the next underflow
+     *              after now that should raise an interrupt, if any
+     * */
+    void t1schedule(uint64_t now);
+
+    /*
+     *  setflags() / clearflags()
+     *
+     *  @desc:      Changes IFR bits and updates the IRQ output
+     * */
+    void setflags(byte bits);
+    void clearflags(byte bits);
+
+    /*
+     *  readport()
+     *
+     *  @desc:      Returns output bits from the output register and input
+     *              bits from the pins
+     * */
+    byte readport(byte port);
+
+public:
+    // Class Constructors & Destructors ----------------------------------------
+
+    // Creates a VIA mapped at base..base+15 of memory, timed by events and
+    // driving the lines bits of the cpu IRQ line.
+    via_6522(cpu_6502& cpu, sched_6502& events, mem_6502& memory, word base, uint32_t lines);
+
+    // Unmaps the VIA, cancels its events and releases its IRQ line.
+    ~via_6522();
+
+    via_6522(const via_6522&) = delete;
+    via_6522& operator=(const via_6522&) = delete;
+
+    // Manipulation procedures -------------------------------------------------
+    /*
+     *  reset()
+     *
+     *  @desc:      Clears the port, control and interrupt registers as the
+     *              RES pin does; the timers stop interrupting until loaded
+     *  @param:     None
+     *  @return:    None
+     * */
+    void reset();
+
+    /*
+     *  writereg()
+     *
+     *  @desc:      Writes a register as the CPU does
+     *  @param:     reg - REG_* register number
+     *              val - Value written
+     *  @return:    None
+     * */
+    void writereg(byte reg, byte val);
+
+    /*
+     *  setports()
+     *
+     *  @desc:      Installs the host port callbacks
+     *  @param:     in - Called for pin levels on port reads, nullptr to use
+     *                   setinput() levels
+     *              out - Called when an output or direction register
+     *                    changes, may be nullptr
+     *              ctx - Passed through to the callbacks
+     *  @return:    None
+     * */
+    void setports(portin_6522 in, portout_6522 out, void* ctx);
+
+    /*
+     *  setinput()
+     *
+     *  @desc:      Sets the pin levels read when no input callback is set
+     *  @param:     port - PORT_A or PORT_B
+     *              val - Pin levels
+     *  @return:    None
+     * */
+    void setinput(byte port, byte val);
+
+    /*
+     *  setca1() / setcb1()
+     *
+     *  @desc:      Drives the CA1 or CB1 control input, flagging an
+     *              interrupt on the edge selected by PCR
+     *  @param:     level - New input level
+     *  @return:    None
+     * */
+    void setca1(bool level);
+    void setcb1(bool level);
+
+    // Access functions --------------------------------------------------------
+    /*
+     *  readreg()
+     *
+     *  @desc:      Reads a register as the CPU does, with its side effects
+     *  @param:     reg - REG_* register number
+     *  @return:    Register value
+     * */
+    byte readreg(byte reg);
+};
+
+#endif //INC_6502_VIA_6522_H